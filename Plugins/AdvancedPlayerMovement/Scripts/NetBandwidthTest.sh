@@ -0,0 +1,66 @@
+#!/usr/bin/env bash
+# Runs a dedicated server and several headless clients on loopback with packet lag and loss emulation, drives every client's character
+# with scripted strafe input (-AdvancedMovementScriptedInput), and reports the move bandwidth from the movement component's network summaries.
+#
+# Upstream is the packed server move rpcs each client sends, downstream is the move responses the server sends (and how much of that is corrections).
+# Packet emulation needs a development build (it's compiled out of shipping).
+#
+# Usage: UE_EDITOR=/Path/To/UnrealEditor ./NetBandwidthTest.sh [Clients] [Seconds]
+# Environment: PROJECT (defaults to the AdvancedMovement.uproject next to the plugin), MAP, PORT, PKT_LAG (ms, per direction), PKT_LOSS (percent),
+#	SUMMARY_INTERVAL (seconds), OUTPUT_DIR
+
+set -euo pipefail
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+CLIENTS="${1:-4}"
+DURATION="${2:-60}"
+UE_EDITOR="${UE_EDITOR:?Set UE_EDITOR to the UnrealEditor binary}"
+PROJECT="${PROJECT:-$(cd "$SCRIPT_DIR/../../.." && pwd)/AdvancedMovement.uproject}"
+MAP="${MAP:-/Game/ThirdPerson/Maps/Demo}"
+PORT="${PORT:-7777}"
+PKT_LAG="${PKT_LAG:-50}"
+PKT_LOSS="${PKT_LOSS:-1}"
+SUMMARY_INTERVAL="${SUMMARY_INTERVAL:-5}"
+OUTPUT_DIR="${OUTPUT_DIR:-$(dirname "$PROJECT")/Saved/Profiling/AdvancedMovement/NetBandwidth-$(date +%Y%m%d-%H%M%S)}"
+
+mkdir -p "$OUTPUT_DIR"
+PIDS=()
+cleanup() { kill "${PIDS[@]}" 2>/dev/null || true; wait 2>/dev/null || true; }
+trap cleanup EXIT
+
+COMMON_ARGS=(-nullrhi -nosound -unattended -nosplash -log "-PktLag=$PKT_LAG" "-PktLoss=$PKT_LOSS" "-ExecCmds=AdvancedMovement.NetStatsLogInterval $SUMMARY_INTERVAL")
+
+echo "Starting the server on port $PORT ($PKT_LAG ms lag, $PKT_LOSS% loss each way)"
+"$UE_EDITOR" "$PROJECT" "$MAP" -server "-port=$PORT" "${COMMON_ARGS[@]}" "-abslog=$OUTPUT_DIR/Server.log" > /dev/null 2>&1 &
+PIDS+=($!)
+sleep 10
+
+for ((Client = 0; Client < CLIENTS; Client++)); do
+	"$UE_EDITOR" "$PROJECT" "127.0.0.1:$PORT" -game -AdvancedMovementScriptedInput "${COMMON_ARGS[@]}" "-abslog=$OUTPUT_DIR/Client$Client.log" > /dev/null 2>&1 &
+	PIDS+=($!)
+done
+
+echo "Running $CLIENTS clients for ${DURATION}s"
+sleep "$DURATION"
+cleanup
+trap - EXIT
+
+
+# Averages a "<value> bytes/s" field over every network summary in a log, the field is found by the text around the value
+average() {
+	grep "network summary over" "$1" | sed -n "s/.*$2 *\([0-9.e+-]*\) bytes\/s$3.*/\1/p" | awk '{ Total += $1; Count++ } END { printf "%.1f", Count ? Total / Count : 0 }'
+}
+
+echo
+echo "Client upstream (bytes/s)"
+for ((Client = 0; Client < CLIENTS; Client++)); do
+	Log="$OUTPUT_DIR/Client$Client.log"
+	printf "  Client%d: %s total, %s move data, %s custom move data\n" "$Client" \
+		"$(average "$Log" " upstream" "")" "$(average "$Log" "(" " move data")" "$(average "$Log" "," " custom move data")"
+done
+
+# The server logs a summary for each client's character, which covers that client's downstream bandwidth
+Downstream="$(average "$OUTPUT_DIR/Server.log" " downstream" "")"
+Corrections="$(average "$OUTPUT_DIR/Server.log" "(" " corrections")"
+echo "Server downstream per client (bytes/s): $Downstream total, $Corrections corrections"
+echo "Logs: $OUTPUT_DIR"
@@ -20,6 +20,9 @@ public class AdvancedPlayerMovement : ModuleRules
 				"DataRegistry"
 			}
 			);
-		
+
+		// The movement component's debug logging and drawing (and the AdvancedMovement.Debug cvar) are compiled out of shipping and dedicated server builds
+		bool bMovementDebug = Target.Configuration != UnrealTargetConfiguration.Shipping && Target.Type != TargetType.Server;
+		PublicDefinitions.Add("ADVANCED_MOVEMENT_DEBUG=" + (bMovementDebug ? "1" : "0"));
 	}
 }
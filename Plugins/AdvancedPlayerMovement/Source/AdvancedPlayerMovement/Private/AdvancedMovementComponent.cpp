@@ -4,13 +4,176 @@
 #include "AdvancedMovementComponent.h"
 #include "GameFramework/Character.h"
 #include "Components/CapsuleComponent.h"
+#include "Components/ChildActorComponent.h"
 #include "Kismet/KismetSystemLibrary.h"
 #include "Kismet/KismetMathLibrary.h"
+#include "KismetTraceUtils.h"
 #include "Logging/StructuredLog.h"
+#include "HAL/IConsoleManager.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+#include "UObject/UObjectIterator.h"
+#include "Misc/Paths.h"
+#include "Serialization/BitWriter.h"
+#include "Engine/World.h"
+#include "Engine/OverlapResult.h"
+#include "Curves/CurveFloat.h"
+#include "Profiling/AdvancedMovementProfiling.h"
+#include "Core/AdvancedMovementMath.h"
 
 
 DEFINE_LOG_CATEGORY(Movement);
 
+DECLARE_CYCLE_STAT(TEXT("PhysWalking"), STAT_AdvancedMovement_PhysWalking, STATGROUP_AdvancedMovement);
+DECLARE_CYCLE_STAT(TEXT("PhysSlide"), STAT_AdvancedMovement_PhysSlide, STATGROUP_AdvancedMovement);
+DECLARE_CYCLE_STAT(TEXT("PhysCustom"), STAT_AdvancedMovement_PhysCustom, STATGROUP_AdvancedMovement);
+DECLARE_CYCLE_STAT(TEXT("PhysFalling"), STAT_AdvancedMovement_PhysFalling, STATGROUP_AdvancedMovement);
+DECLARE_CYCLE_STAT(TEXT("PhysWallClimbing"), STAT_AdvancedMovement_PhysWallClimbing, STATGROUP_AdvancedMovement);
+DECLARE_CYCLE_STAT(TEXT("PhysMantling"), STAT_AdvancedMovement_PhysMantling, STATGROUP_AdvancedMovement);
+DECLARE_CYCLE_STAT(TEXT("PhysLedgeClimbing"), STAT_AdvancedMovement_PhysLedgeClimbing, STATGROUP_AdvancedMovement);
+DECLARE_CYCLE_STAT(TEXT("PhysWallRunning"), STAT_AdvancedMovement_PhysWallRunning, STATGROUP_AdvancedMovement);
+DECLARE_CYCLE_STAT(TEXT("CalcVelocity"), STAT_AdvancedMovement_CalcVelocity, STATGROUP_AdvancedMovement);
+DECLARE_CYCLE_STAT(TEXT("CheckIfSafeToMantleLedge"), STAT_AdvancedMovement_CheckIfSafeToMantleLedge, STATGROUP_AdvancedMovement);
+DECLARE_CYCLE_STAT(TEXT("WallJumpValid"), STAT_AdvancedMovement_WallJumpValid, STATGROUP_AdvancedMovement);
+DECLARE_CYCLE_STAT(TEXT("CalculateWallJumpTrajectory"), STAT_AdvancedMovement_CalculateWallJumpTrajectory, STATGROUP_AdvancedMovement);
+DECLARE_CYCLE_STAT(TEXT("Crouch"), STAT_AdvancedMovement_Crouch, STATGROUP_AdvancedMovement);
+DECLARE_CYCLE_STAT(TEXT("UnCrouch"), STAT_AdvancedMovement_UnCrouch, STATGROUP_AdvancedMovement);
+DECLARE_CYCLE_STAT(TEXT("Serialize Move Data"), STAT_AdvancedMovement_SerializeMoveData, STATGROUP_AdvancedMovement);
+DECLARE_CYCLE_STAT(TEXT("Replay Saved Moves"), STAT_AdvancedMovement_ReplaySavedMoves, STATGROUP_AdvancedMovement);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Server Corrections"), STAT_AdvancedMovement_ServerCorrections, STATGROUP_AdvancedMovement);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Client Corrections"), STAT_AdvancedMovement_ClientCorrections, STATGROUP_AdvancedMovement);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Replayed Moves"), STAT_AdvancedMovement_ReplayedMoves, STATGROUP_AdvancedMovement);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Custom Move Data Bits"), STAT_AdvancedMovement_CustomMoveDataBits, STATGROUP_AdvancedMovement);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Server Move Bits"), STAT_AdvancedMovement_ServerMoveBits, STATGROUP_AdvancedMovement);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Move Response Bits"), STAT_AdvancedMovement_MoveResponseBits, STATGROUP_AdvancedMovement);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Correction Bits"), STAT_AdvancedMovement_CorrectionBits, STATGROUP_AdvancedMovement);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Mantle Probes Used"), STAT_AdvancedMovement_MantleProbesUsed, STATGROUP_AdvancedMovement);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Baked Ledges Used"), STAT_AdvancedMovement_BakedLedgesUsed, STATGROUP_AdvancedMovement);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Wall Run Contact Updates"), STAT_AdvancedMovement_WallRunContactUpdates, STATGROUP_AdvancedMovement);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Wall Jump Probes Used"), STAT_AdvancedMovement_WallJumpProbesUsed, STATGROUP_AdvancedMovement);
+DECLARE_DWORD_COUNTER_STAT(TEXT("UnCrouch Clearance Cache Hits"), STAT_AdvancedMovement_UnCrouchClearanceCacheHits, STATGROUP_AdvancedMovement);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Wall Climb Floor Checks Skipped"), STAT_AdvancedMovement_WallClimbFloorChecksSkipped, STATGROUP_AdvancedMovement);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Floors Reused"), STAT_AdvancedMovement_FloorsReused, STATGROUP_AdvancedMovement);
+
+namespace AdvancedMovementCVars
+{
+	static float NetStatsLogInterval = 0.f;
+	FAutoConsoleVariableRef CVarNetStatsLogInterval(
+		TEXT("AdvancedMovement.NetStatsLogInterval"),
+		NetStatsLogInterval,
+		TEXT("How often (in seconds) every advanced movement component logs a summary of its corrections, replayed moves, and move bandwidth. 0 disables the summary"),
+		ECVF_Default
+	);
+
+	static float TraceDumpOnCorrection = 0.f;
+	FAutoConsoleVariableRef CVarTraceDumpOnCorrection(
+		TEXT("AdvancedMovement.TraceDumpOnCorrection"),
+		TraceDumpOnCorrection,
+		TEXT("Saves the movement trace of a traced component when it's corrected, at most once every this many seconds. 0 only saves traces on demand"),
+		ECVF_Default
+	);
+}
+
+#if ADVANCED_MOVEMENT_DEBUG
+namespace AdvancedMovementCVars
+{
+	static int32 DebugMode = 1;
+	FAutoConsoleVariableRef CVarDebugMode(
+		TEXT("AdvancedMovement.Debug"),
+		DebugMode,
+		TEXT("The advanced movement debug logging and drawing. 0 disables all of it, 1 uses each component's debug settings, and 2 enables all of it"),
+		ECVF_Cheat
+	);
+}
+
+/** Whether a component's debug setting is enabled, this is always false in builds without ADVANCED_MOVEMENT_DEBUG (shipping and dedicated servers) so their debug branches are compiled out */
+#define ADVANCED_MOVEMENT_DEBUG_ENABLED(bSetting) (AdvancedMovementCVars::DebugMode == 2 || (AdvancedMovementCVars::DebugMode == 1 && (bSetting)))
+#else
+#define ADVANCED_MOVEMENT_DEBUG_ENABLED(bSetting) (false)
+#endif
+
+CSV_DEFINE_CATEGORY(AdvancedMovementQueries, true);
+
+static FAutoConsoleCommandWithWorld StartRecordingCommand(
+	TEXT("AdvancedMovement.StartRecording"),
+	TEXT("Starts recording the inputs of every locally controlled advanced movement component in the world"),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		for (TObjectIterator<UAdvancedMovementComponent> It; It; ++It)
+		{
+			if (It->GetWorld() != World || It->IsTemplate() || !It->GetCharacterOwner() || !It->GetCharacterOwner()->IsLocallyControlled()) continue;
+			It->StartInputRecording();
+		}
+	})
+);
+
+static FAutoConsoleCommandWithWorldAndArgs StopRecordingCommand(
+	TEXT("AdvancedMovement.StopRecording"),
+	TEXT("Stops recording inputs and saves the recordings. Optionally takes the file path of the recording"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		for (TObjectIterator<UAdvancedMovementComponent> It; It; ++It)
+		{
+			if (It->GetWorld() != World || !It->IsRecordingInput()) continue;
+			It->StopInputRecording(Args.Num() ? Args[0] : FString());
+		}
+	})
+);
+
+static FAutoConsoleCommandWithWorldAndArgs StartTraceCommand(
+	TEXT("AdvancedMovement.StartTrace"),
+	TEXT("Starts tracing the physics substeps of every advanced movement component in the world. Optionally takes the amount of substeps the trace holds"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		const int32 Capacity = Args.Num() ? FCString::Atoi(*Args[0]) : 4096;
+		for (TObjectIterator<UAdvancedMovementComponent> It; It; ++It)
+		{
+			if (It->GetWorld() != World || It->IsTemplate() || !It->GetCharacterOwner()) continue;
+			It->StartMovementTrace(Capacity);
+		}
+	})
+);
+
+static FAutoConsoleCommandWithWorld StopTraceCommand(
+	TEXT("AdvancedMovement.StopTrace"),
+	TEXT("Stops tracing the physics substeps of every advanced movement component in the world"),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		for (TObjectIterator<UAdvancedMovementComponent> It; It; ++It)
+		{
+			if (It->GetWorld() != World || !It->IsTracingMovement()) continue;
+			It->StopMovementTrace();
+		}
+	})
+);
+
+static FAutoConsoleCommandWithWorld DumpTraceCommand(
+	TEXT("AdvancedMovement.DumpTrace"),
+	TEXT("Saves the movement trace of every traced advanced movement component in the world to Saved/Profiling/AdvancedMovement/Traces"),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		for (TObjectIterator<UAdvancedMovementComponent> It; It; ++It)
+		{
+			if (It->GetWorld() != World || !It->IsTracingMovement()) continue;
+			It->DumpMovementTrace(FString(), TEXT("Console"));
+		}
+	})
+);
+
+static FAutoConsoleCommandWithWorldAndArgs DumpSceneQueriesCommand(
+	TEXT("AdvancedMovement.DumpSceneQueries"),
+	TEXT("Logs the scene queries of every advanced movement component in the world, broken down by movement mode and movement feature. Add 'reset' to clear the stats afterwards"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		const bool bReset = Args.Contains(TEXT("reset"));
+		for (TObjectIterator<UAdvancedMovementComponent> It; It; ++It)
+		{
+			if (It->GetWorld() != World || It->IsTemplate()) continue;
+			It->DumpSceneQueryStats();
+			if (bReset) It->ResetSceneQueryStats();
+		}
+	})
+);
+
 namespace CharacterMovementConstants // @ref 5.4
 {
 	// MAGIC NUMBERS
@@ -70,6 +233,7 @@ UAdvancedMovementComponent::UAdvancedMovementComponent()
 	WallJumpValidDistance = 45;
 	WallJumpHeightFromGroundThreshold = 64.0;
 	WallJumpSpacing = 50;
+	bUseWallJumpProbe = true;
 
 	// Mantle Jumping
 	bUseMantleJumping = true;
@@ -89,6 +253,7 @@ UAdvancedMovementComponent::UAdvancedMovementComponent()
 	WallClimbFriction = 2.5;
 	WallClimbGravityLimit = -45;
 	WallClimbJumpInterval = 0.1;
+	bUseWallClimbFloorGate = true;
 
 	// Mantling
 	bUseMantling = true;
@@ -104,6 +269,9 @@ UAdvancedMovementComponent::UAdvancedMovementComponent()
 	MantleObjects.Add(EObjectTypeQuery::ObjectTypeQuery1);
 	MantleObjects.Add(EObjectTypeQuery::ObjectTypeQuery2);
 	MantleObjects.Add(EObjectTypeQuery::ObjectTypeQuery5);
+	bUseAsyncMantleProbe = true;
+	BakedLedgeWallTolerance = 2;
+	LookAheadProbeTolerance = 2;
 	
 	// Ledge Climbing
 	bUseLedgeClimbing = true;
@@ -123,6 +291,8 @@ UAdvancedMovementComponent::UAdvancedMovementComponent()
 	WallRunSpeedThreshold = 600;
 	WallRunAcceptableAngleRadius = 30;
 	WallRunHeightThreshold = 300;
+	WallRunContactTolerance = 5;
+	WallRunContactAngleThreshold = 5;
 	
 	// // CharacterMovement (General Settings)
 	MaxAcceleration = 1200; // Derived from the Acceleration values 
@@ -147,6 +317,9 @@ UAdvancedMovementComponent::UAdvancedMovementComponent()
 	bSweepWhileNavWalking = true;
 	bCanWalkOffLedges = true;
 	bCanWalkOffLedgesWhenCrouching = true;
+	bUseUnCrouchClearanceCache = true;
+	UnCrouchClearanceTolerance = 1;
+	UnCrouchClearanceRefreshInterval = 0.25;
 	bMaintainHorizontalGroundVelocity = false; 
 	bIgnoreBaseRotation = false;
 	PerchRadiusThreshold = 0;
@@ -154,6 +327,8 @@ UAdvancedMovementComponent::UAdvancedMovementComponent()
 	LedgeCheckThreshold = 4;
 	bAlwaysCheckFloor = false;
 	bUseFlatBaseForFloorChecks = false;
+	bUseFloorCoherence = true;
+	FloorCoherenceMaxReuses = 4;
 	
 	// Character Movement: Jumping/Falling
 	GravityScale = 2.03;
@@ -218,9 +393,31 @@ UAdvancedMovementComponent::UAdvancedMovementComponent()
 void UAdvancedMovementComponent::InitializeComponent()
 {
 	Super::InitializeComponent();
+	BakeSpeedCurves();
+	RebuildDerivedParams();
+	RefreshMovementQueryParams();
+}
+
+
+void UAdvancedMovementComponent::UninitializeComponent()
+{
+#if WITH_EDITOR
+	UnbindSpeedCurves();
+#endif
+	Super::UninitializeComponent();
 }
 
 
+#if WITH_EDITOR
+void UAdvancedMovementComponent::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+	BakeSpeedCurves();
+	RebuildDerivedParams();
+}
+#endif
+
+
 
 
 //------------------------------------------------------------------------------//
@@ -239,6 +436,30 @@ bool UAdvancedMovementComponent::IsLedgeClimbing() const { return MovementMode =
 bool UAdvancedMovementComponent::IsAiming() const { return AimPressed; }
 bool UAdvancedMovementComponent::IsStrafeSwaying() { return AirStrafeSwayPhysics; }
 bool UAdvancedMovementComponent::IsStrafeLurching() { return AirStrafeLurchPhysics; }
+
+
+bool UAdvancedMovementComponent::GetAirStrafeState(EAdvancedMovementTraceBranch& OutBranch, AdvancedMovementMath::FAirStrafeParams& OutParams, float& OutLurchStrength, float& OutLurchFriction)
+{
+	if (!IsFalling() || !UsesBhopping() || bOrientRotationToMovement) return false;
+
+	// The same branches as CalcVelocity
+	OutLurchStrength = 0;
+	OutLurchFriction = StrafeLurchFriction;
+	if (IsStrafeSwaying())
+	{
+		OutBranch = EAdvancedMovementTraceBranch::StrafeSway;
+		OutParams = AdvancedMovementMath::FAirStrafeParams(DerivedParams.StrafeSwaySpeedCap, StrafeSwayRotationRate, AirControl);
+		return true;
+	}
+
+	OutBranch = IsStrafeLurching() ? EAdvancedMovementTraceBranch::StrafeLurch : EAdvancedMovementTraceBranch::AirStrafe;
+	OutParams = AdvancedMovementMath::FAirStrafeParams(DerivedParams.AirStrafeSpeedCap, AirStrafeRotationRate, AirControl);
+	if (IsStrafeLurching())
+	{
+		OutLurchStrength = AdvancedMovementMath::GetStrafeLurchStrength(Time, StrafeLurchStartTime, StrafeLurchDuration, StrafeLurchFullStrengthDuration, StrafeLurchStrength);
+	}
+	return true;
+}
 #pragma endregion 
 
 
@@ -250,7 +471,7 @@ bool UAdvancedMovementComponent::IsStrafeLurching() { return AirStrafeLurchPhysi
 void UAdvancedMovementComponent::OnMovementModeChanged(EMovementMode PreviousMovementMode, uint8 PreviousCustomMode)
 {
 	Super::OnMovementModeChanged(PreviousMovementMode, PreviousCustomMode);
-	if (bDebugMovementMode)
+	if (ADVANCED_MOVEMENT_DEBUG_ENABLED(bDebugMovementMode))
 	{
 		UE_LOGFMT(Movement, Warning, "{0}: Movement Mode Updated: {1}, previous movement mode: {2}",
 			*GetNameSafe(CharacterOwner),
@@ -311,15 +532,16 @@ void UAdvancedMovementComponent::UpdateCharacterStateBeforeMovement(const float
 	}
 
 	// Wall climb duration
-	ResetWallClimbInterval();
+	if (FAdvancedMovementFeatures::bWallClimbing) ResetWallClimbInterval();
+
 	
 	// Slide
-	if (!IsSliding() && CanSlide() && Velocity.Size2D() > SlideEnterThreshold && WalkingStartTime + WalkingDurationToSlide <= Time)
+	if (FAdvancedMovementFeatures::bSliding && !IsSliding() && CanSlide() && Velocity.SizeSquared2D() > DerivedParams.SlideEnterThresholdSquared && WalkingStartTime + WalkingDurationToSlide <= Time)
 	{
 		SetMovementMode(MOVE_Custom, MOVE_Custom_Slide);
 	}
 
-	if (bDebugNetworkReplication)
+	if (ADVANCED_MOVEMENT_DEBUG_ENABLED(bDebugNetworkReplication))
 	{
 		UE_LOGFMT(Movement, Log, "{0}::{1} -> Time: ({2}), PlayerInput: ({3}) Sprinting: ({4}), WallJumping: ({5})",
 			CharacterOwner->HasAuthority() ? "Server" : "Client",
@@ -338,11 +560,45 @@ void UAdvancedMovementComponent::UpdateCharacterStateAfterMovement(float DeltaSe
 	Super::UpdateCharacterStateAfterMovement(DeltaSeconds);
 }
 
+void UAdvancedMovementComponent::PerformMovement(const float DeltaTime)
+{
+	FScopedAdvancedMovementAllocationCheck AllocationCheck;
+	Super::PerformMovement(DeltaTime);
+}
+
 void UAdvancedMovementComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
 {
+	ADVANCED_MOVEMENT_PHYSICS_TIMER(Other);
+	FlushSceneQueryStats();
+	if (InputRecording) RecordInputFrame(DeltaTime);
+	
 	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
 	Time += DeltaTime;
+	IssueLookAheadProbes(DeltaTime);
+	UpdateNetworkStatsSummary();
+	
+	if (InputRecording && UpdatedComponent)
+	{
+		InputRecording->AddTrajectorySample(InputRecording->Frames.Num() - 1, UpdatedComponent->GetComponentLocation());
+	}
+}
+
+void UAdvancedMovementComponent::ComputeFloorDist(const FVector& CapsuleLocation, float LineDistance, float SweepDistance, FFindFloorResult& OutFloorResult, float SweepRadius, const FHitResult* DownwardSweepResult) const
+{
+	// A valid downward sweep from the move is used instead of sweeping again
+	if (SweepDistance > 0 && !(DownwardSweepResult && DownwardSweepResult->IsValidBlockingHit()))
+	{
+		AddSceneQuery(FloorQuerySource, EAdvancedMovementQuery::Sweep);
+	}
+	Super::ComputeFloorDist(CapsuleLocation, LineDistance, SweepDistance, OutFloorResult, SweepRadius, DownwardSweepResult);
+}
+
+bool UAdvancedMovementComponent::MoveUpdatedComponentImpl(const FVector& Delta, const FQuat& NewRotation, bool bSweep, FHitResult* OutHit, ETeleportType Teleport)
+{
+	if (bSweep && !Delta.IsNearlyZero()) AddSceneQuery(EAdvancedMovementQuerySource::Move, EAdvancedMovementQuery::Sweep);
+	return Super::MoveUpdatedComponentImpl(Delta, NewRotation, bSweep, OutHit, Teleport);
 }
+
 #pragma endregion 
 
 
@@ -353,18 +609,22 @@ void UAdvancedMovementComponent::TickComponent(float DeltaTime, ELevelTick TickT
 //------------------------------------------------------------------------------//
 void UAdvancedMovementComponent::CalcVelocity(float DeltaTime, float Friction, bool bFluid, float BrakingDeceleration)
 {
-	const float BaseSpeed = Velocity.Size2D();
+	ADVANCED_MOVEMENT_SCOPE_CYCLE_COUNTER(CalcVelocity);
+
 	FRotator MovementRotation(0, UpdatedComponent->GetComponentRotation().Yaw, 0);
 	FVector OldVelocity = Velocity;
 
 	FVector AccelDir = Acceleration.GetSafeNormal();
 	// FVector AccelDir;
+	TraceBranch = EAdvancedMovementTraceBranch::Default;
 	
 	//--------------------------------------------------------------------------------------------------------------//
 	// Sliding																										//
 	//--------------------------------------------------------------------------------------------------------------//
 	if (IsSliding())
 	{
+		TraceBranch = EAdvancedMovementTraceBranch::SlideStrafe;
+		
 		// Only Allow side strafing and prevent velocity being added during a strafe
 		Acceleration = FVector(UKismetMathLibrary::GetRightVector(MovementRotation) * PlayerInput.Y).GetSafeNormal() * Acceleration.Size2D();
 		
@@ -395,7 +655,7 @@ void UAdvancedMovementComponent::CalcVelocity(float DeltaTime, float Friction, b
 		}
 
 		
-		if (bDebugSlide)
+		if (ADVANCED_MOVEMENT_DEBUG_ENABLED(bDebugSlide))
 		{
 			float FloorAngle = CurrentFloor.HitResult.ImpactNormal.Dot(UpdatedComponent->GetForwardVector()) * SlideAngleFrictionMultiplier;
 			float FrictionCalc = FMath::Clamp(SlidingFriction - FloorAngle, 0, SlidingFriction * 3);
@@ -426,7 +686,7 @@ void UAdvancedMovementComponent::CalcVelocity(float DeltaTime, float Friction, b
 	// Third person (with orient rotation to movement) physics																				//
 	//--------------------------------------------------------------------------------------------------------------------------------------//
 	// Strafing calculations causes problems if the character's movement isn't oriented to their movement
-	if (!bUseBhopping || bOrientRotationToMovement) return Super::CalcVelocity(DeltaTime, Friction, bFluid, BrakingDeceleration);
+	if (!UsesBhopping() || bOrientRotationToMovement) return Super::CalcVelocity(DeltaTime, Friction, bFluid, BrakingDeceleration);
 	// If the player's rotation is oriented to the camera, it messes up the fp strafing calculations, and this prevents that from happening
 	
 	
@@ -440,37 +700,28 @@ void UAdvancedMovementComponent::CalcVelocity(float DeltaTime, float Friction, b
 	}
 	
 	// Air strafe values
-	float ProjVelocity;
+	float ProjVelocity; // Strafing subtracts from this value, neutral defaults to the player speed, and negative values add to speed
 	FVector AddedVelocity;
-	float AirSpeedCap; // How much speed is gained during air strafing?
-	float AirAccelerationMultiplier; // Drag is added to the equation if the accelerationMultiplier / 10 isn't the same as the player's velocity 
-	float AddSpeed;
 
-	
+
 	//------------------------------------------------------------------------------------------------------------------//
 	// AirStrafe Sway ->  Prevent Air resistance during specific movement actions (Wall jumps, ledge jumps, etc.)		//
 	//------------------------------------------------------------------------------------------------------------------//
 	if (IsStrafeSwaying())
 	{
-		// Find strafe
-		ProjVelocity = Velocity.X * AccelDir.X + Velocity.Y * AccelDir.Y; // Strafing subtracts from this value, neutral defaults to the player speed, and negative values add to speed 
-		AirSpeedCap = (GetMaxAcceleration() / 100) * StrafeSwaySpeedGainMultiplier; // Strafe sway should have more control without slowing down the character's momentum
-		AirAccelerationMultiplier = StrafeSwayRotationRate;
+		TraceBranch = EAdvancedMovementTraceBranch::StrafeSway;
 		
+		// Strafe sway should have more control without slowing down the character's momentum
+		const AdvancedMovementMath::FAirStrafeParams StrafeSway(DerivedParams.StrafeSwaySpeedCap, StrafeSwayRotationRate, AirControl);
+
 		// Update the acceleration based on the character's air control
 		Acceleration = GetFallingLateralAcceleration(DeltaTime);
 
 		// Allow Strafing, don't let the player stop the momentum from pressing an input in the opposite direction of the momentum
-		AddSpeed = Acceleration.GetClampedToMaxSize2D(AirSpeedCap).Size2D() - ProjVelocity;
-		if (AddSpeed > 0.0f)
-		{
-			AddedVelocity = Acceleration * AirAccelerationMultiplier * AirControl * DeltaTime;
-			AddedVelocity = AddedVelocity.GetClampedToMaxSize2D(AddSpeed);
+		AddedVelocity = AdvancedMovementMath::GetAirStrafeVelocity(Velocity, AccelDir, Acceleration, StrafeSway, DeltaTime, ProjVelocity);
 
-			// Don't allow the player to move against the strafe
-			const float AngleFromCurrentVelocity = Velocity.GetSafeNormal2D().Dot(AccelDir); 
-			if (AngleFromCurrentVelocity > -0.34) Velocity += AddedVelocity;
-		}
+		// Don't allow the player to move against the strafe
+		if (AdvancedMovementMath::CanStrafeSway(Velocity, AccelDir)) Velocity += AddedVelocity;
 	}
 
 	//------------------------------------------------------------------------------------------------------------------//
@@ -478,36 +729,23 @@ void UAdvancedMovementComponent::CalcVelocity(float DeltaTime, float Friction, b
 	//------------------------------------------------------------------------------------------------------------------//
 	else if (IsStrafeLurching())
 	{
-		FVector AirStrafeVelocity = OldVelocity;
-		FVector AirStrafeLurchVelocity = OldVelocity;
+		TraceBranch = EAdvancedMovementTraceBranch::StrafeLurch;
 		
 		// Update the acceleration based on the character's air control
 		Acceleration = GetFallingLateralAcceleration(DeltaTime);
-		
+
 		/**** Air Strafe calculations ****/
-		ProjVelocity = Velocity.X * AccelDir.X + Velocity.Y * AccelDir.Y; // Strafing subtracts from this value, neutral defaults to the player speed, and negative values add to speed 
-		AirSpeedCap = (GetMaxAcceleration() / 100) * AirStrafeSpeedGainMultiplier; // How much speed is gained during air strafing?
-		AirAccelerationMultiplier = AirStrafeRotationRate; // Drag is added to the equation if the accelerationMultiplier / 10 isn't the same as the player's velocity 
-		
-		// Add strafing momentum to the character's velocity 
-		AddSpeed = Acceleration.GetClampedToMaxSize2D(AirSpeedCap).Size2D() - ProjVelocity;
-		if (AddSpeed > 0.0f)
-		{
-			AddedVelocity = Acceleration * AirAccelerationMultiplier * AirControl * DeltaTime;
-			AddedVelocity = AddedVelocity.GetClampedToMaxSize2D(AddSpeed);
-			AirStrafeVelocity += AddedVelocity;
-		}
+		const AdvancedMovementMath::FAirStrafeParams AirStrafe(DerivedParams.AirStrafeSpeedCap, AirStrafeRotationRate, AirControl);
+
+		// Add strafing momentum to the character's velocity
+		AddedVelocity = AdvancedMovementMath::GetAirStrafeVelocity(Velocity, AccelDir, Acceleration, AirStrafe, DeltaTime, ProjVelocity);
+		const FVector AirStrafeVelocity = OldVelocity + AddedVelocity;
+
 
-		
 		/**** Strafe Lurch influence ****/
-		if (AccelDir.IsNearlyZero()) AirStrafeLurchVelocity = Velocity;
-		else AirStrafeLurchVelocity = AccelDir * BaseSpeed;
-		
 		// Apply friction (be careful because air strafing also creates friction)
-		FVector FrictionVector = OldVelocity - AirStrafeLurchVelocity;
-		FVector Friction = FrictionVector * (StrafeLurchFriction * 10) * DeltaTime;
-		AirStrafeLurchVelocity += Friction;
-		
+		const FVector AirStrafeLurchVelocity = AdvancedMovementMath::GetStrafeLurchVelocity(OldVelocity, AccelDir, StrafeLurchFriction, DeltaTime);
+
 		// Apply input acceleration
 		// if (!Acceleration.IsNearlyZero())
 		// {
@@ -519,17 +757,10 @@ void UAdvancedMovementComponent::CalcVelocity(float DeltaTime, float Friction, b
 		
 
 		/**** Velocity calculations ****/
-		float LurchStrength;
-		float Duration = StrafeLurchStartTime + StrafeLurchDuration - Time;
-		if (StrafeLurchStartTime + StrafeLurchFullStrengthDuration > Time) LurchStrength = 1;
-		else LurchStrength = UKismetMathLibrary::MapRangeClamped(Duration, 0, StrafeLurchDuration - StrafeLurchFullStrengthDuration, 0, 1);
-		LurchStrength = FMath::Clamp(LurchStrength * StrafeLurchStrength, 0, 1);
-
-		FVector AirStrafeInfluence = AirStrafeVelocity * (1 - LurchStrength);
-		FVector AirStrafeLurchInfluence = AirStrafeLurchVelocity * LurchStrength;
-		Velocity = AirStrafeInfluence + AirStrafeLurchInfluence;
+		const float LurchStrength = AdvancedMovementMath::GetStrafeLurchStrength(Time, StrafeLurchStartTime, StrafeLurchDuration, StrafeLurchFullStrengthDuration, StrafeLurchStrength);
+		Velocity = AdvancedMovementMath::BlendStrafeLurch(AirStrafeVelocity, AirStrafeLurchVelocity, LurchStrength);
 
-		if (bDebugStrafeLurch)
+		if (ADVANCED_MOVEMENT_DEBUG_ENABLED(bDebugStrafeLurch))
 		{
 			float PrevSpeed = OldVelocity.Size2D();
 			float Speed = Velocity.Size2D();
@@ -556,30 +787,25 @@ void UAdvancedMovementComponent::CalcVelocity(float DeltaTime, float Friction, b
 	//--------------------------------------------------------------------------------------------------------------//
 	else
 	{
-		// Find strafe
-		ProjVelocity = Velocity.X * AccelDir.X + Velocity.Y * AccelDir.Y; // Strafing subtracts from this value, neutral defaults to the player speed, and negative values add to speed 
-		AirSpeedCap = (GetMaxAcceleration() / 100) * AirStrafeSpeedGainMultiplier; // How much speed is gained during air strafing?
-		AirAccelerationMultiplier = AirStrafeRotationRate; // Drag is added to the equation if the accelerationMultiplier / 10 isn't the same as the player's velocity 
+		TraceBranch = EAdvancedMovementTraceBranch::AirStrafe;
 		
+		// The speed cap is how much speed is gained during air strafing, and drag is added to the equation if the rotation rate / 10 isn't the same as the player's velocity
+		const AdvancedMovementMath::FAirStrafeParams AirStrafe(DerivedParams.AirStrafeSpeedCap, AirStrafeRotationRate, AirControl);
+
 		// Update the acceleration based on the character's air control
 		Acceleration = GetFallingLateralAcceleration(DeltaTime);
-		
-		// Add strafing momentum to the character's velocity 
-		AddSpeed = Acceleration.GetClampedToMaxSize2D(AirSpeedCap).Size2D() - ProjVelocity;
-		if (AddSpeed > 0.0f)
-		{
-			AddedVelocity = Acceleration * AirAccelerationMultiplier * AirControl * DeltaTime;
-			AddedVelocity = AddedVelocity.GetClampedToMaxSize2D(AddSpeed);
-			Velocity += AddedVelocity;
-		}
+
+		// Add strafing momentum to the character's velocity
+		AddedVelocity = AdvancedMovementMath::GetAirStrafeVelocity(Velocity, AccelDir, Acceleration, AirStrafe, DeltaTime, ProjVelocity);
+		Velocity += AddedVelocity;
 	}
 	
 	// MovementInput, Gain/Lose Speed, AddedVelocity, Velocity, AirSpeedCap, AirAccelMultiplier
-	if (bDebugAirStrafe || bDebugStrafeSway)
+	if (ADVANCED_MOVEMENT_DEBUG_ENABLED(bDebugAirStrafe || bDebugStrafeSway))
 	{
-		if (IsStrafeSwaying() && !bDebugStrafeSway) return;
+		if (IsStrafeSwaying() && !ADVANCED_MOVEMENT_DEBUG_ENABLED(bDebugStrafeSway)) return;
 		else if (IsStrafeLurching()) return;
-		else if (!bDebugAirStrafe) return;
+		else if (!ADVANCED_MOVEMENT_DEBUG_ENABLED(bDebugAirStrafe)) return;
 
 		float PrevSpeed = OldVelocity.Size2D();
 		float Speed = Velocity.Size2D();
@@ -610,6 +836,8 @@ void UAdvancedMovementComponent::StartNewPhysics(float deltaTime, int32 Iteratio
 void UAdvancedMovementComponent::PhysWalking(float deltaTime, int32 Iterations)
 {
 	CSV_SCOPED_TIMING_STAT_EXCLUSIVE(CharPhysWalking);
+	ADVANCED_MOVEMENT_SCOPE_CYCLE_COUNTER(PhysWalking);
+	ADVANCED_MOVEMENT_PHYSICS_TIMER(Walking);
 
 	if (deltaTime < MIN_TICK_TIME)
 	{
@@ -637,6 +865,10 @@ void UAdvancedMovementComponent::PhysWalking(float deltaTime, int32 Iterations)
 
 void UAdvancedMovementComponent::PhysSlide(float deltaTime, int32 Iterations)
 {
+#if ADVANCED_MOVEMENT_WITH_SLIDING
+	ADVANCED_MOVEMENT_SCOPE_CYCLE_COUNTER(PhysSlide);
+	ADVANCED_MOVEMENT_PHYSICS_TIMER(Slide);
+
 	if (deltaTime < MIN_TICK_TIME)
 	{
 		return;
@@ -667,23 +899,29 @@ void UAdvancedMovementComponent::PhysSlide(float deltaTime, int32 Iterations)
 	}
 
 	GroundMovementPhysics(deltaTime, Iterations);
+#endif
 }
 
 
 void UAdvancedMovementComponent::PhysCustom(float deltaTime, int32 Iterations)
 {
+	ADVANCED_MOVEMENT_SCOPE_CYCLE_COUNTER(PhysCustom);
+
 	Super::PhysCustom(deltaTime, Iterations);
 
-	if (CustomMovementMode == MOVE_Custom_Slide) PhysSlide(deltaTime, Iterations);
-	if (CustomMovementMode == MOVE_Custom_WallClimbing) PhysWallClimbing(deltaTime, Iterations);
-	if (CustomMovementMode == MOVE_Custom_Mantling) PhysMantling(deltaTime, Iterations);
-	if (CustomMovementMode == MOVE_Custom_LedgeClimbing) PhysLedgeClimbing(deltaTime, Iterations);
-	if (CustomMovementMode == MOVE_Custom_WallRunning) PhysWallRunning(deltaTime, Iterations);
+	// Compiled out movement modes are never entered
+	if (FAdvancedMovementFeatures::bSliding && CustomMovementMode == MOVE_Custom_Slide) PhysSlide(deltaTime, Iterations);
+	if (FAdvancedMovementFeatures::bWallClimbing && CustomMovementMode == MOVE_Custom_WallClimbing) PhysWallClimbing(deltaTime, Iterations);
+	if (FAdvancedMovementFeatures::bMantling && CustomMovementMode == MOVE_Custom_Mantling) PhysMantling(deltaTime, Iterations);
+	if (FAdvancedMovementFeatures::bLedgeClimbing && CustomMovementMode == MOVE_Custom_LedgeClimbing) PhysLedgeClimbing(deltaTime, Iterations);
+	if (FAdvancedMovementFeatures::bWallRunning && CustomMovementMode == MOVE_Custom_WallRunning) PhysWallRunning(deltaTime, Iterations);
 }
 
 
 void UAdvancedMovementComponent::PhysFalling(float deltaTime, int32 Iterations)
 {
+	ADVANCED_MOVEMENT_SCOPE_CYCLE_COUNTER(PhysFalling);
+
 	if (deltaTime < MIN_TICK_TIME)
 	{
 		return;
@@ -721,6 +959,10 @@ void UAdvancedMovementComponent::PhysFalling(float deltaTime, int32 Iterations)
 
 void UAdvancedMovementComponent::PhysWallClimbing(float deltaTime, int32 Iterations)
 {
+#if ADVANCED_MOVEMENT_WITH_WALL_CLIMBING
+	ADVANCED_MOVEMENT_SCOPE_CYCLE_COUNTER(PhysWallClimbing);
+	ADVANCED_MOVEMENT_PHYSICS_TIMER(WallClimbing);
+
 	if (deltaTime < MIN_TICK_TIME)
 	{
 		return;
@@ -735,13 +977,27 @@ void UAdvancedMovementComponent::PhysWallClimbing(float deltaTime, int32 Iterati
 	}
 	
 	// if the character landed on the ground
-	FFindFloorResult FloorResult;
-	FindFloor(UpdatedComponent->GetComponentLocation(), FloorResult, false);
-	if (FloorResult.IsWalkableFloor() && IsValidLandingSpot(UpdatedComponent->GetComponentLocation(), FloorResult.HitResult))
+	if (ShouldCheckWallClimbFloor())
 	{
-		SetMovementMode(MOVE_Walking);
-		return;
+		FFindFloorResult FloorResult;
+		{
+			TGuardValue<EAdvancedMovementQuerySource> FloorSource(FloorQuerySource, EAdvancedMovementQuerySource::WallClimbFloor);
+			FindFloor(UpdatedComponent->GetComponentLocation(), FloorResult, false);
+		}
+		WallClimbFloorCheckLocation = UpdatedComponent->GetComponentLocation();
+		if (FloorResult.IsWalkableFloor()) WallClimbFloorZ = WallClimbFloorCheckLocation->Z - FloorResult.GetDistanceToFloor();
+		else WallClimbFloorZ.Reset();
+		if (FloorResult.IsWalkableFloor() && IsValidLandingSpot(UpdatedComponent->GetComponentLocation(), FloorResult.HitResult))
+		{
+			SetMovementMode(MOVE_Walking);
+			return;
+		}
+	}
+	else
+	{
+		INC_DWORD_STAT(STAT_AdvancedMovement_WallClimbFloorChecksSkipped);
 	}
+	bWallClimbHitWalkableSurface = false;
 	
 	// Wall climb duration
 	if (WallClimbDuration != 0 && WallClimbStartTime + CurrentWallClimbDuration <= Time)
@@ -774,7 +1030,7 @@ void UAdvancedMovementComponent::PhysWallClimbing(float deltaTime, int32 Iterati
 		FHitResult JumpHit;
 		if (WallJumpValid(deltaTime, OldLocation, AccelDir, JumpHit, FHitResult()))
 		{
-			CalculateWallJumpTrajectory(timeTick, Iterations, JumpHit, WallJumpSpeed, WallJumpBoostDuringWallClimbs, FString("WallClimb"));
+			CalculateWallJumpTrajectory(timeTick, Iterations, JumpHit, WallJumpSpeed, WallJumpBoostDuringWallClimbs, TEXT("WallClimb"));
 			return;
 		}
 		
@@ -807,6 +1063,8 @@ void UAdvancedMovementComponent::PhysWallClimbing(float deltaTime, int32 Iterati
 		// check if they're wall climbing
 		FHitResult Hit(1.f);
 		SafeMoveUpdatedComponent(Adjusted, PawnRotation, true, Hit); // Moves based on adjusted, updates velocity, and handles returning colliding information for handling the different movement scenarios
+		TraceSubstep(timeTick, Iterations, Hit.bBlockingHit ? Hit.Normal : FVector::ZeroVector);
+		SaveWallClimbHit(Hit);
 		if (Hit.IsValidBlockingHit())
 		{
 			float subTimeTickRemaining = timeTick * (1.f - Hit.Time);
@@ -821,7 +1079,7 @@ void UAdvancedMovementComponent::PhysWallClimbing(float deltaTime, int32 Iterati
 					Client_MantleLocation = MantleLedgeLocation;
 				}
 				
-				if (UpdatedComponent->GetComponentLocation().Z <= MantleLedgeLocation.Z) SetMovementMode(MOVE_Custom, MOVE_Custom_Mantling);
+				if (!FAdvancedMovementFeatures::bLedgeClimbing || UpdatedComponent->GetComponentLocation().Z <= MantleLedgeLocation.Z) SetMovementMode(MOVE_Custom, MOVE_Custom_Mantling);
 				else SetMovementMode(MOVE_Custom, MOVE_Custom_LedgeClimbing);
 				StartNewPhysics(subTimeTickRemaining, Iterations);
 				return;
@@ -829,8 +1087,7 @@ void UAdvancedMovementComponent::PhysWallClimbing(float deltaTime, int32 Iterati
 			
 			// transition out of wall climbing if they aren't trying to climb the wall
 			const FVector ForwardVector = bOrientRotationToMovement ? AccelDir : UpdatedComponent->GetForwardVector();
-			const float Angle = 180 - UKismetMathLibrary::DegAcos(Hit.Normal.Dot(ForwardVector));
-			if (Angle > WallClimbAcceptableAngle)
+			if (Hit.Normal.Dot(ForwardVector) > DerivedParams.WallClimbMaxDot)
 			{
 				SetMovementMode(MOVE_Falling);
 				StartNewPhysics(subTimeTickRemaining, Iterations);
@@ -841,8 +1098,9 @@ void UAdvancedMovementComponent::PhysWallClimbing(float deltaTime, int32 Iterati
 			HandleImpact(Hit, subTimeTickRemaining, Adjusted);
 			FVector Delta = ComputeSlideVector(Adjusted, 1.f - Hit.Time, Hit.Normal, Hit);
 			SafeMoveUpdatedComponent(Delta, PawnRotation, true, Hit);
+			SaveWallClimbHit(Hit);
 
-			if (bDebugWallClimb)
+			if (ADVANCED_MOVEMENT_DEBUG_ENABLED(bDebugWallClimb))
 			{
 				UE_LOGFMT(Movement, Log, "{0}::WallClimb ({1}) ->  ({2})({3}) Adjusted: ({4}), Vel: ({5}), WallClimbVector: ({6}), PlayerInput: ({7}), Speed: ({8}), Acceleration: ({9}), Multiplier: ({10})",
 					CharacterOwner->HasAuthority() ? *FString("Server") : *FString("Client"),
@@ -864,11 +1122,16 @@ void UAdvancedMovementComponent::PhysWallClimbing(float deltaTime, int32 Iterati
 			SetMovementMode(MOVE_Falling);
 		}
 	}
+#endif
 }
 
 
 void UAdvancedMovementComponent::PhysMantling(float deltaTime, int32 Iterations)
 {
+#if ADVANCED_MOVEMENT_WITH_MANTLING
+	ADVANCED_MOVEMENT_SCOPE_CYCLE_COUNTER(PhysMantling);
+	ADVANCED_MOVEMENT_PHYSICS_TIMER(Mantling);
+
 	if (deltaTime < MIN_TICK_TIME)
 	{
 		return;
@@ -912,8 +1175,9 @@ void UAdvancedMovementComponent::PhysMantling(float deltaTime, int32 Iterations)
 			FRotator TargetRotation = FRotator(0, MantleRotation.Yaw, 0);
 			
 			// Use speed adjustments to create your own ease in transitions
-			const float CurrentPercent = (MantleLedgeLocation - OldLocation).Size() / (MantleLedgeLocation - MantleStartLocation).Size();; // 0-1
-			const float InterpSpeedAdjustments = MantleRotationSpeedAdjustments ? FMath::Clamp(MantleRotationSpeedAdjustments->GetFloatValue(CurrentPercent * 10), 0.1, 10) : 1;
+			const float InvDistance = MantleInterpDistance.Get(MantleStartLocation, MantleLedgeLocation);
+			const float CurrentPercent = AdvancedMovementMath::GetInterpRemaining(MantleLedgeLocation, OldLocation, InvDistance); // 0-1
+			const float InterpSpeedAdjustments = EvaluateSpeedCurve(MantleRotationSpeedAdjustments, CurrentPercent);
 			
 			// UKismetMathLibrary::RInterpTo();
 			FRotator Delta = (TargetRotation - PlayerRotation).GetNormalized();
@@ -923,13 +1187,14 @@ void UAdvancedMovementComponent::PhysMantling(float deltaTime, int32 Iterations)
 			// 	MantleRotation.Yaw, PlayerRotation.Yaw, TargetRotation.Yaw, AdjustedRotation.Yaw);
 			
 			// Interp the character to the target location
-			Adjusted = MantleAndClimbInterp(timeTick, MantleStartLocation, MantleLedgeLocation, OldLocation, MantleSpeed, MantleSpeedAdjustments);
+			Adjusted = MantleAndClimbInterpBaked(timeTick, MantleLedgeLocation, OldLocation, InvDistance, MantleSpeed, MantleSpeedAdjustments);
 			FHitResult Hit;
 			SafeMoveUpdatedComponent(Adjusted, (PlayerRotation + AdjustedRotation).GetNormalized(), false, Hit);
+			TraceSubstep(timeTick, Iterations, Hit.bBlockingHit ? Hit.Normal : FVector::ZeroVector);
 
 			// TODO: Error handling
 			
-			if (bDebugMantle)
+			if (ADVANCED_MOVEMENT_DEBUG_ENABLED(bDebugMantle))
 			{
 				UE_LOGFMT(Movement, Log, "{0}::Mantling ({1}) ->  ({2})({3}) Mantle/Location: ({4})({5}), Vector/Adjusted: ({6})({7}), Speed: ({8}), PlayerAngle: ({9})",
 					CharacterOwner->HasAuthority() ? *FString("Server") : *FString("Client"),
@@ -948,7 +1213,7 @@ void UAdvancedMovementComponent::PhysMantling(float deltaTime, int32 Iterations)
 		else
 		{
 			// if the player presses forward, climb up on the ledge.
-			if (bUseLedgeClimbing && !PlayerInput.IsNearlyZero(0.1) && PlayerAngle > 0.64)
+			if (UsesLedgeClimbing() && !PlayerInput.IsNearlyZero(0.1) && PlayerAngle > 0.64)
 			{
 				SetMovementMode(MOVE_Custom, MOVE_Custom_LedgeClimbing);
 				StartNewPhysics(deltaTime, Iterations);
@@ -956,11 +1221,16 @@ void UAdvancedMovementComponent::PhysMantling(float deltaTime, int32 Iterations)
 			}
 		}
 	}
+#endif
 }
 
 
 void UAdvancedMovementComponent::PhysLedgeClimbing(float deltaTime, int32 Iterations)
 {
+#if ADVANCED_MOVEMENT_WITH_LEDGE_CLIMBING
+	ADVANCED_MOVEMENT_SCOPE_CYCLE_COUNTER(PhysLedgeClimbing);
+	ADVANCED_MOVEMENT_PHYSICS_TIMER(LedgeClimbing);
+
 	if (deltaTime < MIN_TICK_TIME)
 	{
 		return;
@@ -997,13 +1267,16 @@ void UAdvancedMovementComponent::PhysLedgeClimbing(float deltaTime, int32 Iterat
 		if (!UpdatedComponent->GetComponentLocation().Equals(LedgeClimbLocation + FVector(0, 0, CharacterHeightOffset), 0.1))
 		{
 			// Interp the character to the target location
-			Adjusted = MantleAndClimbInterp(timeTick, LedgeClimbStartLocation, LedgeClimbLocation + FVector(0, 0, CharacterHeightOffset), OldLocation, CurrentClimbSpeed, CurrentClimbSpeedAdjustments);
+			const FVector TargetLocation = LedgeClimbLocation + FVector(0, 0, CharacterHeightOffset);
+			const float InvDistance = LedgeClimbInterpDistance.Get(LedgeClimbStartLocation, TargetLocation);
+			Adjusted = MantleAndClimbInterpBaked(timeTick, TargetLocation, OldLocation, InvDistance, CurrentClimbSpeed, CurrentClimbSpeedAdjustments);
 			FHitResult Hit;
 			SafeMoveUpdatedComponent(Adjusted, UpdatedComponent->GetComponentRotation(), false, Hit);
+			TraceSubstep(timeTick, Iterations, Hit.bBlockingHit ? Hit.Normal : FVector::ZeroVector);
 
 			// TODO: Error handling
 			
-			if (bDebugLedgeClimb)
+			if (ADVANCED_MOVEMENT_DEBUG_ENABLED(bDebugLedgeClimb))
 			{
 				UE_LOGFMT(Movement, Log, "{0}::LedgeClimbing ({1}) ->  ({2})({3}) Ledge/Location: ({4})({5}), Vector/Adjusted: ({6})({7}), Speed: ({8})",
 					CharacterOwner->HasAuthority() ? *FString("Server") : *FString("Client"),
@@ -1029,11 +1302,16 @@ void UAdvancedMovementComponent::PhysLedgeClimbing(float deltaTime, int32 Iterat
 			return;
 		}
 	}
+#endif
 }
 
 
 void UAdvancedMovementComponent::PhysWallRunning(float deltaTime, int32 Iterations)
 {
+#if ADVANCED_MOVEMENT_WITH_WALL_RUNNING
+	ADVANCED_MOVEMENT_SCOPE_CYCLE_COUNTER(PhysWallRunning);
+	ADVANCED_MOVEMENT_PHYSICS_TIMER(WallRunning);
+
 	if (deltaTime < MIN_TICK_TIME)
 	{
 		return;
@@ -1076,7 +1354,7 @@ void UAdvancedMovementComponent::PhysWallRunning(float deltaTime, int32 Iteratio
 		FHitResult JumpHit;
 		if (WallJumpValid(deltaTime, OldLocation, AccelDir, JumpHit, FHitResult()))
 		{
-			CalculateWallJumpTrajectory(timeTick, Iterations, JumpHit, WallJumpSpeed, WallJumpBoostDuringWallRuns, FString("WallRun"));
+			CalculateWallJumpTrajectory(timeTick, Iterations, JumpHit, WallJumpSpeed, WallJumpBoostDuringWallRuns, TEXT("WallRun"));
 			return;
 		}
 
@@ -1099,10 +1377,11 @@ void UAdvancedMovementComponent::PhysWallRunning(float deltaTime, int32 Iteratio
 				FVector(UKismetMathLibrary::GetRightVector(CharacterRotation) * PlayerInput.Y)
 			).GetSafeNormal();
 			
-			// Find which way the character should wall run
+			// Find which way the character should wall run, the direction along the wall is only recalculated once they've left the wall's plane
+			if (!IsWallRunContactValid()) UpdateWallRunContact(WallRunWall, WallRunNormal);
 			float WallDirection = WallRunNormal.Dot(UpdatedComponent->GetForwardVector()); // The impact normal of the wall is based on the current surface
-			float PlayerForwardsDirection = UpdatedComponent->GetForwardVector().Dot(WallRunWall->GetRightVector()); // The Get vectors of the wall are to help translate things in world space
-			FVector WallRunDirection = PlayerForwardsDirection < 0 ? WallRunWall->GetRightVector() * -1 : WallRunWall->GetRightVector();
+			float PlayerForwardsDirection = UpdatedComponent->GetForwardVector().Dot(WallRunContact.Tangent);
+			FVector WallRunDirection = PlayerForwardsDirection < 0 ? WallRunContact.Tangent * -1 : WallRunContact.Tangent;
 			if (bShouldRunBackwardsIfFacingAwayFromWall && WallDirection > 0) WallRunDirection *= -1;
 			WallRunVector = FVector(
 				FMath::Clamp(CharacterInput.X + WallRunDirection.X, -1, 1) * WallRunMultiplier.X,
@@ -1110,7 +1389,7 @@ void UAdvancedMovementComponent::PhysWallRunning(float deltaTime, int32 Iteratio
 				WallRunMultiplier.Y
 			);
 			
-			if (bDebugWallRunTraces)
+			if (ADVANCED_MOVEMENT_DEBUG_ENABLED(bDebugWallRunTraces))
 			{
 				DrawDebugLine(GetWorld(), OldLocation, OldLocation + WallRunNormal * 50, FColor::Emerald, false, TraceDuration);
 				DrawDebugLine(GetWorld(), OldLocation, OldLocation + WallRunDirection * 100 + FVector(0, 0, 2), FColor::Cyan, false, TraceDuration);
@@ -1125,12 +1404,17 @@ void UAdvancedMovementComponent::PhysWallRunning(float deltaTime, int32 Iteratio
 		// check if there's a wall
 		FHitResult Hit(1.f);
 		SafeMoveUpdatedComponent(Adjusted, PawnRotation, true, Hit); // Moves based on adjusted, updates velocity, and handles returning colliding information for handling the different movement scenarios
+		TraceSubstep(timeTick, Iterations, Hit.bBlockingHit ? Hit.Normal : FVector::ZeroVector);
 		if (Hit.IsValidBlockingHit())
 		{
 			float LastMoveTimeSlice = timeTick;
 			float subTimeTickRemaining = timeTick * (1.f - Hit.Time);
-			WallRunNormal = Hit.Normal;
-			WallRunWall = Hit.GetComponent();
+			if (WallRunContactChanged(Hit))
+			{
+				WallRunNormal = Hit.Normal;
+				WallRunWall = Hit.GetComponent();
+				UpdateWallRunContact(WallRunWall, WallRunNormal);
+			}
 			
 			// if the character just landed on the ground
 			if (IsValidLandingSpot(UpdatedComponent->GetComponentLocation(), Hit))
@@ -1141,8 +1425,7 @@ void UAdvancedMovementComponent::PhysWallRunning(float deltaTime, int32 Iteratio
 			}
 			
 			// transition out of wall running if they aren't trying to wall run
-			const float Angle = 180 - UKismetMathLibrary::DegAcos(Hit.Normal.Dot(UpdatedComponent->GetForwardVector()));
-			if (Angle < 90 - WallRunAcceptableAngleRadius || Angle > 90 + WallRunAcceptableAngleRadius)
+			if (FMath::Abs(Hit.Normal.Dot(UpdatedComponent->GetForwardVector())) > DerivedParams.WallRunMaxDot)
 			{
 				SetMovementMode(MOVE_Falling);
 				StartNewPhysics(timeTick, Iterations);
@@ -1154,7 +1437,7 @@ void UAdvancedMovementComponent::PhysWallRunning(float deltaTime, int32 Iteratio
 			FVector Delta = ComputeSlideVector(Adjusted, 1.f - Hit.Time, Hit.Normal, Hit);
 			SafeMoveUpdatedComponent(Delta, PawnRotation, true, Hit);
 
-			if (bDebugWallRunning)
+			if (ADVANCED_MOVEMENT_DEBUG_ENABLED(bDebugWallRunning))
 			{
 				float AddedSpeed = Adjusted.Size2D();
 				UE_LOGFMT(Movement, Log, "{0}::WallRunning ({1}) ->  ({2})({3}) Adjusted: ({4}), Vel: ({5}), WallRunVector: ({6}), PlayerInput: ({7}), Angle: ({8}), SpeedCap: {9}, WallRunMultiplier: ({10})",
@@ -1176,6 +1459,7 @@ void UAdvancedMovementComponent::PhysWallRunning(float deltaTime, int32 Iteratio
 			SetMovementMode(MOVE_Falling);
 		}
 	}
+#endif
 }
 
 
@@ -1279,9 +1563,12 @@ void UAdvancedMovementComponent::FallingMovementPhysics(float deltaTime, float&
 	const FVector& OldLocation, const FVector& OldVelocity, const FQuat& PawnRotation, FVector& Adjusted,
 	bool bHasLimitedAirControl, FVector& Gravity, float& GravityTime)
 {
+	ADVANCED_MOVEMENT_PHYSICS_TIMER(Falling);
+
 	// Move the character based on the updated velocity and acceleration
 	FHitResult Hit(1.f);
 	SafeMoveUpdatedComponent( Adjusted, PawnRotation, true, Hit);
+	TraceSubstep(timeTick, Iterations, Hit.bBlockingHit ? Hit.Normal : FVector::ZeroVector);
 	
 	if (!HasValidData())
 	{
@@ -1315,9 +1602,9 @@ void UAdvancedMovementComponent::FallingMovementPhysics(float deltaTime, float&
 	
 	// Check if the player is trying to wall jump
 	FHitResult JumpHit;
-	if (WallJumpValid(deltaTime, OldLocation, AccelDir, JumpHit, Hit))
+	if (FAdvancedMovementFeatures::bWallJumping && WallJumpValid(deltaTime, OldLocation, AccelDir, JumpHit, Hit))
 	{
-		CalculateWallJumpTrajectory(timeTick, Iterations, JumpHit, WallJumpSpeed, WallJumpBoost, FString("Air Strafe"));
+		CalculateWallJumpTrajectory(timeTick, Iterations, JumpHit, WallJumpSpeed, WallJumpBoost, TEXT("Air Strafe"));
 		return;
 	}
 	
@@ -1343,7 +1630,7 @@ void UAdvancedMovementComponent::FallingMovementPhysics(float deltaTime, float&
 		}
 		
 		// Wall Climb
-		if (CanWallClimb() && TryingToClimbWall(Hit.Normal))
+		if (FAdvancedMovementFeatures::bWallClimbing && CanWallClimb() && TryingToClimbWall(Hit.Normal))
 		{
 			PrevWallClimbLocation = Hit.Location;
 			PrevWallClimbNormal = Hit.ImpactNormal;
@@ -1352,7 +1639,7 @@ void UAdvancedMovementComponent::FallingMovementPhysics(float deltaTime, float&
 		}
 		
 		// Wall Run
-		if (CanWallRun(Hit))
+		if (FAdvancedMovementFeatures::bWallRunning && CanWallRun(Hit))
 		{
 			WallRunWall = Hit.GetComponent();
 			WallRunNormal = Hit.Normal;
@@ -1392,7 +1679,7 @@ void UAdvancedMovementComponent::FallingMovementPhysics(float deltaTime, float&
 
 			AirControlDeltaV *= LastMoveTimeSlice;
 			Adjusted = (VelocityNoAirControl + AirControlDeltaV) * LastMoveTimeSlice;
-			if (bDebugAirStrafeTrace)
+			if (ADVANCED_MOVEMENT_DEBUG_ENABLED(bDebugAirStrafeTrace))
 			{
 				DrawDebugLine(GetWorld(), OldLocation + FVector(0, 0, 64), (OldLocation + FVector(0, 0, 64)) + (Adjusted.GetSafeNormal() * 100), FColor::Emerald, false, TraceDuration);
 				DrawDebugLine(GetWorld(), OldLocation + FVector(0, 0, 30), (OldLocation + FVector(0, 0, 30)) + (AirControlAccel.GetSafeNormal() * 100), FColor::Blue, false, TraceDuration);
@@ -1532,8 +1819,11 @@ void UAdvancedMovementComponent::FallingMovementPhysics(float deltaTime, float&
 
 bool UAdvancedMovementComponent::WallJumpValid(float deltaTime, const FVector& OldLocation, const FVector& InputVector, FHitResult& JumpHit, const FHitResult& Hit)
 {
+#if ADVANCED_MOVEMENT_WITH_WALL_JUMPING
+	ADVANCED_MOVEMENT_SCOPE_CYCLE_COUNTER(WallJumpValid);
+
 	// If wall jumping is enabled
-	if (!bUseWallJumping) return false;
+	if (!UsesWallJumping()) return false;
 	
 	// If the player isn't trying to wall jump, just return
 	if (!WallJumpPressed) return false;
@@ -1542,7 +1832,7 @@ bool UAdvancedMovementComponent::WallJumpValid(float deltaTime, const FVector& O
 	if (WallJumpLimit != 0 && CurrentWallJumpCount >= WallJumpLimit) return false;
 
 	// Prevent wall jumping immediately and wasting another jump (We use distance instead of height to account for ledges and all scenarios)
-	if ((UpdatedComponent->GetComponentLocation() - PreviousGroundLocation).Size() < WallJumpHeightFromGroundThreshold ) return false;
+	if ((UpdatedComponent->GetComponentLocation() - PreviousGroundLocation).SizeSquared() < DerivedParams.WallJumpHeightFromGroundThresholdSquared) return false;
 	
 	// If the movement component has captured a valid wall already, just use that
 	if (Hit.bBlockingHit && !Hit.ImpactNormal.Equals(PrevWallJumpNormal, 0.1))
@@ -1555,42 +1845,28 @@ bool UAdvancedMovementComponent::WallJumpValid(float deltaTime, const FVector& O
 	const FVector InputDir = Start + InputVector * WallJumpValidDistance;
 	const FVector Front = Start + UpdatedComponent->GetForwardVector() * WallJumpValidDistance;
 	
-	TArray<AActor*> CharacterActors;
-	CharacterOwner->GetAllChildActors(CharacterActors); // TODO: Investigate if this includes player spawned actors
-	CharacterActors.AddUnique(CharacterOwner);
+	// The probe from the previous tick already found that there isn't a wall to jump off of
+	if (WallJumpProbeFoundNoWall(Start, InputDir, Front)) return false;
+
+	const ECollisionChannel TraceChannel = UEngineTypes::ConvertToCollisionChannel(MovementChannel);
+	const FCollisionQueryParams QueryParams = GetMovementQueryParams(SCENE_QUERY_STAT(AdvancedMovementWallJump));
 
 	// Check whether there's a wall in front or behind the player
-	UKismetSystemLibrary::LineTraceSingle(
-		GetWorld(),
-		Start,
-		InputDir,
-		MovementChannel,
-		false,
-		CharacterActors,
-		bDebugWallJumpTrace ? EDrawDebugTrace::ForDuration : EDrawDebugTrace::None,
-		JumpHit,
-		true,
-		FColor::Emerald,
-		FColor::Blue,
-		TraceDuration
-	);
+	AddSceneQuery(EAdvancedMovementQuerySource::WallJump, EAdvancedMovementQuery::LineTrace);
+	GetWorld()->LineTraceSingleByChannel(JumpHit, Start, InputDir, TraceChannel, QueryParams);
+	if (ADVANCED_MOVEMENT_DEBUG_ENABLED(bDebugWallJumpTrace))
+	{
+		DrawDebugLineTraceSingle(GetWorld(), Start, InputDir, EDrawDebugTrace::ForDuration, JumpHit.bBlockingHit, JumpHit, FColor::Emerald, FColor::Blue, TraceDuration);
+	}
 
 	if (!JumpHit.bBlockingHit)
 	{
-		UKismetSystemLibrary::LineTraceSingle(
-			GetWorld(),
-			Start,
-			Front,
-			MovementChannel,
-			false,
-			CharacterActors,
-			bDebugWallJumpTrace ? EDrawDebugTrace::ForDuration : EDrawDebugTrace::None,
-			JumpHit,
-			true,
-			FColor::Cyan,
-			FColor::Blue,
-			TraceDuration
-		);
+		AddSceneQuery(EAdvancedMovementQuerySource::WallJump, EAdvancedMovementQuery::LineTrace);
+		GetWorld()->LineTraceSingleByChannel(JumpHit, Start, Front, TraceChannel, QueryParams);
+		if (ADVANCED_MOVEMENT_DEBUG_ENABLED(bDebugWallJumpTrace))
+		{
+			DrawDebugLineTraceSingle(GetWorld(), Start, Front, EDrawDebugTrace::ForDuration, JumpHit.bBlockingHit, JumpHit, FColor::Cyan, FColor::Blue, TraceDuration);
+		}
 
 		if (!JumpHit.bBlockingHit)
 		{
@@ -1603,7 +1879,7 @@ bool UAdvancedMovementComponent::WallJumpValid(float deltaTime, const FVector& O
 		return false;
 	}
 
-	if (bDebugWallJumpTrace)
+	if (ADVANCED_MOVEMENT_DEBUG_ENABLED(bDebugWallJumpTrace))
 	{
 		DrawDebugBox(
 			GetWorld(),
@@ -1616,6 +1892,9 @@ bool UAdvancedMovementComponent::WallJumpValid(float deltaTime, const FVector& O
 	}
 	
 	return true;
+#else
+	return false;
+#endif
 }
 
 
@@ -1638,7 +1917,7 @@ void UAdvancedMovementComponent::CalculateMantleJumpTrajectory(const FVector2D S
 	const FVector AddedVelocity = AccelDir * FVector(SpeedBoost.X, SpeedBoost.X, 0) + FVector(0, 0, SpeedBoost.Y);
 	Velocity += AddedVelocity;
 
-	if (bDebugMantleJump)
+	if (ADVANCED_MOVEMENT_DEBUG_ENABLED(bDebugMantleJump))
 	{
 		UE_LOGFMT(Movement, Warning, "{0}::MantleJump () ->  ({1})({2}) Initial/Vel: ({3})({4}), AdditionalVelocity: ({5})",
 			CharacterOwner->HasAuthority() ? *FString("Server") : *FString("Client"),
@@ -1652,8 +1931,10 @@ void UAdvancedMovementComponent::CalculateMantleJumpTrajectory(const FVector2D S
 }
 
 
-void UAdvancedMovementComponent::CalculateWallJumpTrajectory(float DeltaTime, int32 Iterations, const FHitResult& Wall, float Speed, FVector2D Boost, FString PrevState)
+void UAdvancedMovementComponent::CalculateWallJumpTrajectory(float DeltaTime, int32 Iterations, const FHitResult& Wall, float Speed, FVector2D Boost, const TCHAR* PrevState)
 {
+	ADVANCED_MOVEMENT_SCOPE_CYCLE_COUNTER(CalculateWallJumpTrajectory);
+
 	if (!UpdatedComponent) return;
 	
 	// Most velocity calculation happens when the character is already sliding alongside the wall, and we need a calculation that's net safe for handling every scenario safely
@@ -1666,62 +1947,36 @@ void UAdvancedMovementComponent::CalculateWallJumpTrajectory(float DeltaTime, in
 		WallJump = Wall.ImpactNormal;
 		WallJump.Z = 1;
 	}
+#if ADVANCED_MOVEMENT_WITH_WALL_RUNNING
 	else if (IsCustomMovementMode(MOVE_Custom_WallRunning))
 	{
-		const float PlayerForwardsDirection = UpdatedComponent->GetForwardVector().Dot(WallRunWall->GetRightVector());
-		const FVector WallJumpDirection = PlayerForwardsDirection < 0 ? WallRunWall->GetRightVector() * -1 : WallRunWall->GetRightVector();
-		WallJump = FVector(
-			FMath::Clamp((WallJumpDirection.X + WallRunNormal.X) / 2, -1, 1),
-			FMath::Clamp((WallJumpDirection.Y + WallRunNormal.Y) / 2, -1, 1),
-			1
-		);
+		WallJump = AdvancedMovementMath::GetWallRunJumpDirection(UpdatedComponent->GetForwardVector(), WallRunContact.Tangent, WallRunNormal);
 	}
+#endif
 	else
 	{
 		// Calculate the trajectory
 		WallLocation = FVector(Wall.ImpactPoint.X, Wall.ImpactPoint.Y, 0);
 		PrevLocation = FVector(PreviousGroundLocation.X, PreviousGroundLocation.Y, 0);
 		if (PrevLocation.Equals(FVector(WallLocation.X, WallLocation.Y, 0), WallJumpSpacing)) PrevLocation += Wall.Normal * WallJumpSpacing;
-		const FVector CharacterTrajectory = (WallLocation - PrevLocation).GetSafeNormal2D();
-		
-		const float WallAngle = Wall.ImpactNormal.Dot(CharacterTrajectory); // -0.5 or greater is 45^ or less
-		WallJump = (CharacterTrajectory - 2 * (CharacterTrajectory | Wall.ImpactNormal) * Wall.ImpactNormal).GetSafeNormal();
-		
-		// Check if the previous ground location is behind the wall location using the normal, if so fix the trajectory so it doesn't create the wrong walljumps
-		if (WallAngle > 0)
-		{
-			const FVector LocationAlignedToWall = (Wall.Normal.GetSafeNormal2D() * WallLocation) + ((FVector(1) - Wall.Normal.GetSafeNormal2D()) * PrevLocation);
-			const float DistanceFromWall = LocationAlignedToWall.Size();
-			const FVector WallJumpTrajectory = (WallLocation - (LocationAlignedToWall + (Wall.ImpactNormal * DistanceFromWall))).GetSafeNormal();
-			WallJump = (WallJumpTrajectory - 2 * (WallJumpTrajectory | Wall.ImpactNormal) * Wall.ImpactNormal).GetSafeNormal();
 
-			if (bDebugWallJumpTrace)
-			{
-				DrawDebugBox(GetWorld(), LocationAlignedToWall, FVector(10), FColor::Red, false, TraceDuration);
-				DrawDebugBox(GetWorld(), LocationAlignedToWall + Wall.ImpactNormal * DistanceFromWall, FVector(10), FColor::Orange, false, TraceDuration);
-			}
-		}
-		// Fix wall jumps when sliding alongside a wall (during Air Strafing)
-		else if (WallAngle > -0.45)
-		{
-			WallJump = (Velocity.GetSafeNormal2D() - Wall.ImpactNormal) / 2 + Wall.ImpactNormal;
-		}
+		// Reflect the trajectory off of the wall, and fix wall jumps that start behind the wall or are sliding alongside it (during Air Strafing)
+		WallJump = AdvancedMovementMath::GetWallJumpDirection(WallLocation, PrevLocation, Wall.Normal, Wall.ImpactNormal, Velocity);
 
-		// Wall jump Z velocity is factored in during the boost, and not while redirecting the velocity
-		WallJump = FVector(WallJump.X, WallJump.Y, 1);
-		
-		// Smooth out gravity for non positive wall jump values
-		if (Velocity.GetSafeNormal().Z < 0)
+		// The previous ground location is behind the wall location
+		if (ADVANCED_MOVEMENT_DEBUG_ENABLED(bDebugWallJumpTrace) && Wall.ImpactNormal.Dot((WallLocation - PrevLocation).GetSafeNormal2D()) > 0)
 		{
-			WallJump = FVector(WallJump.X, WallJump.Y, 0.5);
+			const FVector LocationAlignedToWall = (Wall.Normal.GetSafeNormal2D() * WallLocation) + ((FVector(1) - Wall.Normal.GetSafeNormal2D()) * PrevLocation);
+			DrawDebugBox(GetWorld(), LocationAlignedToWall, FVector(10), FColor::Red, false, TraceDuration);
+			DrawDebugBox(GetWorld(), LocationAlignedToWall + Wall.ImpactNormal * LocationAlignedToWall.Size(), FVector(10), FColor::Orange, false, TraceDuration);
 		}
 	}
-	
-	
+
+
 	// Wall jump calculations. Their speeds should be static, and also save the player's current velocity
 	const float CurrentSpeed = Velocity.Size2D();
-	const FVector RedirectedVelocity = FVector(WallJump.X, WallJump.Y, 0) * FMath::Max(CurrentSpeed, Speed);
-	Velocity = RedirectedVelocity + (WallJump * FVector(Boost.X, Boost.X, Boost.Y));
+	FVector RedirectedVelocity;
+	Velocity = AdvancedMovementMath::GetWallJumpVelocity(WallJump, Velocity, Speed, Boost, RedirectedVelocity);
 	PrevWallJumpNormal = Wall.ImpactNormal;
 	PrevWallJumpLocation = Wall.Location;
 	PrevWallJumpTime = Time;
@@ -1731,7 +1986,7 @@ void UAdvancedMovementComponent::CalculateWallJumpTrajectory(float DeltaTime, in
 	StartNewPhysics(DeltaTime, Iterations);
 
 	
-	if (bDebugWallJumpTrajectory)
+	if (ADVANCED_MOVEMENT_DEBUG_ENABLED(bDebugWallJumpTrajectory))
 	{
 		FVector DebugWallLocation = WallLocation;
 		FVector DebugPrevLocation = PrevLocation;
@@ -1748,7 +2003,7 @@ void UAdvancedMovementComponent::CalculateWallJumpTrajectory(float DeltaTime, in
 		
 		UE_LOGFMT(Movement, Warning, "{0}::WallJump ({1}) ->  ({2})({3}) Initial/Vel: ({4})({5}), Boost: ({6}), CapturedSpeed: ({7}), Wall/Prev Location: ({8})({9})",
 			CharacterOwner->HasAuthority() ? *FString("Server") : *FString("Client"),
-			*PrevState,
+			PrevState,
 			*GetMovementDirection(PlayerInput),
 			*FString::SanitizeFloat(Speed),
 			*Velocity.ToString(),
@@ -1760,7 +2015,7 @@ void UAdvancedMovementComponent::CalculateWallJumpTrajectory(float DeltaTime, in
 		);
 	}
 	
-	if (bDebugWallJumpTrace)
+	if (ADVANCED_MOVEMENT_DEBUG_ENABLED(bDebugWallJumpTrace))
 	{
 		DrawDebugBox(GetWorld(), PreviousGroundLocation, FVector(10), FColor::Blue, false, TraceDuration);
 		DrawDebugLine(GetWorld(), UpdatedComponent->GetComponentLocation(), UpdatedComponent->GetComponentLocation() + (WallJump * 250), FColor::Red, false, TraceDuration);
@@ -1911,11 +2166,14 @@ void UAdvancedMovementComponent::GroundMovementPhysics(float deltaTime, int32 It
 		if (StepDownResult.bComputedFloor)
 		{
 			CurrentFloor = StepDownResult.FloorResult;
+			FloorCoherenceReuses = 0;
 		}
-		else
+		else if (bZeroDelta || !ReuseFloor(OldFloor, OldLocation, CurrentFloor))
 		{
 			FindFloor(UpdatedComponent->GetComponentLocation(), CurrentFloor, bZeroDelta, NULL);
+			FloorCoherenceReuses = 0;
 		}
+		TraceSubstep(timeTick, Iterations, CurrentFloor.bBlockingHit ? CurrentFloor.HitResult.Normal : FVector::ZeroVector);
 
 
 		// check for ledges here
@@ -1960,7 +2218,7 @@ void UAdvancedMovementComponent::GroundMovementPhysics(float deltaTime, int32 It
 			// Validate the floor check
 			if (CurrentFloor.IsWalkableFloor())
 			{
-				DebugGroundMovement(FString("This floor is valid to walk on"), FColor::Blue);
+				if (ADVANCED_MOVEMENT_DEBUG_ENABLED(bDebugGroundMovement)) DebugGroundMovement(TEXT("This floor is valid to walk on"), FColor::Blue);
 				if (ShouldCatchAir(OldFloor, CurrentFloor))
 				{
 					HandleWalkingOffLedge(OldFloor.HitResult.ImpactNormal, OldFloor.HitResult.Normal, OldLocation, timeTick);
@@ -1980,7 +2238,7 @@ void UAdvancedMovementComponent::GroundMovementPhysics(float deltaTime, int32 It
 			{
 				// The floor check failed because it started in penetration
 				// We do not want to try to move downward because the downward sweep failed, rather we'd like to try to pop out of the floor.
-				DebugGroundMovement(FString("This floor check failed"), FColor::Yellow);
+				if (ADVANCED_MOVEMENT_DEBUG_ENABLED(bDebugGroundMovement)) DebugGroundMovement(TEXT("This floor check failed"), FColor::Yellow);
 
 				FHitResult Hit(CurrentFloor.HitResult);
 				Hit.TraceEnd = Hit.TraceStart + FVector(0.f, 0.f, MAX_FLOOR_DIST);
@@ -1999,7 +2257,7 @@ void UAdvancedMovementComponent::GroundMovementPhysics(float deltaTime, int32 It
 			// See if we need to start falling.
 			if (!CurrentFloor.IsWalkableFloor() && !CurrentFloor.HitResult.bStartPenetrating)
 			{
-				DebugGroundMovement(FString("The character started falling"), FColor::Red);
+				if (ADVANCED_MOVEMENT_DEBUG_ENABLED(bDebugGroundMovement)) DebugGroundMovement(TEXT("The character started falling"), FColor::Red);
 				const bool bMustJump = bJustTeleported || bZeroDelta || (OldBase == NULL || (!OldBase->IsQueryCollisionEnabled() && MovementBaseUtility::IsDynamicBase(OldBase)));
 				if ((bMustJump || !bCheckedFall) && CheckFall(OldFloor, CurrentFloor.HitResult, Delta, OldLocation, remainingTime, timeTick, Iterations, bMustJump))
 				{
@@ -2027,6 +2285,38 @@ void UAdvancedMovementComponent::GroundMovementPhysics(float deltaTime, int32 It
 		}
 	}
 }
+
+
+bool UAdvancedMovementComponent::ReuseFloor(const FFindFloorResult& OldFloor, const FVector& OldLocation, FFindFloorResult& OutFloor)
+{
+	if (!bUseFloorCoherence || FloorCoherenceReuses >= FloorCoherenceMaxReuses || bForceNextFloorCheck || bJustTeleported || !UpdatedComponent || !CharacterOwner) return false;
+	if (!OldFloor.IsWalkableFloor() || OldFloor.bLineTrace || OldFloor.HitResult.bStartPenetrating) return false;
+
+	// Moving floors have to be checked every time
+	UPrimitiveComponent* Floor = OldFloor.HitResult.GetComponent();
+	if (!Floor || Floor->Mobility != EComponentMobility::Static || Floor != GetMovementBase()) return false;
+
+	// The character has to have moved along the floor's plane
+	const FVector Location = UpdatedComponent->GetComponentLocation();
+	const FVector Move = Location - OldLocation;
+	if (FMath::Abs(Move.Dot(OldFloor.HitResult.ImpactNormal)) > UE_KINDA_SMALL_NUMBER * 10.f) return false;
+
+	// Confirm the floor is still underneath the character without sweeping the scene
+	FHitResult FloorHit;
+	const FVector TraceEnd = Location - FVector(0.f, 0.f, CharacterOwner->GetCapsuleComponent()->GetScaledCapsuleHalfHeight() + MAX_FLOOR_DIST);
+	if (!Floor->LineTraceComponent(FloorHit, Location, TraceEnd, FCollisionQueryParams(SCENE_QUERY_STAT(AdvancedMovementFloorCoherence), false))) return false;
+	if (!FloorHit.ImpactNormal.Equals(OldFloor.HitResult.ImpactNormal, UE_KINDA_SMALL_NUMBER)) return false;
+
+	// The floor is the same plane, just moved along with the character
+	OutFloor = OldFloor;
+	OutFloor.HitResult.TraceStart += Move;
+	OutFloor.HitResult.TraceEnd += Move;
+	OutFloor.HitResult.Location += Move;
+	OutFloor.HitResult.ImpactPoint += Move;
+	FloorCoherenceReuses++;
+	INC_DWORD_STAT(STAT_AdvancedMovement_FloorsReused);
+	return true;
+}
 #pragma endregion 
 
 
@@ -2038,7 +2328,7 @@ void UAdvancedMovementComponent::GroundMovementPhysics(float deltaTime, int32 It
 #pragma region Sliding
 bool UAdvancedMovementComponent::CanSlide() const
 {
-	if (!bUseSliding) return false;
+	if (!UsesSliding()) return false;
 	if (!CharacterOwner->GetCapsuleComponent() || IsFalling()) return false;
 	if (PrevSlideTime + SlideDelay > Time) return false;
 	if (!IsCrouching()) return false;
@@ -2068,7 +2358,7 @@ void UAdvancedMovementComponent::ExitSlide()
 #pragma region Wall Climbing
 bool UAdvancedMovementComponent::CanWallClimb() const
 {
-	if (!bUseWallClimbing) return false;
+	if (!UsesWallClimbing()) return false;
 	if (CurrentWallClimbDuration <= 0) return false;
 	if (JumpStartTime + WallClimbJumpInterval > Time) return false;
 	if ((bOrientRotationToMovement && PlayerInput.IsNearlyZero(0.1)) || (!bOrientRotationToMovement && PlayerInput.X <= 0.1)) return false;
@@ -2077,15 +2367,16 @@ bool UAdvancedMovementComponent::CanWallClimb() const
 
 bool UAdvancedMovementComponent::TryingToClimbWall(FVector WallNormal) const
 {
-	const float PlayerAngle = 180 - UKismetMathLibrary::DegAcos(WallNormal.Dot(UpdatedComponent->GetForwardVector()));
-	if (bOrientRotationToMovement) return WallClimbAcceptableAngle * 0.64 > PlayerAngle;
-	else return WallClimbAcceptableAngle > PlayerAngle;
+	const float Dot = WallNormal.Dot(UpdatedComponent->GetForwardVector());
+	if (bOrientRotationToMovement) return DerivedParams.WallClimbOrientedTryMaxDot > Dot;
+	else return DerivedParams.WallClimbMaxDot > Dot;
 }
 
 
 void UAdvancedMovementComponent::EnterWallClimb(EMovementMode PrevMode, ECustomMovementMode PrevCustomMode)
 {
 	WallClimbStartTime = Time;
+	ResetWallClimbFloorGate();
 }
 
 
@@ -2128,6 +2419,47 @@ void UAdvancedMovementComponent::ResetWallClimbInterval()
 		CurrentWallClimbDuration = WallClimbDuration;
 	}
 }
+
+
+bool UAdvancedMovementComponent::ShouldCheckWallClimbFloor() const
+{
+#if ADVANCED_MOVEMENT_WITH_WALL_CLIMBING
+	if (!bUseWallClimbFloorGate || !WallClimbFloorCheckLocation.IsSet() || !UpdatedComponent || !CharacterOwner) return true;
+
+	// The character is moving down, or touched something it could stand on
+	if (Velocity.Z <= 0 || bWallClimbHitWalkableSurface) return true;
+
+	// The character has moved down or over something else since the last check
+	const FVector Location = UpdatedComponent->GetComponentLocation();
+	if (Location.Z < WallClimbFloorCheckLocation->Z) return true;
+	if (FVector::DistSquared2D(Location, WallClimbFloorCheckLocation.GetValue()) > FMath::Square(CharacterOwner->GetCapsuleComponent()->GetScaledCapsuleRadius())) return true;
+
+	// The character is still within step distance of the walkable floor that the last check found
+	if (WallClimbFloorZ.IsSet() && Location.Z - WallClimbFloorZ.GetValue() <= MaxStepHeight) return true;
+
+	return false;
+#else
+	return true;
+#endif
+}
+
+
+void UAdvancedMovementComponent::ResetWallClimbFloorGate()
+{
+#if ADVANCED_MOVEMENT_WITH_WALL_CLIMBING
+	WallClimbFloorCheckLocation.Reset();
+	WallClimbFloorZ.Reset();
+	bWallClimbHitWalkableSurface = false;
+#endif
+}
+
+
+void UAdvancedMovementComponent::SaveWallClimbHit(const FHitResult& Hit)
+{
+#if ADVANCED_MOVEMENT_WITH_WALL_CLIMBING
+	if (Hit.IsValidBlockingHit() && IsWalkable(Hit)) bWallClimbHitWalkableSurface = true;
+#endif
+}
 #pragma endregion 
 
 
@@ -2138,7 +2470,10 @@ void UAdvancedMovementComponent::ResetWallClimbInterval()
 #pragma region Mantling
 bool UAdvancedMovementComponent::CheckIfSafeToMantleLedge()
 {
-	if (!bUseMantling) return false;
+#if ADVANCED_MOVEMENT_WITH_MANTLING
+	ADVANCED_MOVEMENT_SCOPE_CYCLE_COUNTER(CheckIfSafeToMantleLedge);
+
+	if (!UsesMantling()) return false;
 	if (!UpdatedComponent || !GetWorld() || !CharacterOwner || !CharacterOwner->GetCapsuleComponent()) return false;
 
 	float CharacterRadius = CharacterOwner->GetCapsuleComponent()->GetScaledCapsuleRadius();
@@ -2148,94 +2483,127 @@ bool UAdvancedMovementComponent::CheckIfSafeToMantleLedge()
 	float CrouchHalfHeight = GetCrouchedHalfHeight();
 	float CrouchDifference = CharacterHalfHeight - CrouchHalfHeight;
 	
-	TArray<AActor*> CharacterActors; 
-	CharacterOwner->GetAllChildActors(CharacterActors); // TODO: Investigate if this includes player spawned actors
-	CharacterActors.AddUnique(CharacterOwner);
+	const FCollisionObjectQueryParams ObjectParams(MantleObjects);
+	const FCollisionQueryParams QueryParams = GetMovementQueryParams(SCENE_QUERY_STAT(AdvancedMovementMantle));
+	const FCollisionShape CharacterSphere = FCollisionShape::MakeSphere(CharacterRadius);
 	
-	// Search for a wall
+	// Search for a wall. This is also the mantle check's early out, without a wall in front of the character it's the only query (or none if the mantle probe already missed)
 	FVector InitialTraceStart = UpdatedComponent->GetComponentLocation() - FVector(0, 0, MantleTraceHeightOffset);
 	FVector InitialTraceEnd = InitialTraceStart + UpdatedComponent->GetForwardVector() * MantleTraceDistance;
 	// if (MantleWallNormal.IsNearlyZero()) InitialTraceEnd = InitialTraceStart + UpdatedComponent->GetForwardVector() * MantleTraceDistance;
 	// else InitialTraceEnd = InitialTraceStart + (-MantleWallNormal * MantleTraceDistance);
 	
-	FHitResult Wall;
-	UKismetSystemLibrary::LineTraceSingleForObjects(
-		GetWorld(), InitialTraceStart, InitialTraceEnd,
-		MantleObjects,false, CharacterActors,
-		bDebugMantleAndClimbTrace ? EDrawDebugTrace::ForDuration : EDrawDebugTrace::None,
-		Wall,true, FColor::Emerald, FColor::Red, TraceDuration
-	);
-	if (!Wall.IsValidBlockingHit())
+	// The async probe from the previous tick already found that there isn't anything to mantle here
+	if (MantleProbeFoundNoLedge(InitialTraceStart, InitialTraceEnd))
 	{
 		return false;
 	}
 
-	// Search for a valid ledge
-	const FVector LedgeSurfaceEnd = Wall.Location + (-Wall.Normal * MantleSurfaceTraceFromLedgeOffset);
-	const FVector LedgeSurfaceStart = LedgeSurfaceEnd + FVector(0, 0, MantleSecondTraceDistance);
-	FHitResult Ledge;
-	UKismetSystemLibrary::LineTraceSingleForObjects(
-		GetWorld(), LedgeSurfaceStart, LedgeSurfaceEnd,
-		MantleObjects, false, CharacterActors,
-		bDebugMantleAndClimbTrace ? EDrawDebugTrace::ForDuration : EDrawDebugTrace::None,
-		Ledge, true, FColor::Emerald, FColor::Red, TraceDuration
-	);
-	if (!Ledge.IsValidBlockingHit() || LedgeSurfaceStart.Equals(Ledge.ImpactPoint, 1))
+	FHitResult Wall;
+	AddSceneQuery(EAdvancedMovementQuerySource::Mantle, EAdvancedMovementQuery::LineTrace);
+	GetWorld()->LineTraceSingleByObjectType(Wall, InitialTraceStart, InitialTraceEnd, ObjectParams, QueryParams);
+	if (ADVANCED_MOVEMENT_DEBUG_ENABLED(bDebugMantleAndClimbTrace))
+	{
+		DrawDebugLineTraceSingle(GetWorld(), InitialTraceStart, InitialTraceEnd, EDrawDebugTrace::ForDuration, Wall.bBlockingHit, Wall, FColor::Emerald, FColor::Red, TraceDuration);
+	}
+	if (!Wall.IsValidBlockingHit())
 	{
 		return false;
 	}
+	MantleProbe.LastWallLocation = Wall.Location;
+	MantleProbe.LastWallNormal = Wall.Normal;
+
+	// Use the level's baked ledge instead of searching for one, but only if the wall trace hit the baked wall. Only static geometry is baked,
+	// so anything else in front of the wall (doors, movers, etc.) is hit first and the ledge is searched for with the ledge trace
+	FVector LedgeLocation;
+	const FVector WallNormal = Wall.Normal;
+	const FAdvancedMovementBakedLedge* BakedLedge = nullptr;
+	const UAdvancedMovementLedgeDatabase* LedgeDatabase = bUseLedgeDatabase ? GetLedgeDatabase() : nullptr;
+	float WallDistance = 0;
+	if (LedgeDatabase) BakedLedge = LedgeDatabase->FindLedge(InitialTraceStart, InitialTraceEnd, WallDistance);
+	if (BakedLedge && (FMath::Abs(Wall.Distance - WallDistance) > BakedLedgeWallTolerance || !Wall.Normal.Equals(BakedLedge->WallNormal, 0.01)))
+	{
+		BakedLedge = nullptr;
+	}
+	
+	if (BakedLedge)
+	{
+		// The ledge is where the ledge trace would hit it from this wall
+		LedgeLocation = Wall.Location + (-WallNormal * MantleSurfaceTraceFromLedgeOffset);
+		LedgeLocation.Z = BakedLedge->LedgeLocation.Z;
+		INC_DWORD_STAT(STAT_AdvancedMovement_BakedLedgesUsed);
+	}
+	else
+	{
+		// Search for a valid ledge
+		const FVector LedgeSurfaceEnd = Wall.Location + (-Wall.Normal * MantleSurfaceTraceFromLedgeOffset);
+		const FVector LedgeSurfaceStart = LedgeSurfaceEnd + FVector(0, 0, MantleSecondTraceDistance);
+		FHitResult Ledge;
+		AddSceneQuery(EAdvancedMovementQuerySource::Mantle, EAdvancedMovementQuery::LineTrace);
+		GetWorld()->LineTraceSingleByObjectType(Ledge, LedgeSurfaceStart, LedgeSurfaceEnd, ObjectParams, QueryParams);
+		if (ADVANCED_MOVEMENT_DEBUG_ENABLED(bDebugMantleAndClimbTrace))
+		{
+			DrawDebugLineTraceSingle(GetWorld(), LedgeSurfaceStart, LedgeSurfaceEnd, EDrawDebugTrace::ForDuration, Ledge.bBlockingHit, Ledge, FColor::Emerald, FColor::Red, TraceDuration);
+		}
+		if (!Ledge.IsValidBlockingHit() || LedgeSurfaceStart.Equals(Ledge.ImpactPoint, 1))
+		{
+			return false;
+		}
+
+		LedgeLocation = Ledge.Location;
+	}
 	
 	// Check if the player is able to climb to it, and if they have to crouch
-	FVector FrontOfLedgeMidpoint = Ledge.Location - (-Wall.Normal * (MantleSurfaceTraceFromLedgeOffset + CharacterRadius + ClimbLocationSpaceOffset)) + FVector(0, 0, MantleTraceHeightOffset + CharacterHemisphereHeight);
+	FVector FrontOfLedgeMidpoint = LedgeLocation - (-WallNormal * (MantleSurfaceTraceFromLedgeOffset + CharacterRadius + ClimbLocationSpaceOffset)) + FVector(0, 0, MantleTraceHeightOffset + CharacterHemisphereHeight);
 	FVector ClimbStart = FrontOfLedgeMidpoint + (FVector(0, 0, (CharacterHalfHeightNoHemisphere - CrouchDifference) * 2)) - FVector(0, 0, MantleTraceHeightOffset);
 	FVector ClimbEnd = FVector(ClimbStart.X, ClimbStart.Y, UpdatedComponent->GetComponentLocation().Z + MantleTraceHeightOffset - CharacterHalfHeightNoHemisphere);
 	FHitResult ClimbSpace;
-	UKismetSystemLibrary::SphereTraceSingleForObjects(
-		GetWorld(), ClimbStart, ClimbEnd, CharacterRadius,
-		MantleObjects, false, CharacterActors,
-		bDebugMantleAndClimbTrace ? EDrawDebugTrace::ForDuration : EDrawDebugTrace::None,
-		ClimbSpace, true, FColor::Turquoise, FColor::Red, TraceDuration
-	);
+	AddSceneQuery(EAdvancedMovementQuerySource::Mantle, EAdvancedMovementQuery::SphereTrace);
+	GetWorld()->SweepSingleByObjectType(ClimbSpace, ClimbStart, ClimbEnd, FQuat::Identity, ObjectParams, CharacterSphere, QueryParams);
+	if (ADVANCED_MOVEMENT_DEBUG_ENABLED(bDebugMantleAndClimbTrace))
+	{
+		DrawDebugSphereTraceSingle(GetWorld(), ClimbStart, ClimbEnd, CharacterRadius, EDrawDebugTrace::ForDuration, ClimbSpace.bBlockingHit, ClimbSpace, FColor::Turquoise, FColor::Red, TraceDuration);
+	}
 	if (ClimbSpace.IsValidBlockingHit())
 	{
 		return false;
 	}
 	
 	// Check if they're able to walk on the ledge
-	FVector LedgeWalkStart = Ledge.Location + FVector(0, 0, MantleTraceHeightOffset + CharacterHemisphereHeight);
+	FVector LedgeWalkStart = LedgeLocation + FVector(0, 0, MantleTraceHeightOffset + CharacterHemisphereHeight);
 	FVector LedgeWalkEnd = LedgeWalkStart + FVector(0, 0, CharacterHalfHeightNoHemisphere * 2);
 	FHitResult LedgeRoom;
-	UKismetSystemLibrary::SphereTraceSingleForObjects(
-		GetWorld(), LedgeWalkStart, LedgeWalkEnd, CharacterRadius,
-		MantleObjects, false, CharacterActors,
-		bDebugMantleAndClimbTrace ? EDrawDebugTrace::ForDuration : EDrawDebugTrace::None,
-		LedgeRoom, true, FColor::Emerald, FColor::Emerald,TraceDuration
-	);
+	AddSceneQuery(EAdvancedMovementQuerySource::Mantle, EAdvancedMovementQuery::SphereTrace);
+	GetWorld()->SweepSingleByObjectType(LedgeRoom, LedgeWalkStart, LedgeWalkEnd, FQuat::Identity, ObjectParams, CharacterSphere, QueryParams);
+	if (ADVANCED_MOVEMENT_DEBUG_ENABLED(bDebugMantleAndClimbTrace))
+	{
+		DrawDebugSphereTraceSingle(GetWorld(), LedgeWalkStart, LedgeWalkEnd, CharacterRadius, EDrawDebugTrace::ForDuration, LedgeRoom.bBlockingHit, LedgeRoom, FColor::Emerald, FColor::Emerald, TraceDuration);
+	}
 	if (LedgeRoom.IsValidBlockingHit())
 	{
 		LedgeWalkEnd -= FVector(0, 0, CrouchDifference * 2);
-		UKismetSystemLibrary::SphereTraceSingleForObjects(
-			GetWorld(), LedgeWalkStart, LedgeWalkEnd, CharacterRadius,
-			MantleObjects, false, CharacterActors,
-			bDebugMantleAndClimbTrace ? EDrawDebugTrace::ForDuration : EDrawDebugTrace::None,
-			LedgeRoom, true, FColor::Emerald, FColor::Red,TraceDuration
-		);
+		AddSceneQuery(EAdvancedMovementQuerySource::Mantle, EAdvancedMovementQuery::SphereTrace);
+		GetWorld()->SweepSingleByObjectType(LedgeRoom, LedgeWalkStart, LedgeWalkEnd, FQuat::Identity, ObjectParams, CharacterSphere, QueryParams);
+		if (ADVANCED_MOVEMENT_DEBUG_ENABLED(bDebugMantleAndClimbTrace))
+		{
+			DrawDebugSphereTraceSingle(GetWorld(), LedgeWalkStart, LedgeWalkEnd, CharacterRadius, EDrawDebugTrace::ForDuration, LedgeRoom.bBlockingHit, LedgeRoom, FColor::Emerald, FColor::Red, TraceDuration);
+		}
 
 		if (LedgeRoom.IsValidBlockingHit())
 		{
 			return false;
 		}
-		
+	
 		bCrouchedLedgeClimb = true;
 	}
 
 	// Calculate the mantle location
-	LedgeClimbLocation = Ledge.Location;
-	LedgeClimbNormal = Wall.Normal;
+	LedgeClimbLocation = LedgeLocation;
+	LedgeClimbNormal = WallNormal;
 	MantleLedgeLocation = LedgeClimbLocation
-		- -Wall.Normal * (MantleSurfaceTraceFromLedgeOffset + CharacterRadius + ClimbLocationSpaceOffset + MantleLocationSpaceOffset)
+		- -WallNormal * (MantleSurfaceTraceFromLedgeOffset + CharacterRadius + ClimbLocationSpaceOffset + MantleLocationSpaceOffset)
 		+ FVector(0, 0, MantleLedgeLocationOffset);
-	if (bDebugMantleAndClimbTrace)
+	if (ADVANCED_MOVEMENT_DEBUG_ENABLED(bDebugMantleAndClimbTrace))
 	{
 		DrawDebugCapsule(
 			GetWorld(),
@@ -2257,76 +2625,252 @@ bool UAdvancedMovementComponent::CheckIfSafeToMantleLedge()
 	else ClimbType = EClimbType::Normal;
 	
 	return true;
+#else
+	return false;
+#endif
 }
 
 
 FVector UAdvancedMovementComponent::MantleAndClimbInterp(const float DeltaTime, const FVector StartLocation, const FVector TargetLocation, const FVector CurrentLocation, const float Speed, UCurveFloat* SpeedAdjustments) const
 {
-	// Find the interp direction
-	const FVector MovementVector = TargetLocation - CurrentLocation;
-	const FVector MovementDirection = MovementVector.GetSafeNormal();
-
 	// Use speed adjustments to create your own ease in transitions
-	const float CurrentPercent = MovementVector.Size() / (TargetLocation - StartLocation).Size(); // 0-1
-	const float InterpSpeedAdjustments = SpeedAdjustments ? FMath::Clamp(SpeedAdjustments->GetFloatValue(CurrentPercent * 10), 0.1, 10) : 1;
+	const float CurrentPercent = AdvancedMovementMath::GetInterpRemaining(StartLocation, TargetLocation, CurrentLocation); // 0-1
+	const float InterpSpeedAdjustments = EvaluateSpeedCurve(SpeedAdjustments, CurrentPercent);
 
-	const FVector Adjusted = MovementDirection * Speed * InterpSpeedAdjustments * DeltaTime;
-	if (Adjusted.Size() > MovementVector.Size()) return MovementVector;
-	return Adjusted;
+	return AdvancedMovementMath::GetInterpStep(TargetLocation, CurrentLocation, Speed, InterpSpeedAdjustments, DeltaTime);
 }
 
 
-void UAdvancedMovementComponent::EnterMantle(EMovementMode PrevMode, ECustomMovementMode PrevCustomMode)
+FVector UAdvancedMovementComponent::MantleAndClimbInterpBaked(const float DeltaTime, const FVector& TargetLocation, const FVector& CurrentLocation, const float InvDistance, const float Speed, const UCurveFloat* SpeedAdjustments) const
 {
-	MantleStartTime = Time;
-	MantleStartLocation = UpdatedComponent->GetComponentLocation();
-}
-
+	const float CurrentPercent = AdvancedMovementMath::GetInterpRemaining(TargetLocation, CurrentLocation, InvDistance); // 0-1
+	const float InterpSpeedAdjustments = EvaluateSpeedCurve(SpeedAdjustments, CurrentPercent);
 
-void UAdvancedMovementComponent::ExitMantle()
-{
-	MantleStartTime = 0;
-	MantleStartLocation = FVector();
-	MantleLedgeLocation = FVector();
-	
-	// This prevents the wall jump from being redirected if they wall jump out of a wall climb or a mantle 
-	PreviousGroundLocation = UpdatedComponent->GetComponentLocation() + PrevWallClimbNormal * 100;
+	return AdvancedMovementMath::GetInterpStep(TargetLocation, CurrentLocation, Speed, InterpSpeedAdjustments, DeltaTime);
 }
 
 
-void UAdvancedMovementComponent::EnterLedgeClimb(EMovementMode PrevMode, ECustomMovementMode PrevCustomMode)
+void UAdvancedMovementComponent::BakeSpeedCurves()
 {
-	LedgeClimbStartTime = Time;
-	LedgeClimbStartLocation = UpdatedComponent->GetComponentLocation();
+#if WITH_EDITOR
+	UnbindSpeedCurves();
+#endif
+	SpeedCurveTables.Reset();
 
-	// Adjust the collision during ledge climbs
-	if (CharacterOwner->GetCapsuleComponent())
+	TArray<const UCurveFloat*, TInlineAllocator<8>> Curves = { MantleSpeedAdjustments, MantleRotationSpeedAdjustments };
+	for (const TPair<EClimbType, FLedgeClimbInformation>& Variation : LedgeClimbVariations)
 	{
-		CapturedCollisionResponsesOutsideOfLedgeClimbing = CharacterOwner->GetCapsuleComponent()->GetCollisionResponseToChannels();
-		CharacterOwner->GetCapsuleComponent()->SetCollisionResponseToChannels(CollisionResponsesDuringLedgeClimbing);
+		Curves.Add(Variation.Value.SpeedAdjustments);
 	}
 
-	// Find the speed and easing adjustments from the list of ledge climb variations
-	if (LedgeClimbVariations.Contains(ClimbType))
+	for (const UCurveFloat* Curve : Curves)
 	{
-		CurrentClimbSpeed = LedgeClimbVariations[ClimbType].InterpSpeed;
-		CurrentClimbSpeedAdjustments = LedgeClimbVariations[ClimbType].SpeedAdjustments;
+		if (!Curve || SpeedCurveTables.Contains(Curve)) continue;
+		BakeSpeedCurve(Curve);
+		
+#if WITH_EDITOR
+		// Curves can be edited while playing in the editor, rebake their tables when they change
+		const_cast<UCurveFloat*>(Curve)->OnUpdateCurve.AddUObject(this, &UAdvancedMovementComponent::OnSpeedCurveUpdated);
+#endif
 	}
 }
 
 
-void UAdvancedMovementComponent::ExitLedgeClimb()
+void UAdvancedMovementComponent::BakeSpeedCurve(const UCurveFloat* Curve)
 {
-	LedgeClimbStartTime = 0;
-	LedgeClimbStartLocation = FVector();
-	LedgeClimbLocation = FVector();
-	LedgeClimbNormal = FVector();
+	// The curves are evaluated with the interp percent (0-1) * 10, and clamped to a valid speed
+	AdvancedMovementMath::FCurveTable& Table = SpeedCurveTables.FindOrAdd(Curve);
+	Table.Bake([Curve](const float CurveTime) { return FMath::Clamp(Curve->GetFloatValue(CurveTime), 0.1f, 10.f); }, 0, 10);
+}
 
-	// handle un crouching
-	if (bCrouchedLedgeClimb)
+
+#if WITH_EDITOR
+void UAdvancedMovementComponent::OnSpeedCurveUpdated(UCurveBase* Curve, EPropertyChangeType::Type ChangeType)
+{
+	const UCurveFloat* SpeedCurve = Cast<UCurveFloat>(Curve);
+	if (SpeedCurve && SpeedCurveTables.Contains(SpeedCurve)) BakeSpeedCurve(SpeedCurve);
+}
+
+
+void UAdvancedMovementComponent::UnbindSpeedCurves()
+{
+	for (const TPair<TObjectKey<UCurveFloat>, AdvancedMovementMath::FCurveTable>& SpeedCurveTable : SpeedCurveTables)
 	{
-		UnCrouch(false);
-		bCrouchedLedgeClimb = false;
+		if (UCurveFloat* Curve = SpeedCurveTable.Key.ResolveObjectPtr()) Curve->OnUpdateCurve.RemoveAll(this);
+	}
+}
+#endif
+
+
+const AdvancedMovementMath::FCurveTable* UAdvancedMovementComponent::FindSpeedCurveTable(const UCurveFloat* Curve) const
+{
+	if (!Curve) return nullptr;
+	return SpeedCurveTables.Find(Curve);
+}
+
+
+float UAdvancedMovementComponent::EvaluateSpeedCurve(const UCurveFloat* Curve, const float Percent) const
+{
+	if (!Curve) return 1;
+	if (const AdvancedMovementMath::FCurveTable* Table = FindSpeedCurveTable(Curve)) return Table->Evaluate(Percent * 10);
+	return FMath::Clamp(Curve->GetFloatValue(Percent * 10), 0.1, 10);
+}
+
+
+const UAdvancedMovementLedgeDatabase* UAdvancedMovementComponent::GetLedgeDatabase() const
+{
+	const UAdvancedMovementLedgeSubsystem* LedgeSubsystem = GetWorld() ? GetWorld()->GetSubsystem<UAdvancedMovementLedgeSubsystem>() : nullptr;
+	const UAdvancedMovementLedgeDatabase* LedgeDatabase = LedgeSubsystem ? LedgeSubsystem->GetDatabase() : nullptr;
+	if (!LedgeDatabase) return nullptr;
+
+	// This runs during the movement tick, so the mantle objects are compared in place instead of being copied into the settings
+	const FAdvancedMovementLedgeBakeSettings& BakedSettings = LedgeDatabase->GetSettings();
+	if (BakedSettings.MantleObjects != MantleObjects || !BakedSettings.EqualsIgnoringMantleObjects(GetLedgeBakeSettings(false)))
+	{
+		return nullptr;
+	}
+
+	return LedgeDatabase;
+}
+
+
+void UAdvancedMovementComponent::IssueMantleProbe(const float DeltaTime)
+{
+#if ADVANCED_MOVEMENT_WITH_MANTLING
+	MantleProbe.WallTrace.Invalidate();
+	MantleProbe.LedgeTrace.Invalidate();
+	UAdvancedMovementProbeSubsystem* ProbeSubsystem = GetProbeSubsystem();
+	if (!UsesMantling() || !bUseAsyncMantleProbe || !UpdatedComponent || !ProbeSubsystem) return;
+
+	// Mantles are checked while wall climbing, and falling into a wall transitions to wall climbing
+	const bool bFallingTowardsWall = UsesWallClimbing() && IsFalling() && PlayerInput.X > 0 && Velocity.Dot(UpdatedComponent->GetForwardVector()) >= 0;
+	if (!IsCustomMovementMode(MOVE_Custom_WallClimbing) && !bFallingTowardsWall) return;
+	
+	const FCollisionObjectQueryParams ObjectParams(MantleObjects);
+	const FCollisionQueryParams QueryParams = GetMovementQueryParams(SCENE_QUERY_STAT(AdvancedMovementMantleProbe));
+
+	// Trace from where the character should be when it checks for a ledge during the next tick
+	MantleProbe.TraceStart = UpdatedComponent->GetComponentLocation() + Velocity * DeltaTime - FVector(0, 0, MantleTraceHeightOffset);
+	MantleProbe.TraceEnd = MantleProbe.TraceStart + UpdatedComponent->GetForwardVector() * MantleTraceDistance;
+	AddSceneQuery(EAdvancedMovementQuerySource::Mantle, EAdvancedMovementQuery::LineTrace);
+	MantleProbe.WallTrace = ProbeSubsystem->AddLineTraceByObjectType(MantleProbe.TraceStart, MantleProbe.TraceEnd, ObjectParams, QueryParams);
+
+	// If the character is already against a wall, find where the trace will hit it and check for a ledge above that
+	const FVector TraceDirection = (MantleProbe.TraceEnd - MantleProbe.TraceStart).GetSafeNormal();
+	const float Approach = TraceDirection.Dot(MantleProbe.LastWallNormal);
+	if (Approach > -UE_KINDA_SMALL_NUMBER) return;
+	
+	const float WallDistance = (MantleProbe.LastWallLocation - MantleProbe.TraceStart).Dot(MantleProbe.LastWallNormal) / Approach;
+	if (WallDistance < 0 || WallDistance > MantleTraceDistance) return;
+
+	MantleProbe.PredictedWallLocation = MantleProbe.TraceStart + TraceDirection * WallDistance;
+	MantleProbe.PredictedWallNormal = MantleProbe.LastWallNormal;
+	const FVector LedgeSurfaceEnd = MantleProbe.PredictedWallLocation + (-MantleProbe.PredictedWallNormal * MantleSurfaceTraceFromLedgeOffset);
+	const FVector LedgeSurfaceStart = LedgeSurfaceEnd + FVector(0, 0, MantleSecondTraceDistance);
+	AddSceneQuery(EAdvancedMovementQuerySource::Mantle, EAdvancedMovementQuery::LineTrace);
+	MantleProbe.LedgeTrace = ProbeSubsystem->AddLineTraceByObjectType(LedgeSurfaceStart, LedgeSurfaceEnd, ObjectParams, QueryParams);
+#endif
+}
+
+
+bool UAdvancedMovementComponent::MantleProbeFoundNoLedge(const FVector& TraceStart, const FVector& TraceEnd)
+{
+#if ADVANCED_MOVEMENT_WITH_MANTLING
+	const UAdvancedMovementProbeSubsystem* ProbeSubsystem = GetProbeSubsystem();
+	if (!bUseAsyncMantleProbe || !MantleProbe.WallTrace.IsValid() || !ProbeSubsystem) return false;
+
+	// Only use the probe if the character is where it was predicted to be
+	const float Tolerance = FMath::Square(LookAheadProbeTolerance);
+	if (FVector::DistSquared(TraceStart, MantleProbe.TraceStart) > Tolerance || FVector::DistSquared(TraceEnd, MantleProbe.TraceEnd) > Tolerance) return false;
+
+	// The results are available the tick after the traces were issued
+	const FAdvancedMovementProbe* WallTrace = ProbeSubsystem->GetResult(MantleProbe.WallTrace);
+	if (!WallTrace) return false;
+	
+	const FHitResult& Wall = WallTrace->Hit;
+	if (!Wall.IsValidBlockingHit())
+	{
+		INC_DWORD_STAT(STAT_AdvancedMovement_MantleProbesUsed);
+		return true;
+	}
+	MantleProbe.LastWallLocation = Wall.Location;
+	MantleProbe.LastWallNormal = Wall.Normal;
+
+	// The ledge trace is only valid if the wall is where it was predicted to be
+	const FAdvancedMovementProbe* LedgeTrace = ProbeSubsystem->GetResult(MantleProbe.LedgeTrace);
+	if (!LedgeTrace
+		|| FVector::DistSquared(Wall.Location, MantleProbe.PredictedWallLocation) > Tolerance
+		|| !Wall.Normal.Equals(MantleProbe.PredictedWallNormal, 0.01))
+	{
+		return false;
+	}
+
+	// The ledge trace starts inside of the wall or didn't find a surface, valid ledges are confirmed with the regular mantle traces
+	const FHitResult& Ledge = LedgeTrace->Hit;
+	if (!Ledge.IsValidBlockingHit() || Ledge.bStartPenetrating || Ledge.Time <= 0)
+	{
+		INC_DWORD_STAT(STAT_AdvancedMovement_MantleProbesUsed);
+		return true;
+	}
+
+	return false;
+#else
+	return false;
+#endif
+}
+
+
+void UAdvancedMovementComponent::EnterMantle(EMovementMode PrevMode, ECustomMovementMode PrevCustomMode)
+{
+	MantleStartTime = Time;
+	MantleStartLocation = UpdatedComponent->GetComponentLocation();
+}
+
+
+void UAdvancedMovementComponent::ExitMantle()
+{
+	MantleStartTime = 0;
+	MantleStartLocation = FVector();
+	MantleLedgeLocation = FVector();
+	
+	// This prevents the wall jump from being redirected if they wall jump out of a wall climb or a mantle 
+	PreviousGroundLocation = UpdatedComponent->GetComponentLocation() + PrevWallClimbNormal * 100;
+}
+
+
+void UAdvancedMovementComponent::EnterLedgeClimb(EMovementMode PrevMode, ECustomMovementMode PrevCustomMode)
+{
+	LedgeClimbStartTime = Time;
+	LedgeClimbStartLocation = UpdatedComponent->GetComponentLocation();
+
+	// Adjust the collision during ledge climbs
+	if (CharacterOwner->GetCapsuleComponent())
+	{
+		CapturedCollisionResponsesOutsideOfLedgeClimbing = CharacterOwner->GetCapsuleComponent()->GetCollisionResponseToChannels();
+		CharacterOwner->GetCapsuleComponent()->SetCollisionResponseToChannels(CollisionResponsesDuringLedgeClimbing);
+	}
+
+	// Find the speed and easing adjustments from the list of ledge climb variations
+	if (const FLedgeClimbInformation* Variation = DerivedParams.FindClimbVariation(ClimbType))
+	{
+		CurrentClimbSpeed = Variation->InterpSpeed;
+		CurrentClimbSpeedAdjustments = Variation->SpeedAdjustments;
+	}
+}
+
+
+void UAdvancedMovementComponent::ExitLedgeClimb()
+{
+	LedgeClimbStartTime = 0;
+	LedgeClimbStartLocation = FVector();
+	LedgeClimbLocation = FVector();
+	LedgeClimbNormal = FVector();
+
+	// handle un crouching
+	if (bCrouchedLedgeClimb)
+	{
+		UnCrouch(false);
+		bCrouchedLedgeClimb = false;
 	}
 
 	// Reset ledge climb network information
@@ -2355,7 +2899,7 @@ void UAdvancedMovementComponent::ExitLedgeClimb()
 #pragma region Wall Running
 bool UAdvancedMovementComponent::CanWallRun(const FHitResult& Wall) const
 {
-	if (!bUseWallRunning) return false;
+	if (!UsesWallRunning()) return false;
 	if (PlayerInput.Y < 0.1 && PlayerInput.Y > -0.1) return false;
 
 	// If it's the same wall, it needs to be at a lower height
@@ -2374,10 +2918,7 @@ bool UAdvancedMovementComponent::CanWallRun(const FHitResult& Wall) const
 	if (WallRunSpeedThreshold >= PerpendicularSpeed) return false;
 	
 	// Check that the player is trying to run alongside the wall
-	const float Angle = 180 - UKismetMathLibrary::DegAcos(Wall.Normal.Dot(UpdatedComponent->GetForwardVector()));
-	if (90 - WallRunAcceptableAngleRadius > Angle) return false;
-	if (90 + WallRunAcceptableAngleRadius < Angle) return false;
-	return true;
+	return FMath::Abs(Wall.Normal.Dot(UpdatedComponent->GetForwardVector())) <= DerivedParams.WallRunMaxDot;
 }
 
 void UAdvancedMovementComponent::EnterWallRun(EMovementMode PrevMode, ECustomMovementMode PrevCustomMode)
@@ -2385,10 +2926,14 @@ void UAdvancedMovementComponent::EnterWallRun(EMovementMode PrevMode, ECustomMov
 	WallRunCurrentSpeed = WallRunSpeed > Velocity.Size2D() ? WallRunSpeed : Velocity.Size2D();
 	WallRunInputDirection = PlayerInput.Y;
 	WallRunStartTime = Time;
+	UpdateWallRunContact(WallRunWall, WallRunNormal);
 }
 
 void UAdvancedMovementComponent::ExitWallRun()
 {
+#if ADVANCED_MOVEMENT_WITH_WALL_RUNNING
+	WallRunContact.ValidUntil = 0;
+#endif
 }
 
 void UAdvancedMovementComponent::ResetWallRunInformation(EMovementMode PrevMode, uint8 PrevCustomMode)
@@ -2401,6 +2946,45 @@ void UAdvancedMovementComponent::ResetWallRunInformation(EMovementMode PrevMode,
 		WallRunNormal = FVector();
 	}
 }
+
+void UAdvancedMovementComponent::UpdateWallRunContact(UPrimitiveComponent* Wall, const FVector& Normal)
+{
+#if ADVANCED_MOVEMENT_WITH_WALL_RUNNING
+	if (!UpdatedComponent) return;
+	INC_DWORD_STAT(STAT_AdvancedMovement_WallRunContactUpdates);
+
+	// The tangent is based on the surface instead of the wall's rotation, which isn't aligned with the surface on merged meshes
+	WallRunContact.Wall = Wall;
+	WallRunContact.Normal = Normal;
+	WallRunContact.Location = UpdatedComponent->GetComponentLocation();
+	WallRunContact.Tangent = FVector::CrossProduct(Normal, FVector::UpVector).GetSafeNormal2D();
+	WallRunContact.ValidUntil = WallRunStartTime + WallRunDuration;
+#endif
+}
+
+bool UAdvancedMovementComponent::IsWallRunContactValid() const
+{
+#if ADVANCED_MOVEMENT_WITH_WALL_RUNNING
+	if (!UpdatedComponent || Time > WallRunContact.ValidUntil || WallRunContact.Tangent.IsNearlyZero()) return false;
+	if (WallRunContact.Wall.Get() != WallRunWall) return false;
+
+	const float PlaneDistance = (UpdatedComponent->GetComponentLocation() - WallRunContact.Location).Dot(WallRunContact.Normal);
+	return FMath::Abs(PlaneDistance) <= WallRunContactTolerance;
+#else
+	return false;
+#endif
+}
+
+bool UAdvancedMovementComponent::WallRunContactChanged(const FHitResult& Hit) const
+{
+#if ADVANCED_MOVEMENT_WITH_WALL_RUNNING
+	if (!IsWallRunContactValid()) return true;
+	if (Hit.GetComponent() != WallRunContact.Wall.Get()) return true;
+	return Hit.Normal.Dot(WallRunContact.Normal) < DerivedParams.WallRunContactMinDot;
+#else
+	return true;
+#endif
+}
 #pragma endregion 
 
 
@@ -2490,19 +3074,40 @@ bool UAdvancedMovementComponent::FMSavedMove::CanCombineWith(const FSavedMovePtr
 
 bool UAdvancedMovementComponent::FMCharacterNetworkMoveData::Serialize(UCharacterMovementComponent& CharacterMovement, FArchive& Ar, UPackageMap* PackageMap, ENetworkMoveType MoveType)
 {
+	ADVANCED_MOVEMENT_SCOPE_CYCLE_COUNTER(SerializeMoveData);
+
 	Super::Serialize(CharacterMovement, Ar, PackageMap, MoveType);
-	const bool bIsSaving = Ar.IsSaving();
 	bool bLocalSuccess = true;
 
+	// Capture the custom move data's bandwidth from the archive's position. While the client is sending its moves the archive is the engine's server move bit writer,
+	// any other archive isn't measured
+	UAdvancedMovementComponent& MovementComponent = static_cast<UAdvancedMovementComponent&>(CharacterMovement);
+	const bool bMeasureBits = MovementComponent.bSerializingServerMove && Ar.IsSaving();
+	const int64 StartBits = bMeasureBits ? static_cast<FBitWriter&>(Ar).GetNumBits() : 0;
+
 	// Save move values
-	MoveData_Input.NetSerialize(Ar, PackageMap, bLocalSuccess); // TODO: Learn how to serialize things
-	SerializeOptionalValue<FVector_NetQuantize10>(bIsSaving, Ar, MoveData_LedgeClimbLocation, FVector_NetQuantize10::ZeroVector);
-	SerializeOptionalValue<FVector_NetQuantize10>(bIsSaving, Ar, MoveData_MantleLocation, FVector_NetQuantize10::ZeroVector);
+	SerializeCustomMoveData(Ar, PackageMap, bLocalSuccess);
+
+	if (bMeasureBits)
+	{
+		const int64 CustomBits = static_cast<FBitWriter&>(Ar).GetNumBits() - StartBits;
+		MovementComponent.NetworkStats.CustomMoveDataBits += CustomBits;
+		INC_DWORD_STAT_BY(STAT_AdvancedMovement_CustomMoveDataBits, CustomBits);
+	}
 	
 	return !Ar.IsError();
 }
 
 
+void UAdvancedMovementComponent::FMCharacterNetworkMoveData::SerializeCustomMoveData(FArchive& Ar, UPackageMap* PackageMap, bool& bOutSuccess)
+{
+	const bool bIsSaving = Ar.IsSaving();
+	MoveData_Input.NetSerialize(Ar, PackageMap, bOutSuccess); // TODO: Learn how to serialize things
+	SerializeOptionalValue<FVector_NetQuantize10>(bIsSaving, Ar, MoveData_LedgeClimbLocation, FVector_NetQuantize10::ZeroVector);
+	SerializeOptionalValue<FVector_NetQuantize10>(bIsSaving, Ar, MoveData_MantleLocation, FVector_NetQuantize10::ZeroVector);
+}
+
+
 
 
 //------------------------------------------------------------------------------//
@@ -2647,7 +3252,7 @@ bool UAdvancedMovementComponent::DoJump(bool bReplayingMoves)
 				Velocity.Z = FMath::Max<FVector::FReal>(Velocity.Z + 1.f, JumpZVelocity);
 			}
 			
-			if (bDebugWallJump)
+			if (ADVANCED_MOVEMENT_DEBUG_ENABLED(bDebugWallJump))
 			{
 				//UE_LOG(Movement, Warning, TEXT("%s() %s: Go, do a crime. new velocity: %s"), *FString(__FUNCTION__), *GetNameSafe(CharacterOwner), *Velocity.ToCompactString());
 				const FString JumpVariation = IsMantleJump() ? FString("MantleJump") : IsSliding() ? FString("SlideJump") : FString("");
@@ -2690,6 +3295,8 @@ bool UAdvancedMovementComponent::CanAttemptJump() const
 #pragma region Crouching
 void UAdvancedMovementComponent::Crouch(bool bClientSimulation)
 {
+	ADVANCED_MOVEMENT_SCOPE_CYCLE_COUNTER(Crouch);
+
 	// These are just overridden to add client side predicted replicated tags in safe to add areas
 	if (!HasValidData())
 	{
@@ -2739,6 +3346,7 @@ void UAdvancedMovementComponent::Crouch(bool bClientSimulation)
 			FCollisionQueryParams CapsuleParams(SCENE_QUERY_STAT(CrouchTrace), false, CharacterOwner);
 			FCollisionResponseParams ResponseParam;
 			InitCollisionParams(CapsuleParams, ResponseParam);
+			AddSceneQuery(EAdvancedMovementQuerySource::Crouch, EAdvancedMovementQuery::Overlap);
 			const bool bEnCrouched = GetWorld()->OverlapBlockingTestByChannel(UpdatedComponent->GetComponentLocation() - FVector(0.f,0.f,ScaledHalfHeightAdjust), FQuat::Identity,
 				UpdatedComponent->GetCollisionObjectType(), GetPawnCapsuleCollisionShape(SHRINK_None), CapsuleParams, ResponseParam);
 
@@ -2786,6 +3394,8 @@ void UAdvancedMovementComponent::Crouch(bool bClientSimulation)
 
 void UAdvancedMovementComponent::UnCrouch(bool bClientSimulation)
 {
+	ADVANCED_MOVEMENT_SCOPE_CYCLE_COUNTER(UnCrouch);
+
 	if (!HasValidData())
 	{
 		return;
@@ -2818,6 +3428,13 @@ void UAdvancedMovementComponent::UnCrouch(bool bClientSimulation)
 
 	if( !bClientSimulation )
 	{
+		// The character is still where it last failed to uncrouch
+		if (UnCrouchClearanceBlocked())
+		{
+			INC_DWORD_STAT(STAT_AdvancedMovement_UnCrouchClearanceCacheHits);
+			return;
+		}
+		
 		// Try to stay in place and see if the larger capsule fits. We use a slightly taller capsule to avoid penetration.
 		const UWorld* MyWorld = GetWorld();
 		const float SweepInflation = UE_KINDA_SMALL_NUMBER * 10.f;
@@ -2833,6 +3450,7 @@ void UAdvancedMovementComponent::UnCrouch(bool bClientSimulation)
 		if (!bCrouchMaintainsBaseLocation)
 		{
 			// Expand in place
+			AddSceneQuery(EAdvancedMovementQuerySource::UnCrouch, EAdvancedMovementQuery::Overlap);
 			bEncroached = MyWorld->OverlapBlockingTestByChannel(PawnLocation, FQuat::Identity, CollisionChannel, StandingCapsuleShape, CapsuleParams, ResponseParam);
 		
 			if (bEncroached)
@@ -2849,6 +3467,7 @@ void UAdvancedMovementComponent::UnCrouch(bool bClientSimulation)
 
 					FHitResult Hit(1.f);
 					const FCollisionShape ShortCapsuleShape = GetPawnCapsuleCollisionShape(SHRINK_HeightCustom, ShrinkHalfHeight);
+					AddSceneQuery(EAdvancedMovementQuerySource::UnCrouch, EAdvancedMovementQuery::Sweep);
 					const bool bBlockingHit = MyWorld->SweepSingleByChannel(Hit, PawnLocation, PawnLocation + Down, FQuat::Identity, CollisionChannel, ShortCapsuleShape, CapsuleParams);
 					if (Hit.bStartPenetrating)
 					{
@@ -2859,6 +3478,7 @@ void UAdvancedMovementComponent::UnCrouch(bool bClientSimulation)
 						// Compute where the base of the sweep ended up, and see if we can stand there
 						const float DistanceToBase = (Hit.Time * TraceDist) + ShortCapsuleShape.Capsule.HalfHeight;
 						const FVector NewLoc = FVector(PawnLocation.X, PawnLocation.Y, PawnLocation.Z - DistanceToBase + StandingCapsuleShape.Capsule.HalfHeight + SweepInflation + MIN_FLOOR_DIST / 2.f);
+						AddSceneQuery(EAdvancedMovementQuerySource::UnCrouch, EAdvancedMovementQuery::Overlap);
 						bEncroached = MyWorld->OverlapBlockingTestByChannel(NewLoc, FQuat::Identity, CollisionChannel, StandingCapsuleShape, CapsuleParams, ResponseParam);
 						if (!bEncroached)
 						{
@@ -2873,6 +3493,7 @@ void UAdvancedMovementComponent::UnCrouch(bool bClientSimulation)
 		{
 			// Expand while keeping base location the same.
 			FVector StandingLocation = PawnLocation + FVector(0.f, 0.f, StandingCapsuleShape.GetCapsuleHalfHeight() - CurrentCrouchedHalfHeight);
+			AddSceneQuery(EAdvancedMovementQuerySource::UnCrouch, EAdvancedMovementQuery::Overlap);
 			bEncroached = MyWorld->OverlapBlockingTestByChannel(StandingLocation, FQuat::Identity, CollisionChannel, StandingCapsuleShape, CapsuleParams, ResponseParam);
 
 			if (bEncroached)
@@ -2884,6 +3505,7 @@ void UAdvancedMovementComponent::UnCrouch(bool bClientSimulation)
 					if (CurrentFloor.bBlockingHit && CurrentFloor.FloorDist > MinFloorDist)
 					{
 						StandingLocation.Z -= CurrentFloor.FloorDist - MinFloorDist;
+						AddSceneQuery(EAdvancedMovementQuerySource::UnCrouch, EAdvancedMovementQuery::Overlap);
 						bEncroached = MyWorld->OverlapBlockingTestByChannel(StandingLocation, FQuat::Identity, CollisionChannel, StandingCapsuleShape, CapsuleParams, ResponseParam);
 					}
 				}				
@@ -2898,6 +3520,7 @@ void UAdvancedMovementComponent::UnCrouch(bool bClientSimulation)
 		}
 
 		// If still encroached then abort.
+		CacheUnCrouchClearance(bEncroached);
 		if (bEncroached)
 		{
 			return;
@@ -2931,6 +3554,40 @@ void UAdvancedMovementComponent::UnCrouch(bool bClientSimulation)
 }
 
 
+bool UAdvancedMovementComponent::UnCrouchClearanceBlocked() const
+{
+	if (!bUseUnCrouchClearanceCache || !UnCrouchClearance.bBlocked || !UpdatedComponent || !CharacterOwner) return false;
+	if (UnCrouchClearance.TestTime + UnCrouchClearanceRefreshInterval <= Time || UnCrouchClearance.TestTime > Time) return false;
+
+	// The character has moved, or its capsule or distance to the floor has changed
+	if (!UpdatedComponent->GetComponentLocation().Equals(UnCrouchClearance.Location, UnCrouchClearanceTolerance)) return false;
+	if (!FMath::IsNearlyEqual(CharacterOwner->GetCapsuleComponent()->GetScaledCapsuleHalfHeight(), UnCrouchClearance.CrouchedHalfHeight)) return false;
+	if (!FMath::IsNearlyEqual(CurrentFloor.bBlockingHit ? CurrentFloor.FloorDist : 0.f, UnCrouchClearance.FloorDistance, UnCrouchClearanceTolerance)) return false;
+
+	// The base has changed or moved
+	const UPrimitiveComponent* Base = GetMovementBase();
+	if (Base != UnCrouchClearance.Base.Get()) return false;
+	if (Base && !Base->GetComponentTransform().Equals(UnCrouchClearance.BaseTransform, UnCrouchClearanceTolerance)) return false;
+
+	return true;
+}
+
+
+void UAdvancedMovementComponent::CacheUnCrouchClearance(const bool bBlocked)
+{
+	UnCrouchClearance.bBlocked = bBlocked;
+	if (!bBlocked || !bUseUnCrouchClearanceCache || !UpdatedComponent || !CharacterOwner) return;
+
+	UPrimitiveComponent* Base = GetMovementBase();
+	UnCrouchClearance.Location = UpdatedComponent->GetComponentLocation();
+	UnCrouchClearance.CrouchedHalfHeight = CharacterOwner->GetCapsuleComponent()->GetScaledCapsuleHalfHeight();
+	UnCrouchClearance.FloorDistance = CurrentFloor.bBlockingHit ? CurrentFloor.FloorDist : 0.f;
+	UnCrouchClearance.Base = Base;
+	UnCrouchClearance.BaseTransform = Base ? Base->GetComponentTransform() : FTransform::Identity;
+	UnCrouchClearance.TestTime = Time;
+}
+
+
 void UAdvancedMovementComponent::HandleCrouchLogic()
 {
 	// BaseAbilitySystem = BaseAbilitySystem ? BaseAbilitySystem : GetAbilitySystem();
@@ -3056,6 +3713,27 @@ FVector UAdvancedMovementComponent::GetLedgeClimbNormal() const
 	return LedgeClimbNormal;
 }
 
+FAdvancedMovementLedgeBakeSettings UAdvancedMovementComponent::GetLedgeBakeSettings(const bool bIncludeMantleObjects) const
+{
+	FAdvancedMovementLedgeBakeSettings Settings;
+	Settings.CrouchedHalfHeight = GetCrouchedHalfHeight();
+	Settings.MantleTraceHeightOffset = MantleTraceHeightOffset;
+	Settings.MantleSurfaceTraceFromLedgeOffset = MantleSurfaceTraceFromLedgeOffset;
+	Settings.MantleSecondTraceDistance = MantleSecondTraceDistance;
+	if (bIncludeMantleObjects) Settings.MantleObjects = MantleObjects;
+
+	// Ledges are baked with a standing character, so the capsule's height comes from the character's defaults in case it's crouched
+	if (CharacterOwner && CharacterOwner->GetCapsuleComponent())
+	{
+		const UCapsuleComponent* Capsule = CharacterOwner->GetCapsuleComponent();
+		const ACharacter* DefaultCharacter = CharacterOwner->GetClass()->GetDefaultObject<ACharacter>();
+		Settings.CapsuleRadius = Capsule->GetScaledCapsuleRadius();
+		Settings.CapsuleHalfHeight = DefaultCharacter->GetCapsuleComponent()->GetUnscaledCapsuleHalfHeight() * Capsule->GetShapeScale();
+	}
+
+	return Settings;
+}
+
 FVector UAdvancedMovementComponent::GetWallJumpLocation() const
 {
 	return PrevWallJumpLocation;
@@ -3082,6 +3760,101 @@ void UAdvancedMovementComponent::SetMaxWalkSpeed(float Speed)
 }
 
 
+void UAdvancedMovementComponent::SetStrafingMaxAcceleration(const float Acceleration)
+{
+	StrafingMaxAcceleration = Acceleration;
+	RebuildDerivedParams();
+}
+
+
+void UAdvancedMovementComponent::SetAirStrafeSpeedGainMultiplier(const float Multiplier)
+{
+	AirStrafeSpeedGainMultiplier = Multiplier;
+	RebuildDerivedParams();
+}
+
+
+void UAdvancedMovementComponent::SetStrafeSwaySpeedGainMultiplier(const float Multiplier)
+{
+	StrafeSwaySpeedGainMultiplier = Multiplier;
+	RebuildDerivedParams();
+}
+
+
+void UAdvancedMovementComponent::SetWallClimbAcceptableAngle(const float Angle)
+{
+	WallClimbAcceptableAngle = Angle;
+	RebuildDerivedParams();
+}
+
+
+void UAdvancedMovementComponent::SetWallRunAcceptableAngleRadius(const float AngleRadius)
+{
+	WallRunAcceptableAngleRadius = AngleRadius;
+	RebuildDerivedParams();
+}
+
+
+void UAdvancedMovementComponent::SetWallRunContactAngleThreshold(const float Angle)
+{
+	WallRunContactAngleThreshold = Angle;
+	RebuildDerivedParams();
+}
+
+
+void UAdvancedMovementComponent::SetSlideEnterThreshold(const float Threshold)
+{
+	SlideEnterThreshold = Threshold;
+	RebuildDerivedParams();
+}
+
+
+void UAdvancedMovementComponent::SetWallJumpHeightFromGroundThreshold(const float Threshold)
+{
+	WallJumpHeightFromGroundThreshold = Threshold;
+	RebuildDerivedParams();
+}
+
+
+void UAdvancedMovementComponent::SetLedgeClimbVariations(const TMap<EClimbType, FLedgeClimbInformation>& Variations)
+{
+	LedgeClimbVariations = Variations;
+	BakeSpeedCurves();
+	RebuildDerivedParams();
+}
+
+
+void UAdvancedMovementComponent::RebuildDerivedParams()
+{
+	DerivedParams = FAdvancedMovementDerivedParams();
+
+	// Air strafing only happens while falling, where the max acceleration is the strafing acceleration
+	DerivedParams.AirStrafeSpeedCap = (StrafingMaxAcceleration / 100) * AirStrafeSpeedGainMultiplier;
+	DerivedParams.StrafeSwaySpeedCap = (StrafingMaxAcceleration / 100) * StrafeSwaySpeedGainMultiplier;
+
+	// The wall angle is 180 - acos(dot), so an angle greater than the limit is a dot greater than -cos(limit)
+	const auto GetWallAngleDot = [](const float Angle) { return -FMath::Cos(FMath::DegreesToRadians(FMath::Clamp(Angle, 0.f, 180.f))); };
+	DerivedParams.WallClimbMaxDot = GetWallAngleDot(WallClimbAcceptableAngle);
+	DerivedParams.WallClimbOrientedTryMaxDot = GetWallAngleDot(WallClimbAcceptableAngle * 0.64);
+
+	// The wall run range (90 - radius to 90 + radius) is a dot between -sin(radius) and sin(radius)
+	DerivedParams.WallRunMaxDot = FMath::Sin(FMath::DegreesToRadians(FMath::Clamp(WallRunAcceptableAngleRadius, 0.f, 90.f)));
+	DerivedParams.WallRunContactMinDot = FMath::Cos(FMath::DegreesToRadians(FMath::Clamp(WallRunContactAngleThreshold, 0.f, 180.f)));
+
+	DerivedParams.SlideEnterThresholdSquared = FMath::Square(FMath::Max(SlideEnterThreshold, 0.f));
+	DerivedParams.WallJumpHeightFromGroundThresholdSquared = FMath::Square(FMath::Max(WallJumpHeightFromGroundThreshold, 0.f));
+
+	for (const TPair<EClimbType, FLedgeClimbInformation>& Variation : LedgeClimbVariations)
+	{
+		const uint8 Index = static_cast<uint8>(Variation.Key);
+		if (Index >= static_cast<uint8>(EClimbType::None)) continue;
+		
+		DerivedParams.ClimbVariations[Index] = Variation.Value;
+		DerivedParams.bHasClimbVariation[Index] = true;
+	}
+}
+
+
 FVector UAdvancedMovementComponent::ComputeSlideVector(const FVector& Delta, const float HitTime, const FVector& Normal, const FHitResult& Hit) const
 {
 	FVector Result = Super::ComputeSlideVector(Delta, HitTime, Normal, Hit);
@@ -3142,9 +3915,9 @@ void UAdvancedMovementComponent::ResetGroundStateInformation(EMovementMode PrevM
 // }
 
 
-void UAdvancedMovementComponent::DebugGroundMovement(FString Message, FColor Color, bool DrawSphere)
+void UAdvancedMovementComponent::DebugGroundMovement(const TCHAR* Message, FColor Color, bool DrawSphere)
 {
-	if (!bDebugGroundMovement) return;
+	if (!ADVANCED_MOVEMENT_DEBUG_ENABLED(bDebugGroundMovement)) return;
 	GEngine->AddOnScreenDebugMessage(2, 10.f, Color, Message);
 	FVector Start = UpdatedComponent->GetComponentLocation();
 	FVector End = Start + CharacterOwner->GetCapsuleComponent()->GetScaledCapsuleHalfHeight() * 2.5f * FVector::DownVector;
@@ -3169,3 +3942,485 @@ FString UAdvancedMovementComponent::GetMovementDirection(const FVector2D& InputV
 	return Sideways > 0 ? FString("R") : FString("L");
 }
 #pragma endregion
+
+
+
+
+//------------------------------------------------------------------------------//
+// Profiling																	//
+//------------------------------------------------------------------------------//
+#pragma region Profiling
+void UAdvancedMovementComponent::ResetSceneQueryStats()
+{
+	SceneQueryStats.Reset();
+	PreviousTickSceneQueryStats.Reset();
+	TotalSceneQueryStats.Reset();
+	SceneQueryStatsTicks = 0;
+}
+
+
+void UAdvancedMovementComponent::DumpSceneQueryStats() const
+{
+	const uint32 Total = TotalSceneQueryStats.GetTotal();
+	UE_LOGFMT(Movement, Display, "{0} ({1}): {2} scene queries over {3} ticks ({4} per tick)",
+		*GetNameSafe(CharacterOwner),
+		CharacterOwner && CharacterOwner->HasAuthority() ? "Server" : "Client",
+		Total,
+		SceneQueryStatsTicks,
+		SceneQueryStatsTicks ? static_cast<float>(Total) / SceneQueryStatsTicks : 0.f
+	);
+	if (Total == 0) return;
+
+	auto GetQueryBreakdown = [](const uint32 (&Counts)[static_cast<uint8>(EAdvancedMovementQuery::MAX)])
+	{
+		FString Breakdown;
+		for (int32 Query = 0; Query < static_cast<int32>(EAdvancedMovementQuery::MAX); Query++)
+		{
+			if (!Counts[Query]) continue;
+			Breakdown += FString::Printf(TEXT("%s%s: %u"), Breakdown.IsEmpty() ? TEXT("") : TEXT(", "), FAdvancedMovementSceneQueryStats::GetQueryName(static_cast<EAdvancedMovementQuery>(Query)), Counts[Query]);
+		}
+		return Breakdown;
+	};
+	
+	for (int32 Mode = 0; Mode < static_cast<int32>(EAdvancedMovementPhysics::MAX); Mode++)
+	{
+		if (!TotalSceneQueryStats.GetModeTotal(static_cast<EAdvancedMovementPhysics>(Mode))) continue;
+		UE_LOGFMT(Movement, Display, "  Mode {0}: {1}", FAdvancedMovementPhysicsTimings::GetName(static_cast<EAdvancedMovementPhysics>(Mode)), *GetQueryBreakdown(TotalSceneQueryStats.ByMode[Mode]));
+	}
+	
+	for (int32 Source = 0; Source < static_cast<int32>(EAdvancedMovementQuerySource::MAX); Source++)
+	{
+		if (!TotalSceneQueryStats.GetSourceTotal(static_cast<EAdvancedMovementQuerySource>(Source))) continue;
+		UE_LOGFMT(Movement, Display, "  Feature {0}: {1}", FAdvancedMovementSceneQueryStats::GetSourceName(static_cast<EAdvancedMovementQuerySource>(Source)), *GetQueryBreakdown(TotalSceneQueryStats.BySource[Source]));
+	}
+}
+
+
+void UAdvancedMovementComponent::FlushSceneQueryStats()
+{
+	PreviousTickSceneQueryStats = SceneQueryStats;
+	TotalSceneQueryStats.Append(SceneQueryStats);
+	SceneQueryStats.Reset();
+	SceneQueryStatsTicks++;
+
+#if CSV_PROFILER
+	FCsvProfiler* CsvProfiler = FCsvProfiler::Get();
+	if (!CsvProfiler || !CsvProfiler->IsCapturing() || !PreviousTickSceneQueryStats.GetTotal()) return;
+
+	// The stats are accumulated across every movement component for the frame
+	static TArray<FName> QueryNames, SourceNames, ModeNames;
+	if (QueryNames.IsEmpty())
+	{
+		for (int32 Query = 0; Query < static_cast<int32>(EAdvancedMovementQuery::MAX); Query++) QueryNames.Add(FAdvancedMovementSceneQueryStats::GetQueryName(static_cast<EAdvancedMovementQuery>(Query)));
+		for (int32 Source = 0; Source < static_cast<int32>(EAdvancedMovementQuerySource::MAX); Source++) SourceNames.Add(FAdvancedMovementSceneQueryStats::GetSourceName(static_cast<EAdvancedMovementQuerySource>(Source)));
+		for (int32 Mode = 0; Mode < static_cast<int32>(EAdvancedMovementPhysics::MAX); Mode++) ModeNames.Add(FAdvancedMovementPhysicsTimings::GetName(static_cast<EAdvancedMovementPhysics>(Mode)));
+	}
+
+	const int32 CategoryIndex = CSV_CATEGORY_INDEX(AdvancedMovementQueries);
+	CSV_CUSTOM_STAT(AdvancedMovementQueries, Total, static_cast<int32>(PreviousTickSceneQueryStats.GetTotal()), ECsvCustomStatOp::Accumulate);
+	for (int32 Query = 0; Query < QueryNames.Num(); Query++)
+	{
+		const uint32 Count = PreviousTickSceneQueryStats.GetQueryTotal(static_cast<EAdvancedMovementQuery>(Query));
+		if (Count) FCsvProfiler::RecordCustomStat(QueryNames[Query], CategoryIndex, Count, ECsvCustomStatOp::Accumulate);
+	}
+	for (int32 Source = 0; Source < SourceNames.Num(); Source++)
+	{
+		const uint32 Count = PreviousTickSceneQueryStats.GetSourceTotal(static_cast<EAdvancedMovementQuerySource>(Source));
+		if (Count) FCsvProfiler::RecordCustomStat(SourceNames[Source], CategoryIndex, Count, ECsvCustomStatOp::Accumulate);
+	}
+	for (int32 Mode = 0; Mode < ModeNames.Num(); Mode++)
+	{
+		const uint32 Count = PreviousTickSceneQueryStats.GetModeTotal(static_cast<EAdvancedMovementPhysics>(Mode));
+		if (Count) FCsvProfiler::RecordCustomStat(ModeNames[Mode], CategoryIndex, Count, ECsvCustomStatOp::Accumulate);
+	}
+#endif
+}
+
+
+void UAdvancedMovementComponent::StartInputRecording()
+{
+	if (!CharacterOwner || !UpdatedComponent || !GetWorld()) return;
+
+	InputRecording = MakeUnique<FAdvancedMovementInputRecording>();
+	InputRecording->MapName = UWorld::RemovePIEPrefix(GetWorld()->GetOutermost()->GetName());
+	InputRecording->CharacterClassPath = CharacterOwner->GetClass()->GetPathName();
+	InputRecording->StartLocation = UpdatedComponent->GetComponentLocation();
+	InputRecording->StartRotation = UpdatedComponent->GetComponentRotation();
+	InputRecording->StartVelocity = Velocity;
+	InputRecording->StartMovementMode = MovementMode;
+	InputRecording->StartCustomMovementMode = CustomMovementMode;
+	UE_LOGFMT(Movement, Display, "{0}: Started recording inputs on {1}", *GetNameSafe(CharacterOwner), *InputRecording->MapName);
+}
+
+
+bool UAdvancedMovementComponent::StopInputRecording(const FString& FilePath)
+{
+	if (!InputRecording) return false;
+	
+	if (UpdatedComponent)
+	{
+		InputRecording->EndLocation = UpdatedComponent->GetComponentLocation();
+		InputRecording->EndVelocity = Velocity;
+	}
+
+	const FString SavePath = !FilePath.IsEmpty() ? FilePath : FPaths::ProjectSavedDir() / TEXT("Profiling/AdvancedMovement/Recordings")
+		/ FString::Printf(TEXT("%s-%s%s"), *GetNameSafe(CharacterOwner), *FDateTime::Now().ToString(), FAdvancedMovementInputRecording::GetFileExtension());
+	const bool bSaved = InputRecording->SaveToFile(SavePath);
+	UE_LOGFMT(Movement, Display, "{0}: {1} {2} recorded frames ({3}s) to {4}",
+		*GetNameSafe(CharacterOwner),
+		bSaved ? "Saved" : "Failed to save",
+		InputRecording->Frames.Num(),
+		InputRecording->GetDuration(),
+		*SavePath
+	);
+
+	InputRecording.Reset();
+	return bSaved;
+}
+
+
+void UAdvancedMovementComponent::RecordInputFrame(float DeltaTime)
+{
+	if (!InputRecording || !CharacterOwner || !UpdatedComponent) return;
+
+	FAdvancedMovementInputFrame& Frame = InputRecording->Frames.AddDefaulted_GetRef();
+	Frame.DeltaTime = DeltaTime;
+	Frame.Input = PlayerInput;
+	Frame.Yaw = CharacterOwner->Controller ? CharacterOwner->GetControlRotation().Yaw : UpdatedComponent->GetComponentRotation().Yaw;
+	if (CharacterOwner->bPressedJump) Frame.Buttons |= EAdvancedMovementInputButtons::Jump;
+	if (bWantsToCrouch) Frame.Buttons |= EAdvancedMovementInputButtons::Crouch;
+	if (WallJumpPressed) Frame.Buttons |= EAdvancedMovementInputButtons::WallJump;
+	if (SprintPressed) Frame.Buttons |= EAdvancedMovementInputButtons::Sprint;
+	if (AimPressed) Frame.Buttons |= EAdvancedMovementInputButtons::Aim;
+	if (Mantling) Frame.Buttons |= EAdvancedMovementInputButtons::Mantle;
+}
+
+
+void UAdvancedMovementComponent::StartMovementTrace(const int32 Capacity)
+{
+	MovementTrace = MakeUnique<FAdvancedMovementTrace>(Capacity);
+	MovementTrace->CharacterName = GetNameSafe(CharacterOwner);
+	LastTraceCorrectionDumpTime = -1;
+}
+
+
+void UAdvancedMovementComponent::StopMovementTrace()
+{
+	MovementTrace.Reset();
+}
+
+
+bool UAdvancedMovementComponent::DumpMovementTrace(const FString& FilePath, const FString& Reason)
+{
+	if (!MovementTrace) return false;
+
+	const FString SavePath = !FilePath.IsEmpty() ? FilePath : FPaths::ProjectSavedDir() / TEXT("Profiling/AdvancedMovement/Traces")
+		/ FString::Printf(TEXT("%s-%s-%s%s"), *GetNameSafe(CharacterOwner), *Reason, *FDateTime::Now().ToString(), FAdvancedMovementTrace::GetFileExtension());
+	MovementTrace->Reason = Reason;
+	const bool bSaved = MovementTrace->SaveToFile(SavePath);
+	UE_LOGFMT(Movement, Display, "{0}: {1} {2} traced substeps to {3}",
+		*GetNameSafe(CharacterOwner),
+		bSaved ? "Saved" : "Failed to save",
+		MovementTrace->Num(),
+		*SavePath
+	);
+	return bSaved;
+}
+
+
+void UAdvancedMovementComponent::RecordTraceSubstep(const float DeltaTime, const int32 Iterations, const FVector& HitNormal)
+{
+	if (!UpdatedComponent) return;
+
+	FAdvancedMovementTraceRecord& Record = MovementTrace->Add();
+	Record.Time = Time;
+	Record.DeltaTime = DeltaTime;
+	Record.Location = FVector3f(UpdatedComponent->GetComponentLocation());
+	Record.Velocity = FVector3f(Velocity);
+	Record.Acceleration = FVector3f(Acceleration);
+	Record.HitNormal = FVector3f(HitNormal);
+	Record.PlayerInput = FVector2f(PlayerInput);
+	Record.StrafeSwayTime = IsStrafeSwaying() ? Time - StrafeSwayStartTime : -1;
+	Record.StrafeLurchTime = IsStrafeLurching() ? Time - StrafeLurchStartTime : -1;
+	Record.WallClimbTime = IsWallClimbing() ? Time - WallClimbStartTime : -1;
+	Record.WallRunTime = IsWallRunning() ? Time - WallRunStartTime : -1;
+	Record.MovementMode = MovementMode;
+	Record.CustomMovementMode = CustomMovementMode;
+	Record.Branch = static_cast<uint8>(MovementMode == MOVE_Falling || IsSliding() ? TraceBranch : EAdvancedMovementTraceBranch::Default);
+	Record.Iteration = static_cast<uint8>(FMath::Min(Iterations, 255));
+	Record.bReplayed = CharacterOwner && CharacterOwner->bClientUpdating;
+}
+
+
+void UAdvancedMovementComponent::DumpMovementTraceOnCorrection(const FString& Reason)
+{
+	if (!MovementTrace || AdvancedMovementCVars::TraceDumpOnCorrection <= 0) return;
+	if (LastTraceCorrectionDumpTime >= 0 && LastTraceCorrectionDumpTime + AdvancedMovementCVars::TraceDumpOnCorrection > Time) return;
+
+	LastTraceCorrectionDumpTime = Time;
+	DumpMovementTrace(FString(), Reason);
+}
+
+
+EAdvancedMovementPhysics UAdvancedMovementComponent::GetProfiledPhysics() const
+{
+	switch (MovementMode)
+	{
+		case MOVE_Walking:
+		case MOVE_NavWalking:	return EAdvancedMovementPhysics::Walking;
+		case MOVE_Falling:		return EAdvancedMovementPhysics::Falling;
+		case MOVE_Custom:
+			switch (CustomMovementMode)
+			{
+				case MOVE_Custom_Slide:			return EAdvancedMovementPhysics::Slide;
+				case MOVE_Custom_WallRunning:	return EAdvancedMovementPhysics::WallRunning;
+				case MOVE_Custom_WallClimbing:	return EAdvancedMovementPhysics::WallClimbing;
+				case MOVE_Custom_Mantling:		return EAdvancedMovementPhysics::Mantling;
+				case MOVE_Custom_LedgeClimbing:	return EAdvancedMovementPhysics::LedgeClimbing;
+				default:						return EAdvancedMovementPhysics::Other;
+			}
+		default:				return EAdvancedMovementPhysics::Other;
+	}
+}
+#pragma endregion
+
+
+
+
+//------------------------------------------------------------------------------//
+// Network Profiling															//
+//------------------------------------------------------------------------------//
+#pragma region Network Profiling
+void UAdvancedMovementComponent::ServerMoveHandleClientError(float ClientTimeStamp, float DeltaTime, const FVector& Accel, const FVector& RelativeClientLocation,
+	UPrimitiveComponent* ClientMovementBase, FName ClientBaseBoneName, uint8 ClientMovementMode)
+{
+	Super::ServerMoveHandleClientError(ClientTimeStamp, DeltaTime, Accel, RelativeClientLocation, ClientMovementBase, ClientBaseBoneName, ClientMovementMode);
+
+	// The server acknowledges good moves, otherwise there's a pending correction for this move
+	const FNetworkPredictionData_Server_Character* ServerData = GetPredictionData_Server_Character();
+	if (ServerData && !ServerData->PendingAdjustment.bAckGoodMove && ServerData->PendingAdjustment.TimeStamp == ClientTimeStamp)
+	{
+		NetworkStats.ServerCorrections[static_cast<uint8>(GetProfiledPhysics())]++;
+		INC_DWORD_STAT(STAT_AdvancedMovement_ServerCorrections);
+		DumpMovementTraceOnCorrection(TEXT("ServerCorrection"));
+	}
+}
+
+
+bool UAdvancedMovementComponent::ClientUpdatePositionAfterServerUpdate()
+{
+	const FNetworkPredictionData_Client_Character* ClientData = HasValidData() ? GetPredictionData_Client_Character() : nullptr;
+	if (!ClientData || !ClientData->bUpdatePosition)
+	{
+		return Super::ClientUpdatePositionAfterServerUpdate();
+	}
+
+	ADVANCED_MOVEMENT_SCOPE_CYCLE_COUNTER(ReplaySavedMoves);
+	
+	// The movement mode is the server's adjusted movement mode until the moves have been replayed
+	NetworkStats.ClientCorrections[static_cast<uint8>(GetProfiledPhysics())]++;
+	NetworkStats.ReplayedMoves += ClientData->SavedMoves.Num();
+	INC_DWORD_STAT(STAT_AdvancedMovement_ClientCorrections);
+	INC_DWORD_STAT_BY(STAT_AdvancedMovement_ReplayedMoves, ClientData->SavedMoves.Num());
+	DumpMovementTraceOnCorrection(TEXT("ClientCorrection"));
+
+	// The cached uncrouch and the wall climb floor gate aren't part of the saved moves, and they're based on where the client thought it was
+	UnCrouchClearance.bBlocked = false;
+	ResetWallClimbFloorGate();
+	
+	const uint64 StartCycles = FPlatformTime::Cycles64();
+	const bool bResult = Super::ClientUpdatePositionAfterServerUpdate();
+	NetworkStats.ReplayCycles += FPlatformTime::Cycles64() - StartCycles;
+	return bResult;
+}
+
+
+void UAdvancedMovementComponent::CallServerMovePacked(const FSavedMove_Character* NewMove, const FSavedMove_Character* PendingMove, const FSavedMove_Character* OldMove)
+{
+	NetworkStats.SentMoves++;
+	bSerializingServerMove = true;
+	Super::CallServerMovePacked(NewMove, PendingMove, OldMove);
+	bSerializingServerMove = false;
+}
+
+
+void UAdvancedMovementComponent::ServerMovePacked_ClientSend(const FCharacterServerMovePackedBits& PackedBits)
+{
+	NetworkStats.ServerMoveBits += PackedBits.DataBits.Num();
+	INC_DWORD_STAT_BY(STAT_AdvancedMovement_ServerMoveBits, PackedBits.DataBits.Num());
+	Super::ServerMovePacked_ClientSend(PackedBits);
+}
+
+
+void UAdvancedMovementComponent::MoveResponsePacked_ServerSend(const FCharacterMoveResponsePackedBits& PackedBits)
+{
+	NetworkStats.MoveResponses++;
+	NetworkStats.MoveResponseBits += PackedBits.DataBits.Num();
+	INC_DWORD_STAT_BY(STAT_AdvancedMovement_MoveResponseBits, PackedBits.DataBits.Num());
+	
+	// The response container was just packed, and it's either a good move acknowledgement or a correction
+	if (!GetMoveResponseDataContainer().ClientAdjustment.bAckGoodMove)
+	{
+		NetworkStats.CorrectionBits += PackedBits.DataBits.Num();
+		INC_DWORD_STAT_BY(STAT_AdvancedMovement_CorrectionBits, PackedBits.DataBits.Num());
+	}
+	
+	Super::MoveResponsePacked_ServerSend(PackedBits);
+}
+
+
+void UAdvancedMovementComponent::UpdateNetworkStatsSummary()
+{
+	const float Interval = AdvancedMovementCVars::NetStatsLogInterval;
+	if (Interval <= 0 || Time - NetworkStatsStartTime < Interval)
+	{
+		return;
+	}
+	
+	if (NetworkStats.SentMoves || NetworkStats.MoveResponses || NetworkStats.GetServerCorrections() || NetworkStats.GetClientCorrections())
+	{
+		LogNetworkStats(Time - NetworkStatsStartTime);
+	}
+	
+	NetworkStats.Reset();
+	NetworkStatsStartTime = Time;
+}
+
+
+void UAdvancedMovementComponent::LogNetworkStats(const float Duration) const
+{
+	const float Seconds = FMath::Max(Duration, UE_KINDA_SMALL_NUMBER);
+	const uint32 ClientCorrections = NetworkStats.GetClientCorrections();
+	
+	UE_LOGFMT(Movement, Display, "{0} ({1}) network summary over {2}s: {3} server corrections [{4}], {5} client corrections [{6}], {7} moves replayed ({8} per correction, {9}ms), {10} moves sent, upstream {11} bytes/s ({12} bytes/s custom move data), {13} move responses, downstream {14} bytes/s ({15} bytes/s corrections)",
+		*GetNameSafe(CharacterOwner),
+		CharacterOwner && CharacterOwner->HasAuthority() ? "Server" : "Client",
+		Duration,
+		NetworkStats.GetServerCorrections(),
+		*FAdvancedMovementNetworkStats::GetCorrectionBreakdown(NetworkStats.ServerCorrections),
+		ClientCorrections,
+		*FAdvancedMovementNetworkStats::GetCorrectionBreakdown(NetworkStats.ClientCorrections),
+		NetworkStats.ReplayedMoves,
+		ClientCorrections ? static_cast<float>(NetworkStats.ReplayedMoves) / ClientCorrections : 0.f,
+		FPlatformTime::ToMilliseconds64(NetworkStats.ReplayCycles),
+		NetworkStats.SentMoves,
+		NetworkStats.ServerMoveBits / 8.0 / Seconds,
+		NetworkStats.CustomMoveDataBits / 8.0 / Seconds,
+		NetworkStats.MoveResponses,
+		NetworkStats.MoveResponseBits / 8.0 / Seconds,
+		NetworkStats.CorrectionBits / 8.0 / Seconds
+	);
+}
+#pragma endregion
+
+
+
+
+//------------------------------------------------------------------------------//
+// Scene Queries																//
+//------------------------------------------------------------------------------//
+#pragma region Scene Queries
+void UAdvancedMovementComponent::RefreshMovementQueryParams()
+{
+	MovementQueryParams = FCollisionQueryParams(SCENE_QUERY_STAT(AdvancedMovement), false);
+	MovementQueryParams.bReturnPhysicalMaterial = true;
+	if (!CharacterOwner) return;
+
+	// Only the actors of child actor components (including the ones nested in child actors) are ignored, actors that are spawned and attached to the character aren't
+	MovementQueryParams.AddIgnoredActor(CharacterOwner);
+	CharacterOwner->ForEachComponent<UChildActorComponent>(true, [this](const UChildActorComponent* ChildActorComponent)
+	{
+		if (ChildActorComponent->GetChildActor()) MovementQueryParams.AddIgnoredActor(ChildActorComponent->GetChildActor());
+	});
+}
+
+
+FCollisionQueryParams UAdvancedMovementComponent::GetMovementQueryParams(const FName TraceTag, const TStatId StatId) const
+{
+	// The ignore lists have inline storage, so the copy doesn't allocate unless the character has a lot of child actors
+	FCollisionQueryParams QueryParams = MovementQueryParams;
+	QueryParams.TraceTag = TraceTag;
+	QueryParams.StatId = StatId;
+	return QueryParams;
+}
+
+
+void UAdvancedMovementComponent::SetUpdatedComponent(USceneComponent* NewUpdatedComponent)
+{
+	Super::SetUpdatedComponent(NewUpdatedComponent);
+
+	// The child actors are created when their components are registered, so the params are first built once the component is initialized
+	if (HasBeenInitialized())
+	{
+		RefreshMovementQueryParams();
+	}
+}
+
+
+UAdvancedMovementProbeSubsystem* UAdvancedMovementComponent::GetProbeSubsystem() const
+{
+	return GetWorld() ? GetWorld()->GetSubsystem<UAdvancedMovementProbeSubsystem>() : nullptr;
+}
+
+
+void UAdvancedMovementComponent::IssueLookAheadProbes(const float DeltaTime)
+{
+	// The probes predict the next frame's tick, which only locally controlled characters (players and AI) have. Simulated proxies don't run the checks,
+	// and the server moves remote players whenever their moves arrive
+	if (!CharacterOwner || !CharacterOwner->IsLocallyControlled()) return;
+	
+	IssueMantleProbe(DeltaTime);
+	IssueWallJumpProbe(DeltaTime);
+}
+
+
+void UAdvancedMovementComponent::IssueWallJumpProbe(const float DeltaTime)
+{
+#if ADVANCED_MOVEMENT_WITH_WALL_JUMPING
+	WallJumpProbe.InputTrace.Invalidate();
+	WallJumpProbe.FrontTrace.Invalidate();
+	UAdvancedMovementProbeSubsystem* ProbeSubsystem = GetProbeSubsystem();
+	if (!UsesWallJumping() || !bUseWallJumpProbe || !WallJumpPressed || !UpdatedComponent || !ProbeSubsystem) return;
+	if (WallJumpLimit != 0 && CurrentWallJumpCount >= WallJumpLimit) return;
+
+	// Wall jumps are checked while falling, wall climbing, and wall running
+	if (!IsFalling() && !IsCustomMovementMode(MOVE_Custom_WallClimbing) && !IsCustomMovementMode(MOVE_Custom_WallRunning)) return;
+
+	const ECollisionChannel TraceChannel = UEngineTypes::ConvertToCollisionChannel(MovementChannel);
+	const FCollisionQueryParams QueryParams = GetMovementQueryParams(SCENE_QUERY_STAT(AdvancedMovementWallJumpProbe));
+	WallJumpProbe.TraceStart = UpdatedComponent->GetComponentLocation() + Velocity * DeltaTime;
+	WallJumpProbe.InputTraceEnd = WallJumpProbe.TraceStart + Acceleration.GetSafeNormal() * WallJumpValidDistance;
+	WallJumpProbe.FrontTraceEnd = WallJumpProbe.TraceStart + UpdatedComponent->GetForwardVector() * WallJumpValidDistance;
+	AddSceneQuery(EAdvancedMovementQuerySource::WallJump, EAdvancedMovementQuery::LineTrace, 2);
+	WallJumpProbe.InputTrace = ProbeSubsystem->AddLineTraceByChannel(WallJumpProbe.TraceStart, WallJumpProbe.InputTraceEnd, TraceChannel, QueryParams);
+	WallJumpProbe.FrontTrace = ProbeSubsystem->AddLineTraceByChannel(WallJumpProbe.TraceStart, WallJumpProbe.FrontTraceEnd, TraceChannel, QueryParams);
+#endif
+}
+
+
+bool UAdvancedMovementComponent::WallJumpProbeFoundNoWall(const FVector& TraceStart, const FVector& InputTraceEnd, const FVector& FrontTraceEnd) const
+{
+#if ADVANCED_MOVEMENT_WITH_WALL_JUMPING
+	const UAdvancedMovementProbeSubsystem* ProbeSubsystem = GetProbeSubsystem();
+	if (!bUseWallJumpProbe || !WallJumpProbe.InputTrace.IsValid() || !ProbeSubsystem) return false;
+
+	// Only use the probe if the character is where it was predicted to be
+	const float Tolerance = FMath::Square(LookAheadProbeTolerance);
+	if (FVector::DistSquared(TraceStart, WallJumpProbe.TraceStart) > Tolerance
+		|| FVector::DistSquared(InputTraceEnd, WallJumpProbe.InputTraceEnd) > Tolerance
+		|| FVector::DistSquared(FrontTraceEnd, WallJumpProbe.FrontTraceEnd) > Tolerance)
+	{
+		return false;
+	}
+
+	const FAdvancedMovementProbe* InputTrace = ProbeSubsystem->GetResult(WallJumpProbe.InputTrace);
+	const FAdvancedMovementProbe* FrontTrace = ProbeSubsystem->GetResult(WallJumpProbe.FrontTrace);
+	if (!InputTrace || !FrontTrace || InputTrace->Hit.bBlockingHit || FrontTrace->Hit.bBlockingHit) return false;
+
+	INC_DWORD_STAT(STAT_AdvancedMovement_WallJumpProbesUsed);
+	return true;
+#else
+	return false;
+#endif
+}
+#pragma endregion
@@ -4,11 +4,16 @@
 #include "Character/BhopCharacter.h"
 
 #include "AdvancedMovementComponent.h"
+#include "Engine/Level.h"
+#include "GameFramework/PlayerState.h"
+#include "Misc/CommandLine.h"
+#include "Profiling/AdvancedMovementInput.h"
 
 ABhopCharacter::ABhopCharacter(const FObjectInitializer& ObjectInitializer) : Super( // The super initializer is how you subclass components
 	ObjectInitializer.SetDefaultSubobjectClass<UAdvancedMovementComponent>(ACharacter::CharacterMovementComponentName))
 {
-	
+	bUseScriptedInput = false;
+	ScriptedInputTime = 0;
 }
 
 
@@ -16,6 +21,58 @@ void ABhopCharacter::BeginPlay()
 {
 	Super::BeginPlay();
 	
+	if (FParse::Param(FCommandLine::Get(), TEXT("AdvancedMovementScriptedInput")))
+	{
+		bUseScriptedInput = true;
+	}
+
+	// The movement component ticks before the character (bTickBeforeOwner), so the scripted input has its own tick that the movement component waits on
+	if (bUseScriptedInput && GetCharacterMovement())
+	{
+		ScriptedInputTick.Target = this;
+		ScriptedInputTick.TickGroup = TG_PrePhysics;
+		ScriptedInputTick.bCanEverTick = true;
+		ScriptedInputTick.RegisterTickFunction(GetLevel());
+		GetCharacterMovement()->PrimaryComponentTick.AddPrerequisite(this, ScriptedInputTick);
+	}
+}
+
+
+void ABhopCharacter::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (ScriptedInputTick.IsTickFunctionRegistered())
+	{
+		if (GetCharacterMovement()) GetCharacterMovement()->PrimaryComponentTick.RemovePrerequisite(this, ScriptedInputTick);
+		ScriptedInputTick.UnRegisterTickFunction();
+	}
+	
+	Super::EndPlay(EndPlayReason);
+}
+
+
+void ABhopCharacter::TickScriptedInput(const float DeltaSeconds)
+{
+	// Characters that aren't locally controlled get their input from the owning client's moves
+	if (!IsLocallyControlled()) return;
+	
+	const int32 Seed = GetPlayerState() ? GetPlayerState()->GetPlayerId() : 0;
+	AdvancedMovementInput::ApplyInputFrame(this, GetAdvancedCharacterMovementComponent(), AdvancedMovementInput::EvaluateStrafeScript(Seed, ScriptedInputTime, DeltaSeconds));
+	ScriptedInputTime += DeltaSeconds;
+}
+
+
+void FBhopScriptedInputTickFunction::ExecuteTick(const float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent)
+{
+	if (IsValid(Target) && TickType != LEVELTICK_ViewportsOnly)
+	{
+		Target->TickScriptedInput(DeltaTime * Target->CustomTimeDilation);
+	}
+}
+
+
+FString FBhopScriptedInputTickFunction::DiagnosticMessage()
+{
+	return Target ? Target->GetFullName() + TEXT("[TickScriptedInput]") : TEXT("BhopScriptedInputTickFunction");
 }
 
 
@@ -0,0 +1,364 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Commandlets/AdvancedMovementBenchmarkCommandlet.h"
+#include "AdvancedMovementComponent.h"
+#include "Character/BhopCharacter.h"
+#include "Profiling/AdvancedMovementBenchmarkWorld.h"
+#include "Profiling/AdvancedMovementInput.h"
+#include "Profiling/AdvancedMovementProfiling.h"
+#include "Core/AdvancedMovementMath.h"
+#include "Core/AdvancedMovementMathBatch.h"
+#include "Engine/World.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Logging/StructuredLog.h"
+
+
+/** The crowd's airborne characters for the batched velocity phase (-VelocityBatch), grouped by their air velocity branch */
+struct FAdvancedMovementVelocityBatch
+{
+	/** The characters of a branch, and the params they share */
+	struct FBranch
+	{
+		EAdvancedMovementTraceBranch Type = EAdvancedMovementTraceBranch::AirStrafe;
+		AdvancedMovementMath::FAirStrafeParams Params;
+		float LurchFriction = 0;
+		TArray<FVector> Velocity;
+		TArray<FVector> AccelDir;
+		TArray<FVector> Acceleration;
+		TArray<float> LurchStrength;
+		TArray<FVector> ScalarVelocity;
+		AdvancedMovementMath::FStrafeBatch Batch;
+
+		void Reset()
+		{
+			Velocity.Reset();
+			AccelDir.Reset();
+			Acceleration.Reset();
+			LurchStrength.Reset();
+			ScalarVelocity.Reset();
+		}
+	};
+
+	FBranch Branches[3];
+
+	/** Gathers the airborne characters, with the same inputs their next CalcVelocity uses. Characters whose tuning doesn't match the rest of their branch aren't batched */
+	void Gather(const TArray<UAdvancedMovementComponent*>& MovementComponents)
+	{
+		Branches[0].Type = EAdvancedMovementTraceBranch::AirStrafe;
+		Branches[1].Type = EAdvancedMovementTraceBranch::StrafeSway;
+		Branches[2].Type = EAdvancedMovementTraceBranch::StrafeLurch;
+		for (FBranch& Branch : Branches) Branch.Reset();
+
+		for (UAdvancedMovementComponent* MovementComponent : MovementComponents)
+		{
+			EAdvancedMovementTraceBranch Type;
+			AdvancedMovementMath::FAirStrafeParams Params;
+			float LurchStrength, LurchFriction;
+			if (!MovementComponent || !MovementComponent->GetAirStrafeState(Type, Params, LurchStrength, LurchFriction)) continue;
+
+			FBranch& Branch = Branches[Type == EAdvancedMovementTraceBranch::StrafeSway ? 1 : Type == EAdvancedMovementTraceBranch::StrafeLurch ? 2 : 0];
+			if (Branch.Velocity.IsEmpty())
+			{
+				Branch.Params = Params;
+				Branch.LurchFriction = LurchFriction;
+			}
+			else if (Branch.Params.AirSpeedCap != Params.AirSpeedCap || Branch.Params.AccelerationMultiplier != Params.AccelerationMultiplier
+				|| Branch.Params.AirControl != Params.AirControl || Branch.LurchFriction != LurchFriction)
+			{
+				continue;
+			}
+
+			Branch.Velocity.Add(MovementComponent->Velocity);
+			Branch.AccelDir.Add(MovementComponent->GetCurrentAcceleration().GetSafeNormal2D());
+			Branch.Acceleration.Add(MovementComponent->GetCurrentAcceleration());
+			Branch.LurchStrength.Add(LurchStrength);
+		}
+	}
+
+	/** Returns how many characters were gathered */
+	int32 Num() const
+	{
+		return Branches[0].Velocity.Num() + Branches[1].Velocity.Num() + Branches[2].Velocity.Num();
+	}
+
+	/** Runs the scalar velocity math (the same calls as CalcVelocity) for every gathered character */
+	void RunScalar(const float DeltaTime)
+	{
+		for (FBranch& Branch : Branches)
+		{
+			for (int32 Index = 0; Index < Branch.Velocity.Num(); Index++)
+			{
+				const FVector& Velocity = Branch.Velocity[Index];
+				const FVector& AccelDir = Branch.AccelDir[Index];
+				const FVector AddedVelocity = AdvancedMovementMath::GetAirStrafeVelocity(Velocity, AccelDir, Branch.Acceleration[Index], Branch.Params, DeltaTime);
+				if (Branch.Type == EAdvancedMovementTraceBranch::StrafeSway)
+				{
+					Branch.ScalarVelocity.Add(AdvancedMovementMath::CanStrafeSway(Velocity, AccelDir) ? Velocity + AddedVelocity : Velocity);
+				}
+				else if (Branch.Type == EAdvancedMovementTraceBranch::StrafeLurch)
+				{
+					const FVector LurchVelocity = AdvancedMovementMath::GetStrafeLurchVelocity(Velocity, AccelDir, Branch.LurchFriction, DeltaTime);
+					Branch.ScalarVelocity.Add(AdvancedMovementMath::BlendStrafeLurch(Velocity + AddedVelocity, LurchVelocity, Branch.LurchStrength[Index]));
+				}
+				else
+				{
+					Branch.ScalarVelocity.Add(Velocity + AddedVelocity);
+				}
+			}
+		}
+	}
+
+	/** Copies every gathered character into the structure of arrays, and runs the batched velocity math */
+	void RunBatch(const float DeltaTime)
+	{
+		for (FBranch& Branch : Branches)
+		{
+			if (Branch.Velocity.IsEmpty()) continue;
+
+			Branch.Batch.SetNum(Branch.Velocity.Num());
+			for (int32 Index = 0; Index < Branch.Velocity.Num(); Index++)
+			{
+				Branch.Batch.Set(Index, Branch.Velocity[Index], Branch.AccelDir[Index], Branch.Acceleration[Index], DeltaTime, Branch.LurchStrength[Index]);
+			}
+
+			if (Branch.Type == EAdvancedMovementTraceBranch::StrafeSway) AdvancedMovementMath::StrafeSwayBatch(Branch.Batch, Branch.Params);
+			else if (Branch.Type == EAdvancedMovementTraceBranch::StrafeLurch) AdvancedMovementMath::StrafeLurchBatch(Branch.Batch, Branch.Params, Branch.LurchFriction);
+			else AdvancedMovementMath::AirStrafeBatch(Branch.Batch, Branch.Params);
+		}
+	}
+
+	/** Returns the largest difference between the batched and scalar velocities, relative to the character's speed */
+	double GetMaxDivergence() const
+	{
+		double MaxDivergence = 0;
+		for (const FBranch& Branch : Branches)
+		{
+			for (int32 Index = 0; Index < Branch.ScalarVelocity.Num(); Index++)
+			{
+				const FVector& Expected = Branch.ScalarVelocity[Index];
+				MaxDivergence = FMath::Max(MaxDivergence, (Branch.Batch.GetVelocity(Index) - Expected).Size() / FMath::Max(1.0, Expected.Size()));
+			}
+		}
+		return MaxDivergence;
+	}
+};
+
+
+UAdvancedMovementBenchmarkCommandlet::UAdvancedMovementBenchmarkCommandlet()
+{
+	IsClient = false;
+	IsServer = true;
+	IsEditor = false;
+	LogToConsole = true;
+}
+
+
+int32 UAdvancedMovementBenchmarkCommandlet::Main(const FString& Params)
+{
+	FString MapName = TEXT("/Game/ThirdPerson/Maps/Demo");
+	FString CharacterClassPath;
+	FString OutputPath;
+	int32 Count = 64;
+	int32 Frames = 3600;
+	int32 Warmup = 120;
+	float DeltaTime = 1.f / 60.f;
+	FParse::Value(*Params, TEXT("Map="), MapName);
+	FParse::Value(*Params, TEXT("Character="), CharacterClassPath);
+	FParse::Value(*Params, TEXT("Output="), OutputPath);
+	FParse::Value(*Params, TEXT("Count="), Count);
+	FParse::Value(*Params, TEXT("Frames="), Frames);
+	FParse::Value(*Params, TEXT("Warmup="), Warmup);
+	FParse::Value(*Params, TEXT("DeltaTime="), DeltaTime);
+	const bool bVelocityBatch = FParse::Param(*Params, TEXT("VelocityBatch"));
+	if (Count <= 0 || Frames <= 0 || DeltaTime <= 0)
+	{
+		UE_LOGFMT(Movement, Error, "AdvancedMovementBenchmark: Count, Frames, and DeltaTime need to be greater than zero");
+		return 1;
+	}
+
+	TSubclassOf<ABhopCharacter> CharacterClass = ABhopCharacter::StaticClass();
+	if (!CharacterClassPath.IsEmpty())
+	{
+		CharacterClass = LoadClass<ABhopCharacter>(nullptr, *CharacterClassPath);
+		if (!CharacterClass)
+		{
+			UE_LOGFMT(Movement, Error, "AdvancedMovementBenchmark: Failed to load the character class {0}", *CharacterClassPath);
+			return 1;
+		}
+	}
+
+	UWorld* World = AdvancedMovementBenchmark::CreateWorld(MapName);
+	if (!World)
+	{
+		UE_LOGFMT(Movement, Error, "AdvancedMovementBenchmark: Failed to load the map {0}", *MapName);
+		return 1;
+	}
+
+	TArray<ABhopCharacter*> Characters = AdvancedMovementBenchmark::SpawnCharacters(World, Count, CharacterClass);
+	TArray<UAdvancedMovementComponent*> MovementComponents;
+	for (ABhopCharacter* Character : Characters)
+	{
+		MovementComponents.Add(Cast<UAdvancedMovementComponent>(Character->GetCharacterMovement()));
+	}
+	UE_LOGFMT(Movement, Display, "AdvancedMovementBenchmark: Running {0} characters on {1} for {2} frames ({3} warmup) at {4}s",
+		Characters.Num(), *MapName, Frames, Warmup, DeltaTime);
+
+
+	// Per frame samples of each physics function (summed across every character), and the cost of the entire world tick
+	constexpr int32 PhysicsCount = static_cast<int32>(EAdvancedMovementPhysics::MAX);
+	TArray<double> PhysicsSamples[PhysicsCount];
+	TArray<double> MovementSamples;
+	TArray<double> WorldTickSamples;
+	uint64 PhysicsCalls[PhysicsCount] = {};
+	for (TArray<double>& Samples : PhysicsSamples) Samples.Reserve(Frames);
+	MovementSamples.Reserve(Frames);
+	WorldTickSamples.Reserve(Frames);
+
+	// The velocity phase of the crowd's airborne characters, run with the scalar math and with the batched math on the same inputs (-VelocityBatch)
+	FAdvancedMovementVelocityBatch VelocityBatch;
+	TArray<double> VelocityScalarSamples;
+	TArray<double> VelocityBatchSamples;
+	uint64 VelocityBatchCharacters = 0;
+	double MaxVelocityBatchDivergence = 0;
+	if (bVelocityBatch)
+	{
+		VelocityScalarSamples.Reserve(Frames);
+		VelocityBatchSamples.Reserve(Frames);
+	}
+
+	float ScriptTime = 0;
+	for (int32 Frame = -Warmup; Frame < Frames; Frame++)
+	{
+		const bool bMeasure = Frame >= 0;
+		if (Frame == 0)
+		{
+			for (UAdvancedMovementComponent* MovementComponent : MovementComponents)
+			{
+				if (MovementComponent) MovementComponent->ResetSceneQueryStats();
+			}
+		}
+
+		for (int32 Index = 0; Index < Characters.Num(); Index++)
+		{
+			const FAdvancedMovementInputFrame InputFrame = AdvancedMovementInput::EvaluateStrafeScript(Index, ScriptTime, DeltaTime);
+			AdvancedMovementInput::ApplyInputFrame(Characters[Index], MovementComponents[Index], InputFrame);
+		}
+		ScriptTime += DeltaTime;
+
+		if (bVelocityBatch && bMeasure)
+		{
+			VelocityBatch.Gather(MovementComponents);
+			const uint64 ScalarStartCycles = FPlatformTime::Cycles64();
+			VelocityBatch.RunScalar(DeltaTime);
+			const uint64 BatchStartCycles = FPlatformTime::Cycles64();
+			VelocityBatch.RunBatch(DeltaTime);
+			const uint64 BatchEndCycles = FPlatformTime::Cycles64();
+
+			VelocityScalarSamples.Add(FPlatformTime::ToMilliseconds64(BatchStartCycles - ScalarStartCycles) * 1000.0);
+			VelocityBatchSamples.Add(FPlatformTime::ToMilliseconds64(BatchEndCycles - BatchStartCycles) * 1000.0);
+			VelocityBatchCharacters += VelocityBatch.Num();
+			MaxVelocityBatchDivergence = FMath::Max(MaxVelocityBatchDivergence, VelocityBatch.GetMaxDivergence());
+		}
+
+		FAdvancedMovementPhysicsTimings::bEnabled = bMeasure;
+		FAdvancedMovementPhysicsTimings::Reset();
+		const uint64 StartCycles = FPlatformTime::Cycles64();
+		AdvancedMovementBenchmark::TickWorld(World, DeltaTime);
+		const uint64 EndCycles = FPlatformTime::Cycles64();
+		FAdvancedMovementPhysicsTimings::bEnabled = false;
+		if (!bMeasure) continue;
+
+		double MovementUs = 0;
+		for (int32 Physics = 0; Physics < PhysicsCount; Physics++)
+		{
+			const double PhysicsUs = FPlatformTime::ToMilliseconds64(FAdvancedMovementPhysicsTimings::Cycles[Physics]) * 1000.0;
+			PhysicsSamples[Physics].Add(PhysicsUs);
+			PhysicsCalls[Physics] += FAdvancedMovementPhysicsTimings::Calls[Physics];
+			MovementUs += PhysicsUs;
+		}
+		MovementSamples.Add(MovementUs);
+		WorldTickSamples.Add(FPlatformTime::ToMilliseconds64(EndCycles - StartCycles) * 1000.0);
+	}
+
+
+	// Write the results
+	FString Csv = TEXT("Phase,Characters,Frames,DeltaTime,Calls,TotalMs,MeanUs,P50Us,P90Us,P95Us,P99Us,MaxUs,MeanUsPerCharacter\n");
+	auto AddRow = [&](const TCHAR* Phase, TArray<double>& Samples, const uint64 Calls)
+	{
+		Samples.Sort();
+		double Total = 0;
+		for (const double Sample : Samples) Total += Sample;
+		const double Mean = Samples.Num() ? Total / Samples.Num() : 0;
+
+		Csv += FString::Printf(TEXT("%s,%d,%d,%f,%llu,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f\n"),
+			Phase, Characters.Num(), Samples.Num(), DeltaTime, Calls, Total / 1000.0, Mean,
+			AdvancedMovementBenchmark::GetPercentile(Samples, 0.5), AdvancedMovementBenchmark::GetPercentile(Samples, 0.9), AdvancedMovementBenchmark::GetPercentile(Samples, 0.95), AdvancedMovementBenchmark::GetPercentile(Samples, 0.99),
+			Samples.Num() ? Samples.Last() : 0, Characters.Num() ? Mean / Characters.Num() : 0
+		);
+
+		UE_LOGFMT(Movement, Display, "AdvancedMovementBenchmark: {0}: mean {1}us, p95 {2}us, max {3}us",
+			Phase, Mean, AdvancedMovementBenchmark::GetPercentile(Samples, 0.95), Samples.Num() ? Samples.Last() : 0);
+	};
+
+	uint64 TotalCalls = 0;
+	for (int32 Physics = 0; Physics < PhysicsCount; Physics++)
+	{
+		AddRow(FAdvancedMovementPhysicsTimings::GetName(static_cast<EAdvancedMovementPhysics>(Physics)), PhysicsSamples[Physics], PhysicsCalls[Physics]);
+		TotalCalls += PhysicsCalls[Physics];
+	}
+	AddRow(TEXT("Movement"), MovementSamples, TotalCalls);
+	AddRow(TEXT("WorldTick"), WorldTickSamples, WorldTickSamples.Num());
+	if (bVelocityBatch)
+	{
+		AddRow(TEXT("VelocityScalar"), VelocityScalarSamples, VelocityBatchCharacters);
+		AddRow(TEXT("VelocityBatch"), VelocityBatchSamples, VelocityBatchCharacters);
+		UE_LOGFMT(Movement, Display, "AdvancedMovementBenchmark: Batched the velocity of {0} airborne characters per frame on average, the largest difference from the scalar math was {1} of the character's speed",
+			VelocityBatchSamples.Num() ? static_cast<double>(VelocityBatchCharacters) / VelocityBatchSamples.Num() : 0, MaxVelocityBatchDivergence);
+	}
+
+	// The scene queries of each movement feature, per character per frame
+	FAdvancedMovementSceneQueryStats SceneQueries;
+	for (const UAdvancedMovementComponent* MovementComponent : MovementComponents)
+	{
+		if (MovementComponent) SceneQueries.Append(MovementComponent->GetTotalSceneQueryStats());
+	}
+
+	const double CharacterFrames = FMath::Max(static_cast<double>(Characters.Num()) * Frames, 1.0);
+	Csv += TEXT("\nSource");
+	for (int32 Query = 0; Query < static_cast<int32>(EAdvancedMovementQuery::MAX); Query++)
+	{
+		Csv += FString::Printf(TEXT(",%s"), FAdvancedMovementSceneQueryStats::GetQueryName(static_cast<EAdvancedMovementQuery>(Query)));
+	}
+	Csv += TEXT(",Total,PerCharacterFrame\n");
+	for (int32 Source = 0; Source < static_cast<int32>(EAdvancedMovementQuerySource::MAX); Source++)
+	{
+		Csv += FAdvancedMovementSceneQueryStats::GetSourceName(static_cast<EAdvancedMovementQuerySource>(Source));
+		for (int32 Query = 0; Query < static_cast<int32>(EAdvancedMovementQuery::MAX); Query++)
+		{
+			Csv += FString::Printf(TEXT(",%u"), SceneQueries.BySource[Source][Query]);
+		}
+
+		const uint32 SourceTotal = SceneQueries.GetSourceTotal(static_cast<EAdvancedMovementQuerySource>(Source));
+		Csv += FString::Printf(TEXT(",%u,%.4f\n"), SourceTotal, SourceTotal / CharacterFrames);
+		UE_LOGFMT(Movement, Display, "AdvancedMovementBenchmark: {0} queries: {1} per character per frame",
+			FAdvancedMovementSceneQueryStats::GetSourceName(static_cast<EAdvancedMovementQuerySource>(Source)), SourceTotal / CharacterFrames);
+	}
+
+	if (OutputPath.IsEmpty())
+	{
+		OutputPath = FPaths::ProjectSavedDir() / TEXT("Profiling/AdvancedMovement") / FString::Printf(TEXT("Benchmark-%d-%s.csv"), Characters.Num(), *FDateTime::Now().ToString());
+	}
+
+	AdvancedMovementBenchmark::DestroyWorld(World);
+	if (!FFileHelper::SaveStringToFile(Csv, *OutputPath))
+	{
+		UE_LOGFMT(Movement, Error, "AdvancedMovementBenchmark: Failed to write the results to {0}", *OutputPath);
+		return 1;
+	}
+
+	UE_LOGFMT(Movement, Display, "AdvancedMovementBenchmark: Wrote the results to {0}", *FPaths::ConvertRelativePathToFull(OutputPath));
+	return 0;
+}
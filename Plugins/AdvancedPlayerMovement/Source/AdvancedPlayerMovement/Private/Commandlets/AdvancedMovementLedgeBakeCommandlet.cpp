@@ -0,0 +1,242 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Commandlets/AdvancedMovementLedgeBakeCommandlet.h"
+#include "AdvancedMovementComponent.h"
+#include "Character/BhopCharacter.h"
+#include "Ledges/AdvancedMovementLedgeDatabase.h"
+#include "Ledges/AdvancedMovementLedgeSubsystem.h"
+#include "Profiling/AdvancedMovementBenchmarkWorld.h"
+#include "Components/CapsuleComponent.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "Misc/PackageName.h"
+#include "UObject/Package.h"
+#include "UObject/SavePackage.h"
+#include "Logging/StructuredLog.h"
+
+
+UAdvancedMovementLedgeBakeCommandlet::UAdvancedMovementLedgeBakeCommandlet()
+{
+	IsClient = false;
+	IsServer = true;
+	IsEditor = true;
+	LogToConsole = true;
+}
+
+
+int32 UAdvancedMovementLedgeBakeCommandlet::Main(const FString& Params)
+{
+#if WITH_EDITOR
+	FString MapName;
+	FString CharacterClassPath;
+	FString OutputPackageName;
+	float Spacing = 25;
+	float CellSize = 100;
+	int32 Directions = 8;
+	FParse::Value(*Params, TEXT("Map="), MapName);
+	FParse::Value(*Params, TEXT("Character="), CharacterClassPath);
+	FParse::Value(*Params, TEXT("Output="), OutputPackageName);
+	FParse::Value(*Params, TEXT("Spacing="), Spacing);
+	FParse::Value(*Params, TEXT("CellSize="), CellSize);
+	FParse::Value(*Params, TEXT("Directions="), Directions);
+	if (MapName.IsEmpty() || Spacing <= 0 || CellSize <= 0 || Directions <= 0)
+	{
+		UE_LOGFMT(Movement, Error, "AdvancedMovementLedgeBake: Usage: -Map=/Game/Map [-Spacing=25] [-Directions=8] [-CellSize=100] [-Character=] [-Output=]");
+		return 1;
+	}
+
+	TSubclassOf<ABhopCharacter> CharacterClass = ABhopCharacter::StaticClass();
+	if (!CharacterClassPath.IsEmpty())
+	{
+		CharacterClass = LoadClass<ABhopCharacter>(nullptr, *CharacterClassPath);
+		if (!CharacterClass)
+		{
+			UE_LOGFMT(Movement, Error, "AdvancedMovementLedgeBake: Failed to load the character class {0}", *CharacterClassPath);
+			return 1;
+		}
+	}
+
+	UWorld* World = AdvancedMovementBenchmark::CreateWorld(MapName);
+	if (!World)
+	{
+		UE_LOGFMT(Movement, Error, "AdvancedMovementLedgeBake: Failed to load the map {0}", *MapName);
+		return 1;
+	}
+
+	// Find the ledges with the mantle traces, and not with a previous bake
+	if (UAdvancedMovementLedgeSubsystem* LedgeSubsystem = World->GetSubsystem<UAdvancedMovementLedgeSubsystem>())
+	{
+		LedgeSubsystem->SetDatabase(nullptr);
+	}
+
+	ABhopCharacter* Character = AdvancedMovementBenchmark::SpawnCharacter(World, FVector(0, 0, WORLD_MAX / 4), FRotator::ZeroRotator, CharacterClass);
+	UAdvancedMovementComponent* MovementComponent = Character ? Cast<UAdvancedMovementComponent>(Character->GetCharacterMovement()) : nullptr;
+	if (!MovementComponent || !MovementComponent->bUseMantling)
+	{
+		UE_LOGFMT(Movement, Error, "AdvancedMovementLedgeBake: The character needs an advanced movement component that uses mantling");
+		AdvancedMovementBenchmark::DestroyWorld(World);
+		return 1;
+	}
+	MovementComponent->bUseLedgeDatabase = false;
+	MovementComponent->bUseAsyncMantleProbe = false;
+	MovementComponent->bDebugMantleAndClimbTrace = false;
+
+	const FAdvancedMovementLedgeBakeSettings Settings = MovementComponent->GetLedgeBakeSettings();
+	if (Spacing > MovementComponent->MantleTraceDistance - Settings.CapsuleRadius)
+	{
+		UE_LOGFMT(Movement, Warning, "AdvancedMovementLedgeBake: The spacing ({0}) is larger than the mantle trace reaches past the capsule ({1}), some ledges will be missed",
+			Spacing, MovementComponent->MantleTraceDistance - Settings.CapsuleRadius);
+	}
+
+
+	// Run the mantle checks in front of every surface from each direction, and keep one ledge per sample and wall direction
+	const TArray<FVector> Surfaces = FindLedgeSurfaces(World, MovementComponent, Spacing);
+	UE_LOGFMT(Movement, Display, "AdvancedMovementLedgeBake: Checking {0} surfaces of {1} from {2} directions", Surfaces.Num(), *MapName, Directions);
+
+	TArray<FAdvancedMovementBakedLedge> Ledges;
+	TSet<TTuple<FIntVector, int32>> BakedLedges;
+	for (int32 Index = 0; Index < Surfaces.Num(); Index++)
+	{
+		for (int32 Angle = 0; Angle < Directions; Angle++)
+		{
+			const FVector Direction = FRotator(0, Angle * 360.f / Directions, 0).Vector();
+			FAdvancedMovementBakedLedge Ledge;
+			if (!BakeLedge(MovementComponent, Surfaces[Index], Direction, Ledge)) continue;
+
+			const FIntVector Sample(
+				FMath::RoundToInt(Ledge.LedgeLocation.X / (Spacing / 2)),
+				FMath::RoundToInt(Ledge.LedgeLocation.Y / (Spacing / 2)),
+				FMath::RoundToInt(Ledge.LedgeLocation.Z / (Spacing / 2))
+			);
+			const int32 WallDirection = FMath::RoundToInt(Ledge.WallNormal.Rotation().Yaw / (360.f / Directions)) % Directions;
+			bool bAlreadyBaked;
+			BakedLedges.Add(MakeTuple(Sample, WallDirection), &bAlreadyBaked);
+			if (!bAlreadyBaked) Ledges.Add(Ledge);
+		}
+
+		if ((Index + 1) % 10000 == 0)
+		{
+			UE_LOGFMT(Movement, Display, "AdvancedMovementLedgeBake: {0}/{1} surfaces, {2} ledges", Index + 1, Surfaces.Num(), Ledges.Num());
+		}
+	}
+	AdvancedMovementBenchmark::DestroyWorld(World);
+
+
+	// Save the database next to the map
+	if (OutputPackageName.IsEmpty())
+	{
+		OutputPackageName = MapName + UAdvancedMovementLedgeDatabase::GetAssetSuffix();
+	}
+	const FString AssetName = FPackageName::GetShortName(OutputPackageName);
+	UPackage* Package = CreatePackage(*OutputPackageName);
+	UAdvancedMovementLedgeDatabase* Database = FindObject<UAdvancedMovementLedgeDatabase>(Package, *AssetName);
+	if (!Database)
+	{
+		Database = NewObject<UAdvancedMovementLedgeDatabase>(Package, *AssetName, RF_Public | RF_Standalone);
+	}
+
+	const int32 LedgeCount = Ledges.Num();
+	Database->Build(MoveTemp(Ledges), Settings, CellSize, Spacing);
+	Package->MarkPackageDirty();
+
+	const FString Filename = FPackageName::LongPackageNameToFilename(OutputPackageName, FPackageName::GetAssetPackageExtension());
+	FSavePackageArgs SaveArgs;
+	SaveArgs.TopLevelFlags = RF_Public | RF_Standalone;
+	SaveArgs.SaveFlags = SAVE_NoError;
+	if (!UPackage::SavePackage(Package, Database, *Filename, SaveArgs))
+	{
+		UE_LOGFMT(Movement, Error, "AdvancedMovementLedgeBake: Failed to save the ledge database to {0}", *Filename);
+		return 1;
+	}
+
+	UE_LOGFMT(Movement, Display, "AdvancedMovementLedgeBake: Baked {0} ledges to {1}", LedgeCount, *OutputPackageName);
+	return 0;
+#else
+	UE_LOGFMT(Movement, Error, "AdvancedMovementLedgeBake: Ledges can only be baked in editor builds");
+	return 1;
+#endif
+}
+
+
+TArray<FVector> UAdvancedMovementLedgeBakeCommandlet::FindLedgeSurfaces(UWorld* World, UAdvancedMovementComponent* MovementComponent, const float Spacing) const
+{
+	TArray<FVector> Surfaces;
+	if (!World || !MovementComponent) return Surfaces;
+
+	// Only static geometry is baked, anything that moves has to be handled by the mantle traces
+	const FCollisionObjectQueryParams ObjectParams(MovementComponent->MantleObjects);
+	const float Reach = MovementComponent->MantleTraceDistance + MovementComponent->MantleSecondTraceDistance;
+	TMap<FIntPoint, FVector2D> Columns;
+	for (TActorIterator<AActor> It(World); It; ++It)
+	{
+		TInlineComponentArray<UPrimitiveComponent*> Primitives(*It);
+		for (const UPrimitiveComponent* Primitive : Primitives)
+		{
+			if (Primitive->Mobility != EComponentMobility::Static || !Primitive->IsCollisionEnabled()) continue;
+			if (!MovementComponent->MantleObjects.Contains(UEngineTypes::ConvertToObjectType(Primitive->GetCollisionObjectType()))) continue;
+
+			// Sample the columns above the geometry on a grid that's shared between every object
+			const FBox Bounds = Primitive->Bounds.GetBox().ExpandBy(Reach);
+			for (int32 X = FMath::FloorToInt(Bounds.Min.X / Spacing); X <= FMath::CeilToInt(Bounds.Max.X / Spacing); X++)
+			{
+				for (int32 Y = FMath::FloorToInt(Bounds.Min.Y / Spacing); Y <= FMath::CeilToInt(Bounds.Max.Y / Spacing); Y++)
+				{
+					FVector2D& Column = Columns.FindOrAdd(FIntPoint(X, Y), FVector2D(Bounds.Max.Z, Bounds.Min.Z));
+					Column.X = FMath::Max(Column.X, Bounds.Max.Z);
+					Column.Y = FMath::Min(Column.Y, Bounds.Min.Z);
+				}
+			}
+		}
+	}
+
+	// Trace down each column, and keep every surface the ledge trace could hit (the objects that were hit are ignored so the surfaces below them are found)
+	constexpr int32 MaxSurfacesPerColumn = 8;
+	for (const TPair<FIntPoint, FVector2D>& Column : Columns)
+	{
+		FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(AdvancedMovementLedgeBake), false, MovementComponent->GetOwner());
+		FVector TraceStart(Column.Key.X * Spacing, Column.Key.Y * Spacing, Column.Value.X);
+		const FVector TraceEnd(TraceStart.X, TraceStart.Y, Column.Value.Y);
+		for (int32 Surface = 0; Surface < MaxSurfacesPerColumn; Surface++)
+		{
+			FHitResult Hit;
+			if (!World->LineTraceSingleByObjectType(Hit, TraceStart, TraceEnd, ObjectParams, QueryParams) || !Hit.IsValidBlockingHit()) break;
+			Surfaces.Add(Hit.ImpactPoint);
+
+			QueryParams.AddIgnoredComponent(Hit.GetComponent());
+			TraceStart = Hit.ImpactPoint;
+		}
+	}
+
+	return Surfaces;
+}
+
+
+bool UAdvancedMovementLedgeBakeCommandlet::BakeLedge(UAdvancedMovementComponent* MovementComponent, const FVector& Surface, const FVector& Direction, FAdvancedMovementBakedLedge& OutLedge) const
+{
+	ACharacter* Character = MovementComponent ? MovementComponent->GetCharacterOwner() : nullptr;
+	UCapsuleComponent* Capsule = Character ? Character->GetCapsuleComponent() : nullptr;
+	if (!Capsule) return false;
+
+	// Stand back far enough for the wall trace to reach the wall below the surface, and try a few heights within the ledge trace
+	const FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(AdvancedMovementLedgeBake), false, Character);
+	const FCollisionResponseParams ResponseParams(Capsule->GetCollisionResponseToChannels());
+	for (const float Depth : {0.25f, 0.5f, 0.75f})
+	{
+		FVector Location = Surface - Direction * MovementComponent->MantleTraceDistance;
+		Location.Z = Surface.Z - MovementComponent->MantleSecondTraceDistance * Depth + MovementComponent->MantleTraceHeightOffset;
+		if (Capsule->GetWorld()->OverlapBlockingTestByChannel(Location, FQuat::Identity, Capsule->GetCollisionObjectType(), Capsule->GetCollisionShape(), QueryParams, ResponseParams)) continue;
+
+		Character->SetActorLocationAndRotation(Location, Direction.Rotation(), false, nullptr, ETeleportType::TeleportPhysics);
+		MovementComponent->bCrouchedLedgeClimb = false;
+		if (!MovementComponent->CheckIfSafeToMantleLedge()) continue;
+
+		OutLedge.LedgeLocation = MovementComponent->LedgeClimbLocation;
+		OutLedge.WallNormal = MovementComponent->LedgeClimbNormal;
+		OutLedge.WallLocation = MovementComponent->LedgeClimbLocation + MovementComponent->LedgeClimbNormal * MovementComponent->MantleSurfaceTraceFromLedgeOffset;
+		OutLedge.WallLocation.Z = Location.Z - MovementComponent->MantleTraceHeightOffset;
+		return true;
+	}
+
+	return false;
+}
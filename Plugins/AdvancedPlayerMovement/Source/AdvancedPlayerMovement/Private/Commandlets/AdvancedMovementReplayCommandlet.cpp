@@ -0,0 +1,135 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Commandlets/AdvancedMovementReplayCommandlet.h"
+#include "AdvancedMovementComponent.h"
+#include "Character/BhopCharacter.h"
+#include "Profiling/AdvancedMovementBenchmarkWorld.h"
+#include "Profiling/AdvancedMovementInput.h"
+#include "Profiling/AdvancedMovementInputRecording.h"
+#include "Profiling/AdvancedMovementProfiling.h"
+#include "Engine/World.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Logging/StructuredLog.h"
+
+
+UAdvancedMovementReplayCommandlet::UAdvancedMovementReplayCommandlet()
+{
+	IsClient = false;
+	IsServer = true;
+	IsEditor = false;
+	LogToConsole = true;
+}
+
+
+int32 UAdvancedMovementReplayCommandlet::Main(const FString& Params)
+{
+	FString RecordingPath;
+	FString MapName;
+	FString CharacterClassPath;
+	FString OutputPath;
+	int32 AllocationWarmupFrames = INDEX_NONE;
+	FParse::Value(*Params, TEXT("Recording="), RecordingPath);
+	FParse::Value(*Params, TEXT("Map="), MapName);
+	FParse::Value(*Params, TEXT("Character="), CharacterClassPath);
+	FParse::Value(*Params, TEXT("Output="), OutputPath);
+	const bool bWriteBaseline = FParse::Param(*Params, TEXT("WriteBaseline"));
+	const bool bAllocationCheck = FParse::Param(*Params, TEXT("AllocationCheck"));
+	if (bAllocationCheck)
+	{
+		AllocationWarmupFrames = 60;
+		FParse::Value(*Params, TEXT("AllocationWarmupFrames="), AllocationWarmupFrames);
+		AllocationWarmupFrames = FMath::Max(AllocationWarmupFrames, 0);
+	}
+
+	FAdvancedMovementInputRecording Recording;
+	if (RecordingPath.IsEmpty() || !Recording.LoadFromFile(RecordingPath))
+	{
+		UE_LOGFMT(Movement, Error, "AdvancedMovementReplay: Failed to load the recording '{0}'", *RecordingPath);
+		return 1;
+	}
+	if (MapName.IsEmpty()) MapName = Recording.MapName;
+	if (CharacterClassPath.IsEmpty()) CharacterClassPath = Recording.CharacterClassPath;
+
+	TSubclassOf<ABhopCharacter> CharacterClass = CharacterClassPath.IsEmpty() ? ABhopCharacter::StaticClass() : LoadClass<ABhopCharacter>(nullptr, *CharacterClassPath);
+	if (!CharacterClass)
+	{
+		UE_LOGFMT(Movement, Error, "AdvancedMovementReplay: Failed to load the character class {0}", *CharacterClassPath);
+		return 1;
+	}
+
+	UWorld* World = AdvancedMovementBenchmark::CreateWorld(MapName);
+	if (!World)
+	{
+		UE_LOGFMT(Movement, Error, "AdvancedMovementReplay: Failed to load the map {0}", *MapName);
+		return 1;
+	}
+
+	FAdvancedMovementReplayResult Result;
+	if (bAllocationCheck) FAdvancedMovementAllocations::Install();
+	const bool bReplayed = AdvancedMovementBenchmark::ReplayRecording(Recording, World, CharacterClass, Result, AllocationWarmupFrames);
+	if (bAllocationCheck) FAdvancedMovementAllocations::Uninstall();
+	AdvancedMovementBenchmark::DestroyWorld(World);
+	if (!bReplayed)
+	{
+		UE_LOGFMT(Movement, Error, "AdvancedMovementReplay: Failed to replay {0}", *RecordingPath);
+		return 1;
+	}
+
+	const double P95TickUs = AdvancedMovementBenchmark::GetPercentile(Result.TickUs, 0.95);
+	UE_LOGFMT(Movement, Display, "AdvancedMovementReplay: Replayed {0} frames ({1}s), movement tick mean {2}us, p95 {3}us",
+		Recording.Frames.Num(), Recording.GetDuration(), Result.MeanTickUs, P95TickUs);
+
+
+	// The movement tick shouldn't allocate once it's warmed up
+	if (bAllocationCheck)
+	{
+		if (Recording.Frames.Num() <= AllocationWarmupFrames)
+		{
+			UE_LOGFMT(Movement, Error, "AdvancedMovementReplay: The recording has {0} frames, which is less than the {1} warm up frames of the allocation check",
+				Recording.Frames.Num(), AllocationWarmupFrames);
+			return 1;
+		}
+
+		if (Result.Allocations)
+		{
+			UE_LOGFMT(Movement, Error, "AdvancedMovementReplay: The movement tick made {0} heap allocations ({1} bytes) after {2} warm up frames",
+				Result.Allocations, Result.AllocatedBytes, AllocationWarmupFrames);
+			for (int32 Index = 0; Index < FMath::Min(FAdvancedMovementAllocations::NumCallstacks, FAdvancedMovementAllocations::MaxCallstacks); Index++)
+			{
+				UE_LOGFMT(Movement, Error, "AdvancedMovementReplay: Allocation {0}:\n{1}", Index, *FAdvancedMovementAllocations::GetCallstack(Index));
+			}
+			return 1;
+		}
+
+		UE_LOGFMT(Movement, Display, "AdvancedMovementReplay: The movement tick didn't allocate after {0} warm up frames", AllocationWarmupFrames);
+	}
+
+
+	// Rebaseline the recording
+	if (bWriteBaseline)
+	{
+		Recording.Trajectory = Result.Trajectory;
+		Recording.EndLocation = Result.EndLocation;
+		Recording.EndVelocity = Result.EndVelocity;
+		Recording.BaselineTickUs = Result.MeanTickUs;
+
+		const FString SavePath = OutputPath.IsEmpty() ? RecordingPath : OutputPath;
+		if (!Recording.SaveToFile(SavePath))
+		{
+			UE_LOGFMT(Movement, Error, "AdvancedMovementReplay: Failed to save the baseline to {0}", *SavePath);
+			return 1;
+		}
+
+		UE_LOGFMT(Movement, Display, "AdvancedMovementReplay: Saved the baseline to {0}", *SavePath);
+		return 0;
+	}
+
+
+	// The trajectory and tick cost are checked against the baseline by the AdvancedMovement.Replay automation tests, this only reports how far the replay drifted
+	const double TrajectoryDeviation = AdvancedMovementBenchmark::GetTrajectoryDeviation(Recording.Trajectory, Result.Trajectory);
+	UE_LOGFMT(Movement, Display, "AdvancedMovementReplay: Trajectory deviation {0} (end {1}), baseline speed {2}, replayed speed {3}, baseline tick mean {4}us",
+		TrajectoryDeviation, FVector::Dist(Recording.EndLocation, Result.EndLocation), Recording.EndVelocity.Size2D(), Result.EndVelocity.Size2D(), Recording.BaselineTickUs);
+	return 0;
+}
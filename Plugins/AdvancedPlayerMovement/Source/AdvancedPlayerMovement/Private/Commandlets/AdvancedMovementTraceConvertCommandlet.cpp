@@ -0,0 +1,58 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Commandlets/AdvancedMovementTraceConvertCommandlet.h"
+#include "AdvancedMovementComponent.h"
+#include "Profiling/AdvancedMovementTrace.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Logging/StructuredLog.h"
+
+
+UAdvancedMovementTraceConvertCommandlet::UAdvancedMovementTraceConvertCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = false;
+	LogToConsole = true;
+}
+
+
+int32 UAdvancedMovementTraceConvertCommandlet::Main(const FString& Params)
+{
+	FString TracePath;
+	FString Format = TEXT("csv");
+	FString OutputPath;
+	FParse::Value(*Params, TEXT("Trace="), TracePath);
+	FParse::Value(*Params, TEXT("Format="), Format);
+	FParse::Value(*Params, TEXT("Output="), OutputPath);
+
+	const bool bJson = Format.Equals(TEXT("json"), ESearchCase::IgnoreCase);
+	if (!bJson && !Format.Equals(TEXT("csv"), ESearchCase::IgnoreCase))
+	{
+		UE_LOGFMT(Movement, Error, "AdvancedMovementTraceConvert: Unknown format '{0}', use csv or json", *Format);
+		return 1;
+	}
+
+	FAdvancedMovementTrace Trace;
+	if (TracePath.IsEmpty() || !Trace.LoadFromFile(TracePath))
+	{
+		UE_LOGFMT(Movement, Error, "AdvancedMovementTraceConvert: Failed to load the trace '{0}'", *TracePath);
+		return 1;
+	}
+
+	if (OutputPath.IsEmpty())
+	{
+		OutputPath = FPaths::ChangeExtension(TracePath, bJson ? TEXT(".json") : TEXT(".csv"));
+	}
+
+	if (!FFileHelper::SaveStringToFile(bJson ? Trace.ToJson() : Trace.ToCsv(), *OutputPath))
+	{
+		UE_LOGFMT(Movement, Error, "AdvancedMovementTraceConvert: Failed to write the trace to {0}", *OutputPath);
+		return 1;
+	}
+
+	UE_LOGFMT(Movement, Display, "AdvancedMovementTraceConvert: Wrote {0} substeps of {1} ({2}) to {3}",
+		Trace.Num(), *Trace.CharacterName, *Trace.Reason, *FPaths::ConvertRelativePathToFull(OutputPath));
+	return 0;
+}
@@ -0,0 +1,157 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Ledges/AdvancedMovementLedgeDatabase.h"
+#include "Misc/PackageName.h"
+
+
+bool FAdvancedMovementLedgeBakeSettings::Equals(const FAdvancedMovementLedgeBakeSettings& Other) const
+{
+	return EqualsIgnoringMantleObjects(Other) && MantleObjects == Other.MantleObjects;
+}
+
+
+bool FAdvancedMovementLedgeBakeSettings::EqualsIgnoringMantleObjects(const FAdvancedMovementLedgeBakeSettings& Other) const
+{
+	constexpr float Tolerance = 0.01;
+	return FMath::IsNearlyEqual(CapsuleRadius, Other.CapsuleRadius, Tolerance)
+		&& FMath::IsNearlyEqual(CapsuleHalfHeight, Other.CapsuleHalfHeight, Tolerance)
+		&& FMath::IsNearlyEqual(CrouchedHalfHeight, Other.CrouchedHalfHeight, Tolerance)
+		&& FMath::IsNearlyEqual(MantleTraceHeightOffset, Other.MantleTraceHeightOffset, Tolerance)
+		&& FMath::IsNearlyEqual(MantleSurfaceTraceFromLedgeOffset, Other.MantleSurfaceTraceFromLedgeOffset, Tolerance)
+		&& FMath::IsNearlyEqual(MantleSecondTraceDistance, Other.MantleSecondTraceDistance, Tolerance);
+}
+
+
+FString UAdvancedMovementLedgeDatabase::GetDatabasePath(const FString& MapPackageName)
+{
+	const FString AssetName = FPackageName::GetShortName(MapPackageName) + GetAssetSuffix();
+	return MapPackageName + GetAssetSuffix() + TEXT(".") + AssetName;
+}
+
+
+void UAdvancedMovementLedgeDatabase::Build(TArray<FAdvancedMovementBakedLedge>&& InLedges, const FAdvancedMovementLedgeBakeSettings& InSettings, const float InCellSize, const float InSpacing)
+{
+	Ledges = MoveTemp(InLedges);
+	Settings = InSettings;
+	CellSize = FMath::Max(InCellSize, 1.f);
+	Spacing = InSpacing;
+
+	// Sort the ledges by their cell so every cell is a single range
+	auto GetLedgeCell = [this](const FAdvancedMovementBakedLedge& Ledge)
+	{
+		return GetCell(FVector(Ledge.WallLocation.X, Ledge.WallLocation.Y, Ledge.LedgeLocation.Z));
+	};
+	Ledges.Sort([&GetLedgeCell](const FAdvancedMovementBakedLedge& A, const FAdvancedMovementBakedLedge& B)
+	{
+		const FIntVector CellA = GetLedgeCell(A);
+		const FIntVector CellB = GetLedgeCell(B);
+		if (CellA.X != CellB.X) return CellA.X < CellB.X;
+		if (CellA.Y != CellB.Y) return CellA.Y < CellB.Y;
+		return CellA.Z < CellB.Z;
+	});
+
+	Cells.Reset();
+	for (int32 Index = 0; Index < Ledges.Num(); Index++)
+	{
+		const FIntVector Cell = GetLedgeCell(Ledges[Index]);
+		if (Cells.IsEmpty() || Cells.Last().Cell != Cell)
+		{
+			FAdvancedMovementLedgeCell& LedgeCell = Cells.AddDefaulted_GetRef();
+			LedgeCell.Cell = Cell;
+			LedgeCell.First = Index;
+		}
+		Cells.Last().Num++;
+	}
+
+	BuildCellLookup();
+}
+
+
+const FAdvancedMovementBakedLedge* UAdvancedMovementLedgeDatabase::FindLedge(const FVector& TraceStart, const FVector& TraceEnd, float& OutWallDistance) const
+{
+	const FVector TraceVector = TraceEnd - TraceStart;
+	const float TraceDistance = TraceVector.Size();
+	OutWallDistance = TraceDistance;
+	if (TraceDistance <= 0 || CellLookup.IsEmpty()) return nullptr;
+	const FVector TraceDirection = TraceVector / TraceDistance;
+
+	// Ledges are hashed by their wall location and the ledge's height, which is between the wall trace and the start of the ledge trace
+	FBox Bounds(ForceInit);
+	Bounds += TraceStart;
+	Bounds += TraceEnd + FVector(0, 0, Settings.MantleSecondTraceDistance);
+	Bounds = Bounds.ExpandBy(FVector(Spacing, Spacing, 0));
+	const FIntVector Min = GetCell(Bounds.Min);
+	const FIntVector Max = GetCell(Bounds.Max);
+
+	const FAdvancedMovementBakedLedge* ClosestLedge = nullptr;
+	for (int32 X = Min.X; X <= Max.X; X++)
+	{
+		for (int32 Y = Min.Y; Y <= Max.Y; Y++)
+		{
+			for (int32 Z = Min.Z; Z <= Max.Z; Z++)
+			{
+				const int32* CellIndex = CellLookup.Find(FIntVector(X, Y, Z));
+				if (!CellIndex) continue;
+
+				const FAdvancedMovementLedgeCell& Cell = Cells[*CellIndex];
+				for (int32 Index = Cell.First; Index < Cell.First + Cell.Num; Index++)
+				{
+					const FAdvancedMovementBakedLedge& Ledge = Ledges[Index];
+
+					// Find where the wall trace hits the ledge's wall
+					const float Approach = TraceDirection.Dot(Ledge.WallNormal);
+					if (Approach > -UE_KINDA_SMALL_NUMBER) continue;
+					const float WallDistance = (Ledge.WallLocation - TraceStart).Dot(Ledge.WallNormal) / Approach;
+					if (WallDistance < 0 || WallDistance > TraceDistance) continue;
+
+					// The ledge has to be within the ledge trace, and the wall hit has to be within the samples that found this ledge
+					const float LedgeHeight = Ledge.LedgeLocation.Z - TraceStart.Z;
+					if (LedgeHeight < 0 || LedgeHeight > Settings.MantleSecondTraceDistance) continue;
+					const FVector WallHit = TraceStart + TraceDirection * WallDistance;
+					if (FVector::DistSquared2D(WallHit, Ledge.WallLocation) > FMath::Square(Spacing)) continue;
+
+					// The wall trace hits the closest wall, and the ledge trace finds the highest surface above it
+					if (ClosestLedge)
+					{
+						if (WallDistance > OutWallDistance + 1) continue;
+						if (WallDistance > OutWallDistance - 1 && Ledge.LedgeLocation.Z <= ClosestLedge->LedgeLocation.Z) continue;
+					}
+
+					ClosestLedge = &Ledge;
+					OutWallDistance = WallDistance;
+				}
+			}
+		}
+	}
+
+	return ClosestLedge;
+}
+
+
+void UAdvancedMovementLedgeDatabase::PostLoad()
+{
+	Super::PostLoad();
+	BuildCellLookup();
+}
+
+
+void UAdvancedMovementLedgeDatabase::BuildCellLookup()
+{
+	CellLookup.Reset();
+	CellLookup.Reserve(Cells.Num());
+	for (int32 Index = 0; Index < Cells.Num(); Index++)
+	{
+		CellLookup.Add(Cells[Index].Cell, Index);
+	}
+}
+
+
+FIntVector UAdvancedMovementLedgeDatabase::GetCell(const FVector& Location) const
+{
+	return FIntVector(
+		FMath::FloorToInt(Location.X / CellSize),
+		FMath::FloorToInt(Location.Y / CellSize),
+		FMath::FloorToInt(Location.Z / CellSize)
+	);
+}
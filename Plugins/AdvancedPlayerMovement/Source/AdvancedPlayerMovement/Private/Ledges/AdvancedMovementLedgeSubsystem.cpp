@@ -0,0 +1,27 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Ledges/AdvancedMovementLedgeSubsystem.h"
+#include "Ledges/AdvancedMovementLedgeDatabase.h"
+#include "AdvancedMovementComponent.h"
+#include "Engine/World.h"
+#include "Logging/StructuredLog.h"
+
+
+void UAdvancedMovementLedgeSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	const FString MapPackageName = UWorld::RemovePIEPrefix(InWorld.GetOutermost()->GetName());
+	Database = LoadObject<UAdvancedMovementLedgeDatabase>(nullptr, *UAdvancedMovementLedgeDatabase::GetDatabasePath(MapPackageName), nullptr, LOAD_NoWarn | LOAD_Quiet);
+	if (Database)
+	{
+		UE_LOGFMT(Movement, Log, "{0}: Loaded {1} baked ledges for {2}", *GetName(), Database->GetLedges().Num(), *MapPackageName);
+	}
+}
+
+
+bool UAdvancedMovementLedgeSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
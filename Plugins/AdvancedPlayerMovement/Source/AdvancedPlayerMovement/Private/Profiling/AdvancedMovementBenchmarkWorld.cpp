@@ -0,0 +1,215 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Profiling/AdvancedMovementBenchmarkWorld.h"
+#include "AdvancedMovementComponent.h"
+#include "Character/BhopCharacter.h"
+#include "Profiling/AdvancedMovementInput.h"
+#include "Profiling/AdvancedMovementInputRecording.h"
+#include "Profiling/AdvancedMovementProfiling.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "GameFramework/PlayerStart.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "Misc/App.h"
+#include "UObject/Package.h"
+
+
+UWorld* AdvancedMovementBenchmark::CreateWorld(const FString& MapName)
+{
+	UPackage* Package = LoadPackage(nullptr, *MapName, LOAD_None);
+	UWorld* World = Package ? UWorld::FindWorldInPackage(Package) : nullptr;
+	if (!World || !GEngine)
+	{
+		return nullptr;
+	}
+
+	World->WorldType = EWorldType::Game;
+	World->AddToRoot();
+
+	FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+	WorldContext.SetCurrentWorld(World);
+
+	if (!World->bIsWorldInitialized)
+	{
+		World->InitWorld(UWorld::InitializationValues()
+			.AllowAudioPlayback(false)
+			.CreatePhysicsScene(true)
+			.CreateNavigation(false)
+			.CreateAISystem(false)
+			.ShouldSimulatePhysics(true)
+			.EnableTraceCollision(true)
+		);
+	}
+
+	const FURL URL;
+	World->SetGameMode(URL);
+	World->UpdateWorldComponents(true, true);
+	World->InitializeActorsForPlay(URL);
+	World->BeginPlay();
+	return World;
+}
+
+
+void AdvancedMovementBenchmark::DestroyWorld(UWorld* World)
+{
+	if (!World || !GEngine)
+	{
+		return;
+	}
+
+	GEngine->DestroyWorldContext(World);
+	World->DestroyWorld(false);
+	World->RemoveFromRoot();
+	CollectGarbage(RF_NoFlags);
+}
+
+
+TArray<ABhopCharacter*> AdvancedMovementBenchmark::SpawnCharacters(UWorld* World, const int32 Count, TSubclassOf<ABhopCharacter> CharacterClass, const float Spacing)
+{
+	TArray<ABhopCharacter*> Characters;
+	if (!World || Count <= 0)
+	{
+		return Characters;
+	}
+
+	FVector Origin = FVector(0, 0, 200);
+	for (TActorIterator<APlayerStart> It(World); It; ++It)
+	{
+		Origin = It->GetActorLocation();
+		break;
+	}
+
+	const int32 Columns = FMath::CeilToInt(FMath::Sqrt(static_cast<float>(Count)));
+	Characters.Reserve(Count);
+	for (int32 Index = 0; Index < Count; Index++)
+	{
+		const FVector Offset = FVector((Index % Columns) - Columns / 2, (Index / Columns) - Columns / 2, 0) * Spacing;
+		if (ABhopCharacter* Character = SpawnCharacter(World, Origin + Offset, FRotator::ZeroRotator, CharacterClass))
+		{
+			Characters.Add(Character);
+		}
+	}
+
+	return Characters;
+}
+
+
+ABhopCharacter* AdvancedMovementBenchmark::SpawnCharacter(UWorld* World, const FVector& Location, const FRotator& Rotation, TSubclassOf<ABhopCharacter> CharacterClass)
+{
+	if (!World)
+	{
+		return nullptr;
+	}
+	if (!CharacterClass)
+	{
+		CharacterClass = ABhopCharacter::StaticClass();
+	}
+
+	FActorSpawnParameters SpawnParameters;
+	SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
+	ABhopCharacter* Character = World->SpawnActor<ABhopCharacter>(CharacterClass, Location, Rotation, SpawnParameters);
+	if (Character && Character->GetCharacterMovement())
+	{
+		Character->GetCharacterMovement()->bRunPhysicsWithNoController = true;
+	}
+
+	return Character;
+}
+
+
+void AdvancedMovementBenchmark::TickWorld(UWorld* World, const float DeltaTime)
+{
+	if (!World)
+	{
+		return;
+	}
+
+	FApp::SetDeltaTime(DeltaTime);
+	FApp::SetCurrentTime(FApp::GetCurrentTime() + DeltaTime);
+	World->Tick(LEVELTICK_All, DeltaTime);
+	GFrameCounter++;
+}
+
+
+bool AdvancedMovementBenchmark::ReplayRecording(const FAdvancedMovementInputRecording& Recording, UWorld* World, TSubclassOf<ABhopCharacter> CharacterClass,
+	FAdvancedMovementReplayResult& OutResult, const int32 AllocationWarmupFrames)
+{
+	ABhopCharacter* Character = SpawnCharacter(World, Recording.StartLocation, Recording.StartRotation, CharacterClass);
+	UAdvancedMovementComponent* MovementComponent = Character ? Cast<UAdvancedMovementComponent>(Character->GetCharacterMovement()) : nullptr;
+	if (!MovementComponent)
+	{
+		return false;
+	}
+
+	MovementComponent->SetMovementMode(static_cast<EMovementMode>(Recording.StartMovementMode), Recording.StartCustomMovementMode);
+	MovementComponent->Velocity = Recording.StartVelocity;
+
+	OutResult = FAdvancedMovementReplayResult();
+	FAdvancedMovementAllocations::Reset();
+	float PrevWallJumpTime = MovementComponent->GetPreviousWallJumpTime();
+	OutResult.TickUs.Reserve(Recording.Frames.Num());
+	OutResult.Trajectory.Reserve(Recording.Frames.Num() / FAdvancedMovementInputRecording::TrajectoryInterval);
+	for (int32 Frame = 0; Frame < Recording.Frames.Num(); Frame++)
+	{
+		const FAdvancedMovementInputFrame& InputFrame = Recording.Frames[Frame];
+		AdvancedMovementInput::ApplyInputFrame(Character, MovementComponent, InputFrame);
+
+		FAdvancedMovementPhysicsTimings::bEnabled = true;
+		FAdvancedMovementPhysicsTimings::Reset();
+		FAdvancedMovementAllocations::bEnabled = AllocationWarmupFrames != INDEX_NONE && Frame >= AllocationWarmupFrames;
+		TickWorld(World, InputFrame.DeltaTime);
+		FAdvancedMovementAllocations::bEnabled = false;
+		FAdvancedMovementPhysicsTimings::bEnabled = false;
+
+		uint64 Cycles = 0;
+		for (const uint64 PhysicsCycles : FAdvancedMovementPhysicsTimings::Cycles) Cycles += PhysicsCycles;
+		for (const uint64 PhysicsCalls : FAdvancedMovementPhysicsTimings::Calls) OutResult.PhysicsCalls += PhysicsCalls;
+		OutResult.TickUs.Add(FPlatformTime::ToMilliseconds64(Cycles) * 1000.0);
+
+		if (MovementComponent->GetPreviousWallJumpTime() != PrevWallJumpTime)
+		{
+			PrevWallJumpTime = MovementComponent->GetPreviousWallJumpTime();
+			OutResult.WallJumps++;
+		}
+
+		if ((Frame + 1) % FAdvancedMovementInputRecording::TrajectoryInterval == 0)
+		{
+			OutResult.Trajectory.Add(Character->GetActorLocation());
+		}
+	}
+
+	OutResult.EndLocation = Character->GetActorLocation();
+	OutResult.EndVelocity = MovementComponent->Velocity;
+	OutResult.Allocations = FAdvancedMovementAllocations::Allocations;
+	OutResult.AllocatedBytes = FAdvancedMovementAllocations::Bytes;
+
+	double TotalTickUs = 0;
+	for (const double TickUs : OutResult.TickUs) TotalTickUs += TickUs;
+	OutResult.MeanTickUs = OutResult.TickUs.Num() ? TotalTickUs / OutResult.TickUs.Num() : 0;
+	OutResult.TickUs.Sort();
+
+	Character->Destroy();
+	return true;
+}
+
+
+double AdvancedMovementBenchmark::GetTrajectoryDeviation(const TArray<FVector>& Baseline, const TArray<FVector>& Trajectory)
+{
+	double Deviation = 0;
+	for (int32 Index = 0; Index < FMath::Min(Baseline.Num(), Trajectory.Num()); Index++)
+	{
+		Deviation = FMath::Max(Deviation, FVector::Dist(Baseline[Index], Trajectory[Index]));
+	}
+
+	return Deviation;
+}
+
+
+double AdvancedMovementBenchmark::GetPercentile(const TArray<double>& SortedSamples, const double Percentile)
+{
+	if (SortedSamples.IsEmpty()) return 0;
+	const int32 Index = FMath::Clamp(FMath::CeilToInt(Percentile * SortedSamples.Num()) - 1, 0, SortedSamples.Num() - 1);
+	return SortedSamples[Index];
+}
@@ -0,0 +1,86 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Profiling/AdvancedMovementInput.h"
+#include "AdvancedMovementComponent.h"
+#include "GameFramework/Character.h"
+#include "GameFramework/Controller.h"
+
+
+FAdvancedMovementInputFrame AdvancedMovementInput::EvaluateStrafeScript(const int32 Seed, const float Time, const float DeltaTime)
+{
+	FAdvancedMovementInputFrame Frame;
+	Frame.DeltaTime = DeltaTime;
+
+	const float Phase = Time + Seed * 0.37f;
+	const float StrafePeriod = 1.2f;
+	const float StrafeCycle = FMath::Fmod(Phase, StrafePeriod) / StrafePeriod; // 0-1
+	const bool bStrafeRight = StrafeCycle < 0.5f;
+
+	// Turn into the strafe direction (triangle wave so the turn rate is constant)
+	const float BaseYaw = (Seed * 37) % 360;
+	const float TurnAmount = bStrafeRight ? 4.f * StrafeCycle - 1.f : 3.f - 4.f * StrafeCycle;
+	Frame.Yaw = FRotator::NormalizeAxis(BaseYaw + TurnAmount * 45.f);
+	Frame.Input = FVector2D(0, bStrafeRight ? 1 : -1);
+
+	// Every eight seconds land, sprint, and slide before bhopping again
+	const float Segment = FMath::Fmod(Phase, 8.f);
+	if (Segment < 0.5f || Segment > 6.f)
+	{
+		Frame.Input = FVector2D(1, 0);
+		Frame.Yaw = FRotator::NormalizeAxis(BaseYaw);
+		Frame.Buttons |= EAdvancedMovementInputButtons::Sprint;
+		if (Segment > 6.5f) Frame.Buttons |= EAdvancedMovementInputButtons::Crouch;
+	}
+	else
+	{
+		Frame.Buttons |= EAdvancedMovementInputButtons::Jump;
+	}
+
+	// Tap wall jump, it's only used if there's a wall nearby
+	if (FMath::Fmod(Phase, 1.5f) < 0.1f)
+	{
+		Frame.Buttons |= EAdvancedMovementInputButtons::WallJump;
+	}
+
+	return Frame;
+}
+
+
+void AdvancedMovementInput::ApplyInputFrame(ACharacter* Character, UAdvancedMovementComponent* MovementComponent, const FAdvancedMovementInputFrame& Frame)
+{
+	if (!Character || !MovementComponent) return;
+
+	// Rotation
+	const FRotator Rotation(0, Frame.Yaw, 0);
+	if (AController* Controller = Character->GetController())
+	{
+		Controller->SetControlRotation(Rotation);
+	}
+	Character->SetActorRotation(Rotation);
+
+	// Movement input
+	const FRotationMatrix RotationMatrix(Rotation);
+	MovementComponent->UpdatePlayerInput(Frame.Input);
+	Character->AddMovementInput(RotationMatrix.GetUnitAxis(EAxis::X), Frame.Input.X);
+	Character->AddMovementInput(RotationMatrix.GetUnitAxis(EAxis::Y), Frame.Input.Y);
+
+	// Buttons
+	if (Frame.IsPressed(EAdvancedMovementInputButtons::Jump)) Character->Jump();
+	else Character->StopJumping();
+
+	if (Frame.IsPressed(EAdvancedMovementInputButtons::Crouch)) Character->Crouch();
+	else Character->UnCrouch();
+
+	if (Frame.IsPressed(EAdvancedMovementInputButtons::WallJump)) MovementComponent->StartWallJump();
+	else MovementComponent->StopWallJump();
+
+	if (Frame.IsPressed(EAdvancedMovementInputButtons::Sprint)) MovementComponent->StartSprinting();
+	else MovementComponent->StopSprinting();
+
+	if (Frame.IsPressed(EAdvancedMovementInputButtons::Aim)) MovementComponent->StartAiming();
+	else MovementComponent->StopAiming();
+
+	if (Frame.IsPressed(EAdvancedMovementInputButtons::Mantle)) MovementComponent->StartMantling();
+	else MovementComponent->StopMantling();
+}
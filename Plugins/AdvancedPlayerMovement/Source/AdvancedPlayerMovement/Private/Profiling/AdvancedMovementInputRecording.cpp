@@ -0,0 +1,146 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Profiling/AdvancedMovementInputRecording.h"
+#include "HAL/FileManager.h"
+#include "Serialization/Archive.h"
+
+
+float FAdvancedMovementInputRecording::GetDuration() const
+{
+	float Duration = 0;
+	for (const FAdvancedMovementInputFrame& Frame : Frames) Duration += Frame.DeltaTime;
+	return Duration;
+}
+
+
+TArray<FAdvancedMovementInputFrame> FAdvancedMovementInputRecording::Resample(const float FrameRate) const
+{
+	TArray<FAdvancedMovementInputFrame> Resampled;
+	if (FrameRate <= 0 || Frames.IsEmpty()) return Resampled;
+
+	// Frame boundaries that are this close together are treated as the same time, so resampling at the recorded frame rate returns the recorded frames
+	constexpr double Tolerance = 0.0001;
+	const double DeltaTime = 1.0 / FrameRate;
+	const int32 FrameCount = FMath::Max(FMath::RoundToInt(GetDuration() * FrameRate), 1);
+	Resampled.Reserve(FrameCount);
+
+	int32 Source = 0;
+	double SourceStart = 0;
+	for (int32 Frame = 0; Frame < FrameCount; Frame++)
+	{
+		const double Start = Frame * DeltaTime;
+		const double End = Start + DeltaTime;
+
+		// Find the recorded frame that's active at the start of this frame
+		while (Source < Frames.Num() - 1 && SourceStart + Frames[Source].DeltaTime <= Start + Tolerance)
+		{
+			SourceStart += Frames[Source].DeltaTime;
+			Source++;
+		}
+
+		const FAdvancedMovementInputFrame& Current = Frames[Source];
+		const FAdvancedMovementInputFrame& Next = Frames[FMath::Min(Source + 1, Frames.Num() - 1)];
+		const float Alpha = Current.DeltaTime > 0 ? FMath::Clamp(static_cast<float>((Start - SourceStart) / Current.DeltaTime), 0.f, 1.f) : 0;
+
+		FAdvancedMovementInputFrame& ResampledFrame = Resampled.AddDefaulted_GetRef();
+		ResampledFrame.DeltaTime = static_cast<float>(DeltaTime);
+		ResampledFrame.Input = Current.Input;
+		ResampledFrame.Yaw = FRotator::NormalizeAxis(Current.Yaw + FMath::FindDeltaAngleDegrees(Current.Yaw, Next.Yaw) * Alpha);
+
+		// Hold every button that was pressed during this frame
+		double OverlapStart = SourceStart;
+		for (int32 Overlap = Source; Overlap < Frames.Num() && OverlapStart < End - Tolerance; Overlap++)
+		{
+			ResampledFrame.Buttons |= Frames[Overlap].Buttons;
+			OverlapStart += Frames[Overlap].DeltaTime;
+		}
+	}
+
+	return Resampled;
+}
+
+
+bool FAdvancedMovementInputRecording::Serialize(FArchive& Ar)
+{
+	uint32 Magic = FileMagic;
+	uint32 Version = FileVersion;
+	Ar << Magic;
+	Ar << Version;
+	if (Magic != FileMagic || Version != FileVersion)
+	{
+		Ar.SetError();
+		return false;
+	}
+
+	Ar << MapName;
+	Ar << CharacterClassPath;
+	Ar << StartLocation;
+	Ar << StartRotation;
+	Ar << StartVelocity;
+	Ar << StartMovementMode;
+	Ar << StartCustomMovementMode;
+	Ar << EndLocation;
+	Ar << EndVelocity;
+	Ar << BaselineTickUs;
+
+	// Frames are quantized, the input is a normalized axis value and a byte is more than enough precision for it
+	int32 NumFrames = Frames.Num();
+	Ar << NumFrames;
+	if (Ar.IsLoading())
+	{
+		if (NumFrames < 0)
+		{
+			Ar.SetError();
+			return false;
+		}
+		Frames.SetNum(NumFrames);
+	}
+
+	for (FAdvancedMovementInputFrame& Frame : Frames)
+	{
+		int8 InputX = FMath::RoundToInt(FMath::Clamp(Frame.Input.X, -1.f, 1.f) * 127.f);
+		int8 InputY = FMath::RoundToInt(FMath::Clamp(Frame.Input.Y, -1.f, 1.f) * 127.f);
+		uint8 Buttons = static_cast<uint8>(Frame.Buttons);
+		Ar << Frame.DeltaTime;
+		Ar << Frame.Yaw;
+		Ar << InputX;
+		Ar << InputY;
+		Ar << Buttons;
+
+		if (Ar.IsLoading())
+		{
+			Frame.Input = FVector2D(InputX / 127.f, InputY / 127.f);
+			Frame.Buttons = static_cast<EAdvancedMovementInputButtons>(Buttons);
+		}
+	}
+
+	Ar << Trajectory;
+	return !Ar.IsError();
+}
+
+
+bool FAdvancedMovementInputRecording::SaveToFile(const FString& FilePath)
+{
+	TUniquePtr<FArchive> Writer(IFileManager::Get().CreateFileWriter(*FilePath));
+	if (!Writer)
+	{
+		return false;
+	}
+
+	Serialize(*Writer);
+	return Writer->Close();
+}
+
+
+bool FAdvancedMovementInputRecording::LoadFromFile(const FString& FilePath)
+{
+	TUniquePtr<FArchive> Reader(IFileManager::Get().CreateFileReader(*FilePath));
+	if (!Reader)
+	{
+		return false;
+	}
+
+	const bool bSuccess = Serialize(*Reader);
+	return Reader->Close() && bSuccess;
+}
@@ -0,0 +1,132 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Profiling/AdvancedMovementProbeSubsystem.h"
+#include "Profiling/AdvancedMovementProfiling.h"
+#include "Physics/PhysicsInterfaceCore.h"
+#include "Engine/World.h"
+#include "Async/ParallelFor.h"
+#include "HAL/IConsoleManager.h"
+
+
+DECLARE_CYCLE_STAT(TEXT("Probe Batch"), STAT_AdvancedMovement_ProbeBatch, STATGROUP_AdvancedMovement);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Batched Probes"), STAT_AdvancedMovement_BatchedProbes, STATGROUP_AdvancedMovement);
+
+namespace AdvancedMovementCVars
+{
+	static int32 ProbeBatchMinParallel = 16;
+	FAutoConsoleVariableRef CVarProbeBatchMinParallel(
+		TEXT("AdvancedMovement.ProbeBatchMinParallel"),
+		ProbeBatchMinParallel,
+		TEXT("The amount of probes in a batch before they're run on worker threads, smaller batches run on the game thread"),
+		ECVF_Default
+	);
+}
+
+
+void UAdvancedMovementProbeSubsystem::Tick(float DeltaTime)
+{
+	ADVANCED_MOVEMENT_SCOPE_CYCLE_COUNTER(ProbeBatch);
+
+	// The pending probes become the completed batch, and the last batch's results are discarded
+	Swap(CompletedProbes, PendingProbes);
+	PendingProbes.Reset();
+	CompletedBatch = PendingBatch++;
+	if (CompletedProbes.IsEmpty() || !GetWorld()) return;
+	INC_DWORD_STAT_BY(STAT_AdvancedMovement_BatchedProbes, CompletedProbes.Num());
+
+	// Nothing writes to the scene while the batch is running, every query only takes the read lock
+	const EParallelForFlags Flags = CompletedProbes.Num() < AdvancedMovementCVars::ProbeBatchMinParallel ? EParallelForFlags::ForceSingleThread : EParallelForFlags::None;
+	FPhysicsCommand::ExecuteRead(GetWorld()->GetPhysicsScene(), [this, Flags]()
+	{
+		ParallelFor(CompletedProbes.Num(), [this](const int32 Index)
+		{
+			RunProbe(CompletedProbes[Index]);
+		}, Flags);
+	});
+}
+
+
+TStatId UAdvancedMovementProbeSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UAdvancedMovementProbeSubsystem, STATGROUP_Tickables);
+}
+
+
+FAdvancedMovementProbeHandle UAdvancedMovementProbeSubsystem::AddLineTraceByChannel(const FVector& Start, const FVector& End, const ECollisionChannel Channel, const FCollisionQueryParams& QueryParams)
+{
+	FAdvancedMovementProbe Probe;
+	Probe.Start = Start;
+	Probe.End = End;
+	Probe.Channel = Channel;
+	Probe.QueryParams = QueryParams;
+	return AddProbe(MoveTemp(Probe));
+}
+
+
+FAdvancedMovementProbeHandle UAdvancedMovementProbeSubsystem::AddLineTraceByObjectType(const FVector& Start, const FVector& End, const FCollisionObjectQueryParams& ObjectParams, const FCollisionQueryParams& QueryParams)
+{
+	FAdvancedMovementProbe Probe;
+	Probe.Start = Start;
+	Probe.End = End;
+	Probe.ObjectParams = ObjectParams;
+	Probe.QueryParams = QueryParams;
+	Probe.bByObjectType = true;
+	return AddProbe(MoveTemp(Probe));
+}
+
+
+FAdvancedMovementProbeHandle UAdvancedMovementProbeSubsystem::AddOverlapByChannel(const FVector& Location, const FQuat& Rotation, const ECollisionChannel Channel, const FCollisionShape& Shape,
+	const FCollisionQueryParams& QueryParams, const FCollisionResponseParams& ResponseParams)
+{
+	FAdvancedMovementProbe Probe;
+	Probe.Start = Location;
+	Probe.End = Location;
+	Probe.Rotation = Rotation;
+	Probe.Shape = Shape;
+	Probe.Channel = Channel;
+	Probe.QueryParams = QueryParams;
+	Probe.ResponseParams = ResponseParams;
+	Probe.bOverlap = true;
+	return AddProbe(MoveTemp(Probe));
+}
+
+
+const FAdvancedMovementProbe* UAdvancedMovementProbeSubsystem::GetResult(const FAdvancedMovementProbeHandle& Handle) const
+{
+	if (!Handle.IsValid() || Handle.Batch != CompletedBatch || !CompletedProbes.IsValidIndex(Handle.Index)) return nullptr;
+	return &CompletedProbes[Handle.Index];
+}
+
+
+bool UAdvancedMovementProbeSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+
+FAdvancedMovementProbeHandle UAdvancedMovementProbeSubsystem::AddProbe(FAdvancedMovementProbe&& Probe)
+{
+	FAdvancedMovementProbeHandle Handle;
+	Handle.Index = PendingProbes.Add(MoveTemp(Probe));
+	Handle.Batch = PendingBatch;
+	return Handle;
+}
+
+
+void UAdvancedMovementProbeSubsystem::RunProbe(FAdvancedMovementProbe& Probe) const
+{
+	const UWorld* World = GetWorld();
+	if (Probe.bOverlap)
+	{
+		Probe.bBlockingHit = World->OverlapBlockingTestByChannel(Probe.Start, Probe.Rotation, Probe.Channel, Probe.Shape, Probe.QueryParams, Probe.ResponseParams);
+	}
+	else if (Probe.bByObjectType)
+	{
+		Probe.bBlockingHit = World->SweepSingleByObjectType(Probe.Hit, Probe.Start, Probe.End, Probe.Rotation, Probe.ObjectParams, Probe.Shape, Probe.QueryParams);
+	}
+	else
+	{
+		Probe.bBlockingHit = World->SweepSingleByChannel(Probe.Hit, Probe.Start, Probe.End, Probe.Rotation, Probe.Channel, Probe.Shape, Probe.QueryParams, Probe.ResponseParams);
+	}
+}
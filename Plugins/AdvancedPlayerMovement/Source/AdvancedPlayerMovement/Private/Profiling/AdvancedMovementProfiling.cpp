@@ -0,0 +1,272 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Profiling/AdvancedMovementProfiling.h"
+#include "HAL/MemoryBase.h"
+#include "HAL/PlatformStackWalk.h"
+
+
+UE_TRACE_CHANNEL_DEFINE(AdvancedMovementChannel);
+
+
+bool FAdvancedMovementPhysicsTimings::bEnabled = false;
+uint64 FAdvancedMovementPhysicsTimings::Cycles[static_cast<uint8>(EAdvancedMovementPhysics::MAX)] = {};
+uint32 FAdvancedMovementPhysicsTimings::Calls[static_cast<uint8>(EAdvancedMovementPhysics::MAX)] = {};
+EAdvancedMovementPhysics FAdvancedMovementPhysicsTimings::Current = EAdvancedMovementPhysics::MAX;
+uint64 FAdvancedMovementPhysicsTimings::StartCycles = 0;
+
+
+void FAdvancedMovementPhysicsTimings::Reset()
+{
+	FMemory::Memzero(Cycles);
+	FMemory::Memzero(Calls);
+	StartCycles = FPlatformTime::Cycles64();
+}
+
+
+const TCHAR* FAdvancedMovementPhysicsTimings::GetName(const EAdvancedMovementPhysics Physics)
+{
+	switch (Physics)
+	{
+		case EAdvancedMovementPhysics::Walking:			return TEXT("PhysWalking");
+		case EAdvancedMovementPhysics::Slide:			return TEXT("PhysSlide");
+		case EAdvancedMovementPhysics::Falling:			return TEXT("FallingMovementPhysics");
+		case EAdvancedMovementPhysics::WallRunning:		return TEXT("PhysWallRunning");
+		case EAdvancedMovementPhysics::WallClimbing:	return TEXT("PhysWallClimbing");
+		case EAdvancedMovementPhysics::Mantling:		return TEXT("PhysMantling");
+		case EAdvancedMovementPhysics::LedgeClimbing:	return TEXT("PhysLedgeClimbing");
+		case EAdvancedMovementPhysics::Other:			return TEXT("Other");
+		default:										return TEXT("None");
+	}
+}
+
+
+
+
+bool FAdvancedMovementAllocations::bEnabled = false;
+int32 FAdvancedMovementAllocations::ScopeDepth = 0;
+uint64 FAdvancedMovementAllocations::Allocations = 0;
+uint64 FAdvancedMovementAllocations::Bytes = 0;
+uint64 FAdvancedMovementAllocations::Callstacks[MaxCallstacks][CallstackDepth] = {};
+int32 FAdvancedMovementAllocations::CallstackDepths[MaxCallstacks] = {};
+int32 FAdvancedMovementAllocations::NumCallstacks = 0;
+
+
+namespace
+{
+	/** Forwards everything to the original allocator, and counts the game thread's allocations while it's inside the movement tick */
+	class FAdvancedMovementAllocationCounter final : public FMalloc
+	{
+	public:
+		explicit FAdvancedMovementAllocationCounter(FMalloc* InInner) : Inner(InInner) {}
+
+		/** The allocator this wraps */
+		FMalloc* Inner;
+
+		virtual void* Malloc(SIZE_T Size, uint32 Alignment) override { CountAllocation(Size); return Inner->Malloc(Size, Alignment); }
+		virtual void* TryMalloc(SIZE_T Size, uint32 Alignment) override { CountAllocation(Size); return Inner->TryMalloc(Size, Alignment); }
+		virtual void* Realloc(void* Original, SIZE_T Size, uint32 Alignment) override { if (Size) CountAllocation(Size); return Inner->Realloc(Original, Size, Alignment); }
+		virtual void* TryRealloc(void* Original, SIZE_T Size, uint32 Alignment) override { if (Size) CountAllocation(Size); return Inner->TryRealloc(Original, Size, Alignment); }
+		virtual void Free(void* Original) override { Inner->Free(Original); }
+		virtual SIZE_T QuantizeSize(SIZE_T Size, uint32 Alignment) override { return Inner->QuantizeSize(Size, Alignment); }
+		virtual bool GetAllocationSize(void* Original, SIZE_T& SizeOut) override { return Inner->GetAllocationSize(Original, SizeOut); }
+		virtual void Trim(bool bTrimThreadCaches) override { Inner->Trim(bTrimThreadCaches); }
+		virtual void SetupTLSCachesOnCurrentThread() override { Inner->SetupTLSCachesOnCurrentThread(); }
+		virtual void ClearAndDisableTLSCachesOnCurrentThread() override { Inner->ClearAndDisableTLSCachesOnCurrentThread(); }
+		virtual void UpdateStats() override { Inner->UpdateStats(); }
+		virtual void GetAllocatorStats(FGenericMemoryStats& OutStats) override { Inner->GetAllocatorStats(OutStats); }
+		virtual void DumpAllocatorStats(FOutputDevice& Ar) override { Inner->DumpAllocatorStats(Ar); }
+		virtual bool IsInternallyThreadSafe() const override { return Inner->IsInternallyThreadSafe(); }
+		virtual bool ValidateHeap() override { return Inner->ValidateHeap(); }
+		virtual const TCHAR* GetDescriptiveName() override { return Inner->GetDescriptiveName(); }
+
+	private:
+		/** Whether the game thread is capturing a callstack, which shouldn't be counted */
+		bool bCapturing = false;
+
+		void CountAllocation(const SIZE_T Size)
+		{
+			if (!FAdvancedMovementAllocations::bEnabled || FAdvancedMovementAllocations::ScopeDepth <= 0 || !IsInGameThread() || bCapturing) return;
+
+			FAdvancedMovementAllocations::Allocations++;
+			FAdvancedMovementAllocations::Bytes += Size;
+			if (FAdvancedMovementAllocations::NumCallstacks < FAdvancedMovementAllocations::MaxCallstacks)
+			{
+				bCapturing = true;
+				const int32 Index = FAdvancedMovementAllocations::NumCallstacks++;
+				FAdvancedMovementAllocations::CallstackDepths[Index] = FPlatformStackWalk::CaptureStackBackTrace(FAdvancedMovementAllocations::Callstacks[Index], FAdvancedMovementAllocations::CallstackDepth);
+				bCapturing = false;
+			}
+		}
+	};
+
+	FAdvancedMovementAllocationCounter* AllocationCounter = nullptr;
+}
+
+
+void FAdvancedMovementAllocations::Install()
+{
+	if (AllocationCounter && GMalloc == AllocationCounter) return;
+
+	FPlatformStackWalk::InitStackWalking();
+	if (!AllocationCounter || AllocationCounter->Inner != GMalloc) AllocationCounter = new FAdvancedMovementAllocationCounter(GMalloc);
+	FPlatformMisc::MemoryBarrier();
+	GMalloc = AllocationCounter;
+	FPlatformMisc::MemoryBarrier();
+}
+
+
+void FAdvancedMovementAllocations::Uninstall()
+{
+	if (!AllocationCounter || GMalloc != AllocationCounter) return;
+
+	bEnabled = false;
+	FPlatformMisc::MemoryBarrier();
+	GMalloc = AllocationCounter->Inner;
+	FPlatformMisc::MemoryBarrier();
+}
+
+
+void FAdvancedMovementAllocations::Reset()
+{
+	Allocations = 0;
+	Bytes = 0;
+	NumCallstacks = 0;
+}
+
+
+FString FAdvancedMovementAllocations::GetCallstack(const int32 Index)
+{
+	if (Index < 0 || Index >= FMath::Min(NumCallstacks, MaxCallstacks)) return FString();
+
+	FString Callstack;
+	for (int32 Frame = 0; Frame < CallstackDepths[Index]; Frame++)
+	{
+		ANSICHAR Line[1024] = {};
+		FPlatformStackWalk::ProgramCounterToHumanReadableString(Frame, Callstacks[Index][Frame], Line, sizeof(Line));
+		Callstack += FString::Printf(TEXT("\t%s\n"), ANSI_TO_TCHAR(Line));
+	}
+	return Callstack;
+}
+
+
+
+
+void FAdvancedMovementSceneQueryStats::Append(const FAdvancedMovementSceneQueryStats& Other)
+{
+	for (int32 Query = 0; Query < static_cast<int32>(EAdvancedMovementQuery::MAX); Query++)
+	{
+		for (int32 Mode = 0; Mode < static_cast<int32>(EAdvancedMovementPhysics::MAX); Mode++) ByMode[Mode][Query] += Other.ByMode[Mode][Query];
+		for (int32 Source = 0; Source < static_cast<int32>(EAdvancedMovementQuerySource::MAX); Source++) BySource[Source][Query] += Other.BySource[Source][Query];
+	}
+}
+
+
+void FAdvancedMovementSceneQueryStats::Reset()
+{
+	FMemory::Memzero(ByMode);
+	FMemory::Memzero(BySource);
+}
+
+
+uint32 FAdvancedMovementSceneQueryStats::GetTotal() const
+{
+	uint32 Total = 0;
+	for (int32 Query = 0; Query < static_cast<int32>(EAdvancedMovementQuery::MAX); Query++)
+	{
+		Total += GetQueryTotal(static_cast<EAdvancedMovementQuery>(Query));
+	}
+	return Total;
+}
+
+
+uint32 FAdvancedMovementSceneQueryStats::GetQueryTotal(const EAdvancedMovementQuery Query) const
+{
+	uint32 Total = 0;
+	for (int32 Source = 0; Source < static_cast<int32>(EAdvancedMovementQuerySource::MAX); Source++)
+	{
+		Total += BySource[Source][static_cast<uint8>(Query)];
+	}
+	return Total;
+}
+
+
+uint32 FAdvancedMovementSceneQueryStats::GetModeTotal(const EAdvancedMovementPhysics Mode) const
+{
+	uint32 Total = 0;
+	for (const uint32 Count : ByMode[static_cast<uint8>(Mode)]) Total += Count;
+	return Total;
+}
+
+
+uint32 FAdvancedMovementSceneQueryStats::GetSourceTotal(const EAdvancedMovementQuerySource Source) const
+{
+	uint32 Total = 0;
+	for (const uint32 Count : BySource[static_cast<uint8>(Source)]) Total += Count;
+	return Total;
+}
+
+
+const TCHAR* FAdvancedMovementSceneQueryStats::GetQueryName(const EAdvancedMovementQuery Query)
+{
+	switch (Query)
+	{
+		case EAdvancedMovementQuery::LineTrace:		return TEXT("LineTrace");
+		case EAdvancedMovementQuery::SphereTrace:	return TEXT("SphereTrace");
+		case EAdvancedMovementQuery::Sweep:			return TEXT("Sweep");
+		case EAdvancedMovementQuery::Overlap:		return TEXT("Overlap");
+		default:									return TEXT("None");
+	}
+}
+
+
+const TCHAR* FAdvancedMovementSceneQueryStats::GetSourceName(const EAdvancedMovementQuerySource Source)
+{
+	switch (Source)
+	{
+		case EAdvancedMovementQuerySource::WallJump:		return TEXT("WallJump");
+		case EAdvancedMovementQuerySource::Mantle:			return TEXT("Mantle");
+		case EAdvancedMovementQuerySource::WallClimbFloor:	return TEXT("WallClimbFloor");
+		case EAdvancedMovementQuerySource::Floor:			return TEXT("Floor");
+		case EAdvancedMovementQuerySource::Crouch:			return TEXT("Crouch");
+		case EAdvancedMovementQuerySource::UnCrouch:		return TEXT("UnCrouch");
+		case EAdvancedMovementQuerySource::Move:			return TEXT("Move");
+		default:											return TEXT("None");
+	}
+}
+
+
+
+
+void FAdvancedMovementNetworkStats::Reset()
+{
+	*this = FAdvancedMovementNetworkStats();
+}
+
+
+uint32 FAdvancedMovementNetworkStats::GetServerCorrections() const
+{
+	uint32 Total = 0;
+	for (const uint32 Count : ServerCorrections) Total += Count;
+	return Total;
+}
+
+
+uint32 FAdvancedMovementNetworkStats::GetClientCorrections() const
+{
+	uint32 Total = 0;
+	for (const uint32 Count : ClientCorrections) Total += Count;
+	return Total;
+}
+
+
+FString FAdvancedMovementNetworkStats::GetCorrectionBreakdown(const uint32 (&Corrections)[static_cast<uint8>(EAdvancedMovementPhysics::MAX)])
+{
+	FString Breakdown;
+	for (int32 Mode = 0; Mode < static_cast<int32>(EAdvancedMovementPhysics::MAX); Mode++)
+	{
+		if (!Corrections[Mode]) continue;
+		Breakdown += FString::Printf(TEXT("%s%s: %u"), Breakdown.IsEmpty() ? TEXT("") : TEXT(", "), FAdvancedMovementPhysicsTimings::GetName(static_cast<EAdvancedMovementPhysics>(Mode)), Corrections[Mode]);
+	}
+	return Breakdown;
+}
@@ -0,0 +1,145 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Profiling/AdvancedMovementTrace.h"
+#include "HAL/FileManager.h"
+#include "Serialization/Archive.h"
+
+
+TArray<FAdvancedMovementTraceRecord> FAdvancedMovementTrace::GetRecords() const
+{
+	TArray<FAdvancedMovementTraceRecord> Ordered;
+	Ordered.Reserve(Count);
+
+	// Once the buffer is full the oldest record is the next one that's overwritten
+	const int32 Start = Count < Records.Num() ? 0 : Head;
+	for (int32 Index = 0; Index < Count; Index++)
+	{
+		Ordered.Add(Records[(Start + Index) % Records.Num()]);
+	}
+	return Ordered;
+}
+
+
+bool FAdvancedMovementTrace::SaveToFile(const FString& FilePath) const
+{
+	TUniquePtr<FArchive> Writer(IFileManager::Get().CreateFileWriter(*FilePath));
+	if (!Writer)
+	{
+		return false;
+	}
+
+	uint32 Magic = FileMagic;
+	uint32 Version = FileVersion;
+	uint32 RecordSize = sizeof(FAdvancedMovementTraceRecord);
+	FString Name = CharacterName;
+	FString SaveReason = Reason;
+	TArray<FAdvancedMovementTraceRecord> Ordered = GetRecords();
+	int32 NumRecords = Ordered.Num();
+	*Writer << Magic;
+	*Writer << Version;
+	*Writer << RecordSize;
+	*Writer << Name;
+	*Writer << SaveReason;
+	*Writer << NumRecords;
+
+	// The records are plain data, and they're written as they're laid out in memory
+	Writer->Serialize(Ordered.GetData(), NumRecords * sizeof(FAdvancedMovementTraceRecord));
+	return Writer->Close();
+}
+
+
+bool FAdvancedMovementTrace::LoadFromFile(const FString& FilePath)
+{
+	TUniquePtr<FArchive> Reader(IFileManager::Get().CreateFileReader(*FilePath));
+	if (!Reader)
+	{
+		return false;
+	}
+
+	uint32 Magic = 0;
+	uint32 Version = 0;
+	uint32 RecordSize = 0;
+	int32 NumRecords = 0;
+	*Reader << Magic;
+	*Reader << Version;
+	*Reader << RecordSize;
+	if (Magic != FileMagic || Version != FileVersion || RecordSize != sizeof(FAdvancedMovementTraceRecord))
+	{
+		Reader->Close();
+		return false;
+	}
+
+	*Reader << CharacterName;
+	*Reader << Reason;
+	*Reader << NumRecords;
+	if (NumRecords < 0 || static_cast<int64>(NumRecords) * RecordSize > Reader->TotalSize() - Reader->Tell())
+	{
+		Reader->Close();
+		return false;
+	}
+
+	Reset(NumRecords);
+	Reader->Serialize(Records.GetData(), NumRecords * sizeof(FAdvancedMovementTraceRecord));
+	Count = NumRecords;
+	Head = 0;
+	const bool bSuccess = !Reader->IsError();
+	return Reader->Close() && bSuccess;
+}
+
+
+FString FAdvancedMovementTrace::ToCsv() const
+{
+	FString Csv = TEXT("Time,DeltaTime,Iteration,Replayed,MovementMode,CustomMovementMode,Branch,LocationX,LocationY,LocationZ,VelocityX,VelocityY,VelocityZ,Speed2D,")
+		TEXT("AccelerationX,AccelerationY,AccelerationZ,HitNormalX,HitNormalY,HitNormalZ,InputX,InputY,StrafeSwayTime,StrafeLurchTime,WallClimbTime,WallRunTime\n");
+	for (const FAdvancedMovementTraceRecord& Record : GetRecords())
+	{
+		Csv += FString::Printf(TEXT("%.4f,%.5f,%d,%d,%d,%d,%s,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.3f,%.3f,%.3f,%.3f,%.3f,%.4f,%.4f,%.4f,%.4f\n"),
+			Record.Time, Record.DeltaTime, Record.Iteration, Record.bReplayed, Record.MovementMode, Record.CustomMovementMode, GetBranchName(static_cast<EAdvancedMovementTraceBranch>(Record.Branch)),
+			Record.Location.X, Record.Location.Y, Record.Location.Z,
+			Record.Velocity.X, Record.Velocity.Y, Record.Velocity.Z, Record.Velocity.Size2D(),
+			Record.Acceleration.X, Record.Acceleration.Y, Record.Acceleration.Z,
+			Record.HitNormal.X, Record.HitNormal.Y, Record.HitNormal.Z,
+			Record.PlayerInput.X, Record.PlayerInput.Y,
+			Record.StrafeSwayTime, Record.StrafeLurchTime, Record.WallClimbTime, Record.WallRunTime
+		);
+	}
+	return Csv;
+}
+
+
+FString FAdvancedMovementTrace::ToJson() const
+{
+	const auto Vector = [](const FVector3f& Value) { return FString::Printf(TEXT("[%.3f,%.3f,%.3f]"), Value.X, Value.Y, Value.Z); };
+
+	FString Json = FString::Printf(TEXT("{\n\t\"character\": \"%s\",\n\t\"reason\": \"%s\",\n\t\"records\": ["), *CharacterName.ReplaceCharWithEscapedChar(), *Reason.ReplaceCharWithEscapedChar());
+	const TArray<FAdvancedMovementTraceRecord> Ordered = GetRecords();
+	for (int32 Index = 0; Index < Ordered.Num(); Index++)
+	{
+		const FAdvancedMovementTraceRecord& Record = Ordered[Index];
+		Json += FString::Printf(TEXT("%s\n\t\t{\"time\": %.4f, \"deltaTime\": %.5f, \"iteration\": %d, \"replayed\": %s, \"mode\": %d, \"customMode\": %d, \"branch\": \"%s\", ")
+			TEXT("\"location\": %s, \"velocity\": %s, \"acceleration\": %s, \"hitNormal\": %s, \"input\": [%.3f,%.3f], ")
+			TEXT("\"strafeSwayTime\": %.4f, \"strafeLurchTime\": %.4f, \"wallClimbTime\": %.4f, \"wallRunTime\": %.4f}"),
+			Index ? TEXT(",") : TEXT(""),
+			Record.Time, Record.DeltaTime, Record.Iteration, Record.bReplayed ? TEXT("true") : TEXT("false"), Record.MovementMode, Record.CustomMovementMode, GetBranchName(static_cast<EAdvancedMovementTraceBranch>(Record.Branch)),
+			*Vector(Record.Location), *Vector(Record.Velocity), *Vector(Record.Acceleration), *Vector(Record.HitNormal), Record.PlayerInput.X, Record.PlayerInput.Y,
+			Record.StrafeSwayTime, Record.StrafeLurchTime, Record.WallClimbTime, Record.WallRunTime
+		);
+	}
+	Json += TEXT("\n\t]\n}\n");
+	return Json;
+}
+
+
+const TCHAR* FAdvancedMovementTrace::GetBranchName(const EAdvancedMovementTraceBranch Branch)
+{
+	switch (Branch)
+	{
+		case EAdvancedMovementTraceBranch::Default: return TEXT("Default");
+		case EAdvancedMovementTraceBranch::SlideStrafe: return TEXT("SlideStrafe");
+		case EAdvancedMovementTraceBranch::AirStrafe: return TEXT("AirStrafe");
+		case EAdvancedMovementTraceBranch::StrafeSway: return TEXT("StrafeSway");
+		case EAdvancedMovementTraceBranch::StrafeLurch: return TEXT("StrafeLurch");
+		default: return TEXT("Unknown");
+	}
+}
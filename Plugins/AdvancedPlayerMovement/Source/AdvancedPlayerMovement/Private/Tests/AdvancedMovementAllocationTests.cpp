@@ -0,0 +1,100 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "AdvancedMovementComponent.h"
+#include "Character/BhopCharacter.h"
+#include "Profiling/AdvancedMovementBenchmarkWorld.h"
+#include "Profiling/AdvancedMovementInput.h"
+#include "Profiling/AdvancedMovementProfiling.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/CommandLine.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+
+/**
+ * Checks that the movement tick doesn't allocate once it's warmed up. Characters are driven with the scripted strafe input (which uses most of the movement modes)
+ * in a game world, and the allocation counter is installed after the warm up frames. The map can be changed with -AllocationTestMap=/Game/Map:
+ *		UnrealEditor-Cmd <Project> -nullrhi -ExecCmds="Automation RunTests AdvancedMovement.Allocations; Quit"
+ */
+namespace AdvancedMovementAllocationTests
+{
+	constexpr int32 Flags = EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter;
+	constexpr int32 Characters = 4;
+	constexpr int32 WarmupFrames = 60;
+	constexpr int32 Frames = 600;
+	constexpr float DeltaTime = 1.f / 60.f;
+
+	/** Applies the scripted input to each of the characters and ticks the world */
+	void TickCharacters(UWorld* World, const TArray<ABhopCharacter*>& Characters, const int32 Frame)
+	{
+		for (int32 Index = 0; Index < Characters.Num(); Index++)
+		{
+			UAdvancedMovementComponent* MovementComponent = Cast<UAdvancedMovementComponent>(Characters[Index]->GetCharacterMovement());
+			if (!MovementComponent) continue;
+
+			AdvancedMovementInput::ApplyInputFrame(Characters[Index], MovementComponent, AdvancedMovementInput::EvaluateStrafeScript(Index, Frame * DeltaTime, DeltaTime));
+		}
+
+		AdvancedMovementBenchmark::TickWorld(World, DeltaTime);
+	}
+}
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAdvancedMovementTickAllocationTest, "AdvancedMovement.Allocations.MovementTick", AdvancedMovementAllocationTests::Flags)
+bool FAdvancedMovementTickAllocationTest::RunTest(const FString& Parameters)
+{
+	using namespace AdvancedMovementAllocationTests;
+
+	FString MapName = TEXT("/Game/ThirdPerson/Maps/Demo");
+	FParse::Value(FCommandLine::Get(), TEXT("AllocationTestMap="), MapName);
+
+	UWorld* World = AdvancedMovementBenchmark::CreateWorld(MapName);
+	if (!World)
+	{
+		AddError(FString::Printf(TEXT("Failed to load the map %s"), *MapName));
+		return false;
+	}
+
+	const TArray<ABhopCharacter*> SpawnedCharacters = AdvancedMovementBenchmark::SpawnCharacters(World, Characters);
+	if (!TestEqual(TEXT("The characters were spawned"), SpawnedCharacters.Num(), Characters))
+	{
+		AdvancedMovementBenchmark::DestroyWorld(World);
+		return false;
+	}
+
+	// Let the movement settle (the first ticks of each movement mode can allocate, ie the speed curve tables and the ledge database)
+	for (int32 Frame = 0; Frame < WarmupFrames; Frame++)
+	{
+		TickCharacters(World, SpawnedCharacters, Frame);
+	}
+
+	FAdvancedMovementAllocations::Install();
+	FAdvancedMovementAllocations::Reset();
+	for (int32 Frame = WarmupFrames; Frame < WarmupFrames + Frames; Frame++)
+	{
+		FAdvancedMovementAllocations::bEnabled = true;
+		TickCharacters(World, SpawnedCharacters, Frame);
+		FAdvancedMovementAllocations::bEnabled = false;
+	}
+	FAdvancedMovementAllocations::Uninstall();
+
+	const uint64 Allocations = FAdvancedMovementAllocations::Allocations;
+	if (Allocations)
+	{
+		AddError(FString::Printf(TEXT("The movement tick made %llu heap allocations (%llu bytes) after %d warm up frames"), Allocations, FAdvancedMovementAllocations::Bytes, WarmupFrames));
+		for (int32 Index = 0; Index < FMath::Min(FAdvancedMovementAllocations::NumCallstacks, FAdvancedMovementAllocations::MaxCallstacks); Index++)
+		{
+			AddInfo(FString::Printf(TEXT("Allocation %d:\n%s"), Index, *FAdvancedMovementAllocations::GetCallstack(Index)));
+		}
+	}
+
+	for (ABhopCharacter* Character : SpawnedCharacters)
+	{
+		Character->Destroy();
+	}
+	AdvancedMovementBenchmark::DestroyWorld(World);
+	return Allocations == 0;
+}
+
+#endif
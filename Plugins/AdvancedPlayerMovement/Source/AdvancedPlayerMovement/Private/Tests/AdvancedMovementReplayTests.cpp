@@ -0,0 +1,204 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Character/BhopCharacter.h"
+#include "Profiling/AdvancedMovementBenchmarkWorld.h"
+#include "Profiling/AdvancedMovementInputRecording.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/CommandLine.h"
+#include "Misc/Paths.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+
+/**
+ * Regression tests for movement tuning and performance. These replay the input recording that's checked into the plugin (Resources/Recordings/Demo.amrec, a session
+ * on /Game/ThirdPerson/Maps/Demo) and compare the result against the recording's baseline. The recording can be changed with -ReplayTestRecording=Path/To/Session.amrec:
+ *		UnrealEditor-Cmd <Project> -nullrhi -ExecCmds="Automation RunTests AdvancedMovement.Replay; Quit"
+ *
+ * Intentional movement changes need the recording to be rebaselined, see UAdvancedMovementReplayCommandlet (-WriteBaseline). The frame rate sweep doesn't use
+ * the baseline, it replays the recording resampled to each frame rate and compares them against each other.
+ */
+namespace AdvancedMovementReplayTests
+{
+	constexpr int32 Flags = EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter;
+
+	/** How far the replayed trajectory can drift from the baseline */
+	constexpr double Tolerance = 5;
+
+	/** How far the replayed final speed can drift from the baseline */
+	constexpr double SpeedTolerance = 5;
+
+	/** How much more expensive the movement tick can be than the baseline's (the baseline was measured on whichever machine captured it, so this is loose) */
+	constexpr double MaxTickRegression = 1.5;
+
+	/** The frame rates the recording is resampled to for the frame rate sweep, and the one the others are compared against */
+	constexpr float FrameRates[] = { 30, 60, 120, 144, 240 };
+	constexpr float ReferenceFrameRate = 60;
+
+	/** How far the final speed at each frame rate can diverge from the reference frame rate's (a fraction of the reference speed) */
+	constexpr double MaxSpeedDivergence = 0.05;
+
+	/** Loads the checked in recording (or the one from -ReplayTestRecording=) and its character class */
+	bool LoadRecording(FAutomationTestBase& Test, FAdvancedMovementInputRecording& OutRecording, TSubclassOf<ABhopCharacter>& OutCharacterClass)
+	{
+		FString RecordingPath = FPaths::ProjectPluginsDir() / TEXT("AdvancedPlayerMovement/Resources/Recordings/Demo") + FAdvancedMovementInputRecording::GetFileExtension();
+		FParse::Value(FCommandLine::Get(), TEXT("ReplayTestRecording="), RecordingPath);
+		if (!OutRecording.LoadFromFile(RecordingPath))
+		{
+			Test.AddError(FString::Printf(TEXT("Failed to load the recording %s. Record a session on Demo (AdvancedMovement.StartRecording and AdvancedMovement.StopRecording), ")
+				TEXT("and rebaseline it with -run=AdvancedMovementReplay -WriteBaseline -Output=%s"), *RecordingPath, *RecordingPath));
+			return false;
+		}
+
+		if (OutRecording.MapName.IsEmpty()) OutRecording.MapName = TEXT("/Game/ThirdPerson/Maps/Demo");
+		OutCharacterClass = OutRecording.CharacterClassPath.IsEmpty() ? ABhopCharacter::StaticClass() : LoadClass<ABhopCharacter>(nullptr, *OutRecording.CharacterClassPath);
+		if (!OutCharacterClass)
+		{
+			Test.AddError(FString::Printf(TEXT("Failed to load the character class %s"), *OutRecording.CharacterClassPath));
+			return false;
+		}
+
+		return true;
+	}
+
+	/** Replays a recording in a fresh world */
+	bool Replay(FAutomationTestBase& Test, const FAdvancedMovementInputRecording& Recording, TSubclassOf<ABhopCharacter> CharacterClass, FAdvancedMovementReplayResult& OutResult)
+	{
+		UWorld* World = AdvancedMovementBenchmark::CreateWorld(Recording.MapName);
+		if (!World)
+		{
+			Test.AddError(FString::Printf(TEXT("Failed to load the map %s"), *Recording.MapName));
+			return false;
+		}
+
+		const bool bReplayed = AdvancedMovementBenchmark::ReplayRecording(Recording, World, CharacterClass, OutResult);
+		AdvancedMovementBenchmark::DestroyWorld(World);
+		if (!bReplayed)
+		{
+			Test.AddError(TEXT("Failed to spawn the character for the replay"));
+		}
+
+		return bReplayed;
+	}
+}
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAdvancedMovementReplayBaselineTest, "AdvancedMovement.Replay.Baseline", AdvancedMovementReplayTests::Flags)
+bool FAdvancedMovementReplayBaselineTest::RunTest(const FString& Parameters)
+{
+	using namespace AdvancedMovementReplayTests;
+
+	FAdvancedMovementInputRecording Recording;
+	TSubclassOf<ABhopCharacter> CharacterClass;
+	if (!LoadRecording(*this, Recording, CharacterClass))
+	{
+		return false;
+	}
+
+	if (Recording.Trajectory.IsEmpty())
+	{
+		AddError(TEXT("The recording doesn't have a baseline, rebaseline it with -run=AdvancedMovementReplay -WriteBaseline"));
+		return false;
+	}
+
+	FAdvancedMovementReplayResult Result;
+	if (!Replay(*this, Recording, CharacterClass, Result))
+	{
+		return false;
+	}
+
+	// Trajectory
+	const double TrajectoryDeviation = AdvancedMovementBenchmark::GetTrajectoryDeviation(Recording.Trajectory, Result.Trajectory);
+	const double EndDeviation = FVector::Dist(Recording.EndLocation, Result.EndLocation);
+	const double SpeedDeviation = FMath::Abs(Recording.EndVelocity.Size2D() - Result.EndVelocity.Size2D());
+	AddInfo(FString::Printf(TEXT("Replayed %d frames (%.2fs): trajectory deviation %.3f (end %.3f), speed deviation %.3f (baseline speed %.3f, replayed speed %.3f)"),
+		Recording.Frames.Num(), Recording.GetDuration(), TrajectoryDeviation, EndDeviation, SpeedDeviation, Recording.EndVelocity.Size2D(), Result.EndVelocity.Size2D()));
+
+	if (Recording.Trajectory.Num() != Result.Trajectory.Num())
+	{
+		AddError(FString::Printf(TEXT("The baseline has %d trajectory samples, the replay has %d"), Recording.Trajectory.Num(), Result.Trajectory.Num()));
+	}
+
+	if (TrajectoryDeviation > Tolerance || EndDeviation > Tolerance)
+	{
+		AddError(FString::Printf(TEXT("The trajectory deviated %.3f from the baseline (tolerance %.3f)"), FMath::Max(TrajectoryDeviation, EndDeviation), Tolerance));
+	}
+
+	if (SpeedDeviation > SpeedTolerance)
+	{
+		AddError(FString::Printf(TEXT("The final speed deviated %.3f from the baseline (tolerance %.3f)"), SpeedDeviation, SpeedTolerance));
+	}
+
+	// Tick cost
+	AddInfo(FString::Printf(TEXT("Movement tick mean %.3fus, p95 %.3fus (baseline mean %.3fus)"),
+		Result.MeanTickUs, AdvancedMovementBenchmark::GetPercentile(Result.TickUs, 0.95), Recording.BaselineTickUs));
+
+	if (Recording.BaselineTickUs > 0 && Result.MeanTickUs > Recording.BaselineTickUs * MaxTickRegression)
+	{
+		AddError(FString::Printf(TEXT("The movement tick took %.3fus on average, %.2fx the baseline of %.3fus (limit %.2fx)"),
+			Result.MeanTickUs, Result.MeanTickUs / Recording.BaselineTickUs, Recording.BaselineTickUs, MaxTickRegression));
+	}
+
+	return !HasAnyErrors();
+}
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAdvancedMovementReplayFrameRateSweepTest, "AdvancedMovement.Replay.FrameRateSweep", AdvancedMovementReplayTests::Flags)
+bool FAdvancedMovementReplayFrameRateSweepTest::RunTest(const FString& Parameters)
+{
+	using namespace AdvancedMovementReplayTests;
+
+	FAdvancedMovementInputRecording Recording;
+	TSubclassOf<ABhopCharacter> CharacterClass;
+	if (!LoadRecording(*this, Recording, CharacterClass))
+	{
+		return false;
+	}
+
+	// Replay the session at every frame rate, each in a fresh world so they all start from the same state
+	TArray<FAdvancedMovementReplayResult> Results;
+	for (const float FrameRate : FrameRates)
+	{
+		FAdvancedMovementInputRecording Resampled = Recording;
+		Resampled.Frames = Recording.Resample(FrameRate);
+		if (!Replay(*this, Resampled, CharacterClass, Results.AddDefaulted_GetRef()))
+		{
+			AddError(FString::Printf(TEXT("Failed to replay the recording at %.0fhz"), FrameRate));
+			return false;
+		}
+	}
+
+	// Compare every frame rate against the reference
+	int32 ReferenceIndex = 0;
+	for (int32 Index = 0; Index < UE_ARRAY_COUNT(FrameRates); Index++)
+	{
+		if (FrameRates[Index] == ReferenceFrameRate) ReferenceIndex = Index;
+	}
+
+	const FAdvancedMovementReplayResult& Reference = Results[ReferenceIndex];
+	const double ReferenceSpeed = Reference.EndVelocity.Size2D();
+	const float Duration = Recording.GetDuration();
+	for (int32 Index = 0; Index < Results.Num(); Index++)
+	{
+		const FAdvancedMovementReplayResult& Result = Results[Index];
+		const double Speed = Result.EndVelocity.Size2D();
+		const double SpeedDivergence = ReferenceSpeed > 0 ? (Speed - ReferenceSpeed) / ReferenceSpeed : 0;
+		const double EndDrift = FVector::Dist(Result.EndLocation, Reference.EndLocation);
+		const double CpuMsPerSecond = Duration > 0 ? Result.MeanTickUs * Result.TickUs.Num() / 1000.0 / Duration : 0;
+
+		AddInfo(FString::Printf(TEXT("%.0fhz: speed %.3f (%.2f%% from %.0fhz), drift %.3f, %d wall jumps, %llu physics calls, tick mean %.3fus, p95 %.3fus, %.3fms of movement per second"),
+			FrameRates[Index], Speed, SpeedDivergence * 100, ReferenceFrameRate, EndDrift, Result.WallJumps, Result.PhysicsCalls,
+			Result.MeanTickUs, AdvancedMovementBenchmark::GetPercentile(Result.TickUs, 0.95), CpuMsPerSecond));
+
+		if (FMath::Abs(SpeedDivergence) > MaxSpeedDivergence)
+		{
+			AddError(FString::Printf(TEXT("The final speed at %.0fhz diverged %.2f%% from %.0fhz (limit %.2f%%)"),
+				FrameRates[Index], SpeedDivergence * 100, ReferenceFrameRate, MaxSpeedDivergence * 100));
+		}
+	}
+
+	return !HasAnyErrors();
+}
+
+#endif
@@ -3,7 +3,15 @@
 
 #include "CoreMinimal.h"
 #include "MovementInformation.h"
+#include "Profiling/AdvancedMovementProfiling.h"
+#include "Profiling/AdvancedMovementInputRecording.h"
+#include "Profiling/AdvancedMovementTrace.h"
+#include "Ledges/AdvancedMovementLedgeDatabase.h"
 #include "GameFramework/CharacterMovementComponent.h"
+#include "Engine/OverlapResult.h"
+#include "Profiling/AdvancedMovementProbeSubsystem.h"
+#include "Core/AdvancedMovementMath.h"
+#include "Core/AdvancedMovementFeatures.h"
 #include "AdvancedMovementComponent.generated.h"
 
 DECLARE_LOG_CATEGORY_EXTERN(Movement, Log, All);
@@ -160,6 +168,112 @@ You will also need to extend FCharacterNetworkMoveDataContainer so that it can s
 
 
 
+/** The wall and ledge traces for mantling that were added to the probe batch during the previous tick, see bUseAsyncMantleProbe */
+struct FAdvancedMovementMantleProbe
+{
+	/** The wall trace, from where the character was predicted to be during the next tick */
+	FVector TraceStart = FVector::ZeroVector;
+	FVector TraceEnd = FVector::ZeroVector;
+	FAdvancedMovementProbeHandle WallTrace;
+
+	/** The ledge trace above where the wall trace was predicted to hit. This is only issued if the wall was already known */
+	FVector PredictedWallLocation = FVector::ZeroVector;
+	FVector PredictedWallNormal = FVector::ZeroVector;
+	FAdvancedMovementProbeHandle LedgeTrace;
+
+	/** The last wall the mantle checks found */
+	FVector LastWallLocation = FVector::ZeroVector;
+	FVector LastWallNormal = FVector::ZeroVector;
+};
+
+
+/** The wall jump traces that were added to the probe batch during the previous tick, see bUseWallJumpProbe */
+struct FAdvancedMovementWallJumpProbe
+{
+	/** Where the character was predicted to be during the next tick, and the ends of the input and forward traces */
+	FVector TraceStart = FVector::ZeroVector;
+	FVector InputTraceEnd = FVector::ZeroVector;
+	FVector FrontTraceEnd = FVector::ZeroVector;
+	FAdvancedMovementProbeHandle InputTrace;
+	FAdvancedMovementProbeHandle FrontTrace;
+};
+
+
+/** The wall the character is running on, which is cached when the wall run starts and reused until the character leaves the wall's plane, see WallRunContactTolerance */
+struct FAdvancedMovementWallRunContact
+{
+	/** The wall and its normal */
+	TWeakObjectPtr<UPrimitiveComponent> Wall;
+	FVector Normal = FVector::ZeroVector;
+
+	/** Where the character was when it touched the wall, the character runs along the wall's plane through this location */
+	FVector Location = FVector::ZeroVector;
+
+	/** The direction along the wall (either way). This is perpendicular to the wall's normal, and not based on the wall's rotation */
+	FVector Tangent = FVector::ZeroVector;
+
+	/** The end of the wall run the contact was cached for */
+	float ValidUntil = 0;
+};
+
+
+/** Where the character last failed to uncrouch, which is reused until the character or its base moves, see bUseUnCrouchClearanceCache */
+struct FAdvancedMovementUnCrouchClearance
+{
+	/** Where the character was, its crouched height, and its distance to the floor */
+	FVector Location = FVector::ZeroVector;
+	float CrouchedHalfHeight = 0;
+	float FloorDistance = 0;
+
+	/** The character's base, and where the base was */
+	TWeakObjectPtr<UPrimitiveComponent> Base;
+	FTransform BaseTransform = FTransform::Identity;
+
+	/** When the standing capsule was last tested */
+	float TestTime = 0;
+
+	/** Whether the standing capsule didn't fit */
+	bool bBlocked = false;
+};
+
+
+/**
+ * Values that are derived from the movement settings and used every tick, see RebuildDerivedParams.
+ * The angles are stored as the dot product of the wall's normal and the character's forward vector at the angle's limit, so they're compared without acos
+ */
+struct FAdvancedMovementDerivedParams
+{
+	/** The air strafe and strafe sway speed caps ((StrafingMaxAcceleration / 100) * the speed gain multiplier) */
+	float AirStrafeSpeedCap = 0;
+	float StrafeSwaySpeedCap = 0;
+
+	/** Wall climbing is allowed while the dot of the wall's normal and the forward vector is less than this (WallClimbAcceptableAngle), and the oriented dot is for starting a climb with bOrientRotationToMovement */
+	float WallClimbMaxDot = 0;
+	float WallClimbOrientedTryMaxDot = 0;
+
+	/** Wall running is allowed while the absolute dot of the wall's normal and the forward vector is less than this (WallRunAcceptableAngleRadius) */
+	float WallRunMaxDot = 0;
+
+	/** The wall run contact changes when the dot of the wall's normal and the contact's normal is less than this (WallRunContactAngleThreshold) */
+	float WallRunContactMinDot = 0;
+
+	/** The squared slide enter speed and wall jump distance thresholds */
+	float SlideEnterThresholdSquared = 0;
+	float WallJumpHeightFromGroundThresholdSquared = 0;
+
+	/** The ledge climb variations, indexed by their climb type */
+	FLedgeClimbInformation ClimbVariations[static_cast<uint8>(EClimbType::None)];
+	bool bHasClimbVariation[static_cast<uint8>(EClimbType::None)] = {};
+
+	/** Returns the ledge climb variation of a climb type, or nullptr if there isn't one */
+	const FLedgeClimbInformation* FindClimbVariation(const EClimbType ClimbType) const
+	{
+		const uint8 Index = static_cast<uint8>(ClimbType);
+		return Index < static_cast<uint8>(EClimbType::None) && bHasClimbVariation[Index] ? &ClimbVariations[Index] : nullptr;
+	}
+};
+
+
 /*
 * Bhop like movement inspired by the source engine
 */
@@ -188,11 +302,11 @@ protected:
 	bool bUseBhopping;
 	
 	/** Max Strafing Acceleration (how fast you speed up) */
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Character Movement (General Settings)|Air Strafe", meta=(ClampMin="0.0", UIMin = "0.0", UIMax = "10000", EditCondition = "bUseBhopping", EditConditionHides))
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Character Movement (General Settings)|Air Strafe", meta=(BlueprintSetter = SetStrafingMaxAcceleration, ClampMin="0.0", UIMin = "0.0", UIMax = "10000", EditCondition = "bUseBhopping", EditConditionHides))
 	float StrafingMaxAcceleration;
 
 	/** How much speed should be gained during air strafing? This is a multiplier based on the character's acceleration */
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Character Movement (General Settings)|Air Strafe", meta=(ClampMin="0.0", UIMin = "0.0", UIMax = "3", EditCondition = "bUseBhopping", EditConditionHides))
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Character Movement (General Settings)|Air Strafe", meta=(BlueprintSetter = SetAirStrafeSpeedGainMultiplier, ClampMin="0.0", UIMin = "0.0", UIMax = "3", EditCondition = "bUseBhopping", EditConditionHides))
 	float AirStrafeSpeedGainMultiplier;
 
 	/** This influences the rotation rate during air strafing while you're gaining speeds. The higher the value, the more you'll be able to gain speed while turning */
@@ -205,7 +319,7 @@ protected:
 	float StrafeSwayDuration;
 	
 	/** Speed gained during strafe is tied to the character's acceleration, and this multiplies how much is gained during a strafe */
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Character Movement (General Settings)|Air Strafe|Air Strafe Sway", meta=(ClampMin="0.0", UIMin = "0.0", UIMax = "3.5", EditCondition = "bUseBhopping", EditConditionHides))
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Character Movement (General Settings)|Air Strafe|Air Strafe Sway", meta=(BlueprintSetter = SetStrafeSwaySpeedGainMultiplier, ClampMin="0.0", UIMin = "0.0", UIMax = "3.5", EditCondition = "bUseBhopping", EditConditionHides))
 	float StrafeSwaySpeedGainMultiplier;
 
 	/** The rotation rate of the character that allows preserving the player's speed while turning. This is influenced by the character's current speed, so at higher speeds if they try strafing it'll slow them down */
@@ -294,13 +408,20 @@ protected:
 	float WallJumpValidDistance;
 
 	/** How high the character should be from the ground before wall jumping is valid */
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Character Movement (General Settings)|Wall Jump", meta=(UIMin = "30", UIMax = "100", EditCondition = "bUseWallJumping", EditConditionHides))
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Character Movement (General Settings)|Wall Jump", meta=(BlueprintSetter = SetWallJumpHeightFromGroundThreshold, UIMin = "30", UIMax = "100", EditCondition = "bUseWallJumping", EditConditionHides))
 	float WallJumpHeightFromGroundThreshold;
 
 	/** If the player's previous ground location was close to the wall, sometimes the trajectory isn't calculated correctly. This adjusts it by moving it away from the wall to create a valid trajectory */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Character Movement (General Settings)|Wall Jump", meta=(UIMin = "25", UIMax = "100", EditCondition = "bUseWallJumping", EditConditionHides))
 	float WallJumpSpacing;
 
+	/**
+	 * Adds the wall jump traces to the probe batch a tick ahead while the player is holding wall jump. If the character ends up where it was predicted to be,
+	 * and neither trace found a wall, the wall jump check uses that instead of tracing again. Walls are always confirmed with the regular traces.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Character Movement (General Settings)|Wall Jump", meta=(EditCondition = "bUseWallJumping", EditConditionHides))
+	bool bUseWallJumpProbe;
+
 	/** wall jump checks/traces */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category= "Character Movement (General Settings)|Wall Jump|Debug", meta=(EditCondition = "bUseWallJumping", EditConditionHides))
 	bool bDebugWallJumpTrace;
@@ -393,7 +514,7 @@ protected:
 	FVector2D WallClimbMultiplier;
 
 	/** Up to what angle is wall climbing allowed? */
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Character Movement (General Settings)|Wall Climbing", meta=(UIMin = "0", UIMax = "45", EditCondition = "bUseWallClimbing", EditConditionHides))
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Character Movement (General Settings)|Wall Climbing", meta=(BlueprintSetter = SetWallClimbAcceptableAngle, UIMin = "0", UIMax = "45", EditCondition = "bUseWallClimbing", EditConditionHides))
 	float WallClimbAcceptableAngle;
 	
 	/** The friction climbing a wall when a player comes from a falling state */
@@ -408,6 +529,14 @@ protected:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Character Movement (General Settings)|Wall Climbing", meta=(UIMin = "-100", UIMax = "0", ClampMax = "0", EditCondition = "bUseWallClimbing", EditConditionHides))
 	float WallClimbJumpInterval;
 	
+	/**
+	 * Only checks for the floor during wall climbs when the character could land. The floor is checked when the character isn't climbing upwards, when the previous move hit a walkable surface,
+	 * when the character has moved sideways more than its radius since the last floor check, or while it's within MaxStepHeight of the walkable floor the last check found.
+	 * Otherwise the character is only moving away from the floor that was checked
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Character Movement (General Settings)|Wall Climbing", meta=(EditCondition = "bUseWallClimbing", EditConditionHides))
+	bool bUseWallClimbFloorGate;
+	
 	/** Wall climbing information */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Character Movement (General Settings)|Wall Climbing|Debug", meta=(EditCondition = "bUseWallClimbing", EditConditionHides))
 	bool bDebugWallClimb;
@@ -485,6 +614,25 @@ protected:
 	/** The types of objects the player is allowed to mantle on */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Character Movement (General Settings)|Mantling", meta=(EditCondition = "bUseMantling", EditConditionHides)) 
 	TArray<TEnumAsByte<EObjectTypeQuery>> MantleObjects;
+
+	/**
+	 * Issues the wall and ledge traces asynchronously a tick ahead while wall climbing (or falling towards a wall). If the character ends up where it was predicted to be,
+	 * and those traces show there isn't anything to mantle, the mantle check uses that instead of tracing again. Valid ledges are always confirmed with the regular traces.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Character Movement (General Settings)|Mantling", meta=(EditCondition = "bUseMantling", EditConditionHides)) 
+	bool bUseAsyncMantleProbe;
+
+	/**
+	 * Looks up ledges from the level's baked ledge database (see UAdvancedMovementLedgeDatabase) instead of running the ledge trace. The wall trace always runs,
+	 * and the baked ledge is only used if the trace hit the baked wall. Only static geometry is baked, so anything else in front of the wall, or walls without
+	 * a baked ledge, still use the ledge trace. Levels without a database (or with one baked for different settings) only use the mantle traces.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Character Movement (General Settings)|Mantling", meta=(EditCondition = "bUseMantling", EditConditionHides)) 
+	bool bUseLedgeDatabase;
+
+	/** How far the wall trace's hit can be from a baked ledge's wall for the baked ledge to be used */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Character Movement (General Settings)|Mantling", meta=(UIMin = "0", UIMax = "10", EditCondition = "bUseMantling && bUseLedgeDatabase", EditConditionHides)) 
+	float BakedLedgeWallTolerance;
 	
 	/** Mantle trace information */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Character Movement (General Settings)|Mantling|Debug", meta=(EditCondition = "bUseMantling", EditConditionHides))
@@ -515,7 +663,7 @@ protected:
 	bool bUseLedgeClimbing;
 
 	/** The information for handling different ledge climb variation's speeds with movement smoothing */
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Character Movement (General Settings)|Ledge Climbing", meta=(EditCondition = "bUseLedgeClimbing", EditConditionHides)) 
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Character Movement (General Settings)|Ledge Climbing", meta=(BlueprintSetter = SetLedgeClimbVariations, EditCondition = "bUseLedgeClimbing", EditConditionHides)) 
 	TMap<EClimbType, FLedgeClimbInformation> LedgeClimbVariations;
 
 	/** The height offset for adjusting the player's placement on the ledge */
@@ -590,7 +738,7 @@ protected:
 	float WallRunSpeedThreshold;
 
 	/** The acceptable angle the character can be facing while running alongside a wall. ex: 30 -> 90-30 to 90+30  */
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Character Movement (General Settings)|Wall Running", meta=(UIMin = "0", UIMax = "45", EditCondition = "bUseWallRunning", EditConditionHides))
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Character Movement (General Settings)|Wall Running", meta=(BlueprintSetter = SetWallRunAcceptableAngleRadius, UIMin = "0", UIMax = "45", EditCondition = "bUseWallRunning", EditConditionHides))
 	float WallRunAcceptableAngleRadius;
 
 	/** If a player starts wall running on the same wall before landing on the ground, what is the acceptable height difference to wall jump an additional time */
@@ -601,6 +749,14 @@ protected:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Character Movement (General Settings)|Wall Running", meta=(EditCondition = "bUseWallRunning", EditConditionHides))
 	bool bShouldRunBackwardsIfFacingAwayFromWall;
 
+	/** How far the character is able to drift from the wall's plane before the wall run direction is recalculated */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Character Movement (General Settings)|Wall Running", meta=(UIMin = "0", UIMax = "25", EditCondition = "bUseWallRunning", EditConditionHides))
+	float WallRunContactTolerance;
+
+	/** How much the wall's normal (in degrees) is able to change before the wall run direction is recalculated */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Character Movement (General Settings)|Wall Running", meta=(BlueprintSetter = SetWallRunContactAngleThreshold, UIMin = "0", UIMax = "45", EditCondition = "bUseWallRunning", EditConditionHides))
+	float WallRunContactAngleThreshold;
+
 	/** Wall run information */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Character Movement (General Settings)|Wall Running|Debug", meta=(EditCondition = "bUseWallRunning", EditConditionHides))
 	bool bDebugWallRunning;
@@ -639,7 +795,7 @@ protected:
 	bool bUseSliding;
 	
 	/** The required movement speed to be allowed to slide */
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Character Movement (General Settings)|Sliding", meta=(UIMin = "0.0", UIMax = "1000", EditCondition = "bUseSliding", EditConditionHides))
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Character Movement (General Settings)|Sliding", meta=(BlueprintSetter = SetSlideEnterThreshold, UIMin = "0.0", UIMax = "1000", EditCondition = "bUseSliding", EditConditionHides))
 	float SlideEnterThreshold;
 	
 	/** The initial boost once you enter the slide movement mode */
@@ -728,6 +884,25 @@ protected:
 	 */
 	virtual void InitializeComponent() override;
 
+	/** Uninitializes the component, which stops listening for changes to the speed adjustment curves */
+	virtual void UninitializeComponent() override;
+
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+
+	/** The values derived from the movement settings that are used every tick */
+	FAdvancedMovementDerivedParams DerivedParams;
+
+	/** Whether a movement feature is compiled in (see FAdvancedMovementFeatures) and enabled */
+	FORCEINLINE bool UsesBhopping() const { return FAdvancedMovementFeatures::bBhopping && bUseBhopping; }
+	FORCEINLINE bool UsesSliding() const { return FAdvancedMovementFeatures::bSliding && bUseSliding; }
+	FORCEINLINE bool UsesWallJumping() const { return FAdvancedMovementFeatures::bWallJumping && bUseWallJumping; }
+	FORCEINLINE bool UsesWallClimbing() const { return FAdvancedMovementFeatures::bWallClimbing && bUseWallClimbing; }
+	FORCEINLINE bool UsesWallRunning() const { return FAdvancedMovementFeatures::bWallRunning && bUseWallRunning; }
+	FORCEINLINE bool UsesMantling() const { return FAdvancedMovementFeatures::bMantling && bUseMantling; }
+	FORCEINLINE bool UsesLedgeClimbing() const { return FAdvancedMovementFeatures::bLedgeClimbing && bUseLedgeClimbing; }
+
 	
 //------------------------------------------------------------------------------//
 // General Movement Logic														//
@@ -768,6 +943,18 @@ public:
 
 	/** If the player is strafe lurching */
 	UFUNCTION(BlueprintCallable) virtual bool IsStrafeLurching();
+
+	/**
+	 * Returns the air velocity branch the character would take during its next falling tick, and the inputs of the air strafe math for it.
+	 * This is for callers that run the velocity phase of many characters at once (see AdvancedMovementMathBatch and the benchmark's -VelocityBatch)
+	 *
+	 * @param OutBranch				The air strafe, strafe sway, or strafe lurch branch
+	 * @param OutParams				The speed cap, rotation rate, and air control of the branch
+	 * @param OutLurchStrength		How much strafe lurch influences the character (only for strafe lurch)
+	 * @param OutLurchFriction		The strafe lurch friction (only for strafe lurch)
+	 * @returns						False if the character isn't falling with bhop physics
+	 */
+	virtual bool GetAirStrafeState(EAdvancedMovementTraceBranch& OutBranch, AdvancedMovementMath::FAirStrafeParams& OutParams, float& OutLurchStrength, float& OutLurchFriction);
 	
 	
 //------------------------------------------------------------------------------//
@@ -795,8 +982,17 @@ protected:
 	/** Update the character state in PerformMovement after the position change. Some rotation updates happen after this. */
 	virtual void UpdateCharacterStateAfterMovement(float DeltaSeconds) override;
 
+	/** Performs the movement for a move. This is allocation free once the component has warmed up (see the AdvancedMovement.Allocations automation test, and the replay commandlet's -AllocationCheck) */
+	virtual void PerformMovement(float DeltaTime) override;
+
 	/** Function called every frame on the Component. Override this function to implement custom logic to be executed every frame. */
 	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+	/** Counts the floor sweep of every floor check for the scene query stats */
+	virtual void ComputeFloorDist(const FVector& CapsuleLocation, float LineDistance, float SweepDistance, FFindFloorResult& OutFloorResult, float SweepRadius, const FHitResult* DownwardSweepResult = NULL) const override;
+
+	/** Counts the sweep of every character move for the scene query stats */
+	virtual bool MoveUpdatedComponentImpl(const FVector& Delta, const FQuat& NewRotation, bool bSweep, FHitResult* OutHit = NULL, ETeleportType Teleport = ETeleportType::None) override;
 	
 	
 //------------------------------------------------------------------------------//
@@ -878,7 +1074,7 @@ protected:
 	 * @param Boost				The speed multiplier for the wall jump
 	 * @param PrevState			This is used for debugging to determine the logic before the wall jump
 	 */
-	virtual void CalculateWallJumpTrajectory(float DeltaTime, int32 Iterations, const FHitResult& Wall, float Speed, FVector2D Boost, FString PrevState = FString("Falling"));
+	virtual void CalculateWallJumpTrajectory(float DeltaTime, int32 Iterations, const FHitResult& Wall, float Speed, FVector2D Boost, const TCHAR* PrevState = TEXT("Falling"));
 
 	/** Checks if the jump happened after mantling */
 	UFUNCTION(BlueprintCallable) virtual bool IsMantleJump();
@@ -913,6 +1109,30 @@ protected:
 	 */
 	virtual void GroundMovementPhysics(float deltaTime, int32 Iterations);
 
+	/**
+	 * Reuses the previous floor during ground movement instead of sweeping for it again when the character slid along a static floor without the floor changing.
+	 * The floor is confirmed with a line trace against only the floor's component, and a full floor check happens after FloorCoherenceMaxReuses reused floors
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Character Movement (General Settings)|Scene Queries")
+	bool bUseFloorCoherence;
+
+	/** How many times in a row the floor is allowed to be reused before it's checked again */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Character Movement (General Settings)|Scene Queries", meta=(UIMin = "0", UIMax = "10", EditCondition = "bUseFloorCoherence", EditConditionHides))
+	int32 FloorCoherenceMaxReuses;
+
+	/**
+	 * Reuses the floor from before the character moved if the character is still on the same static primitive, and the floor's normal hasn't changed
+	 *
+	 * @param OldFloor				The floor before the character moved
+	 * @param OldLocation			Where the character was before it moved
+	 * @param OutFloor				The floor at the character's current location
+	 * @returns						True if the floor was reused
+	 */
+	virtual bool ReuseFloor(const FFindFloorResult& OldFloor, const FVector& OldLocation, FFindFloorResult& OutFloor);
+
+	/** How many times in a row the floor has been reused */
+	int32 FloorCoherenceReuses = 0;
+
 	
 //------------------------------------------------------------------------------//
 // Slide Logic																	//
@@ -953,6 +1173,27 @@ protected:
 
 	/** Reset's the wall climb duration using the wall climb interval */
 	virtual void ResetWallClimbInterval();
+
+
+	/** Returns true if the character could land during this wall climb update, see bUseWallClimbFloorGate */
+	virtual bool ShouldCheckWallClimbFloor() const;
+
+	/** Saves a movement hit during wall climbs, which is used for deciding whether to check for the floor during the next update */
+	virtual void SaveWallClimbHit(const FHitResult& Hit);
+
+	/** Makes the next wall climb update check for the floor. This state isn't part of the saved moves, so it's also reset when the client replays its moves */
+	virtual void ResetWallClimbFloorGate();
+
+#if ADVANCED_MOVEMENT_WITH_WALL_CLIMBING
+	/** Where the character was during the last wall climb floor check, this is invalid until the first check of a wall climb */
+	TOptional<FVector> WallClimbFloorCheckLocation;
+
+	/** The height of the character when it's standing on the walkable floor that the last wall climb floor check found, if it found one */
+	TOptional<float> WallClimbFloorZ;
+
+	/** Whether the character hit a walkable surface while moving during the previous wall climb update */
+	bool bWallClimbHitWalkableSurface = false;
+#endif
 	
 //------------------------------------------------------------------------------//
 // Mantle Logic																	//
@@ -981,12 +1222,83 @@ protected:
 	 * @returns the move's adjusted value (with delta time factored in)
 	 */
 	UFUNCTION(BlueprintCallable) virtual FVector MantleAndClimbInterp(float DeltaTime, FVector StartLocation, FVector TargetLocation, FVector CurrentLocation, float Speed, UCurveFloat* SpeedAdjustments) const;
+
+	/**
+	 * The same as MantleAndClimbInterp, with the distance between the start and target locations already computed. The speed adjustments are evaluated from their lookup table
+	 * 
+	 * @param DeltaTime					Time slice for this operation
+	 * @param TargetLocation			The target location
+	 * @param CurrentLocation			The player's current location
+	 * @param InvDistance				The inverse of the distance between the start and target locations
+	 * @param Speed						The raw speed of the interp
+	 * @param SpeedAdjustments			The float curve used for adjusting the speed at different intervals
+	 * @returns the move's adjusted value (with delta time factored in)
+	 */
+	virtual FVector MantleAndClimbInterpBaked(float DeltaTime, const FVector& TargetLocation, const FVector& CurrentLocation, float InvDistance, float Speed, const UCurveFloat* SpeedAdjustments) const;
+
+	/**
+	 * Bakes the mantle and ledge climb speed adjustment curves into lookup tables. This happens when the component is initialized, and whenever the curve settings change.
+	 * In the editor the tables are also rebaked when one of the curves is edited
+	 */
+	virtual void BakeSpeedCurves();
+
+	/** Bakes (or rebakes) the lookup table of a speed adjustment curve */
+	void BakeSpeedCurve(const UCurveFloat* Curve);
+
+#if WITH_EDITOR
+	/** Rebakes a speed adjustment curve's lookup table after the curve has been edited */
+	void OnSpeedCurveUpdated(UCurveBase* Curve, EPropertyChangeType::Type ChangeType);
+
+	/** Stops listening for edits to the baked speed adjustment curves */
+	void UnbindSpeedCurves();
+#endif
+
+	/** Returns the baked lookup table of a speed adjustment curve, or nullptr if the curve hasn't been baked */
+	const AdvancedMovementMath::FCurveTable* FindSpeedCurveTable(const UCurveFloat* Curve) const;
+
+	/** Returns the value of a speed adjustment curve (clamped between 0.1 and 10) from its lookup table, or from the curve itself if it hasn't been baked */
+	float EvaluateSpeedCurve(const UCurveFloat* Curve, float Percent) const;
+
+	/** The baked speed adjustment curves */
+	TMap<TObjectKey<UCurveFloat>, AdvancedMovementMath::FCurveTable> SpeedCurveTables;
+
+	/** The distances of the current mantle and ledge climb interps */
+#if ADVANCED_MOVEMENT_WITH_MANTLING
+	AdvancedMovementMath::FInterpDistance MantleInterpDistance;
+#endif
+#if ADVANCED_MOVEMENT_WITH_LEDGE_CLIMBING
+	AdvancedMovementMath::FInterpDistance LedgeClimbInterpDistance;
+#endif
 	
 	/** Enter wall mantle logic */
 	virtual void EnterMantle(EMovementMode PrevMode, ECustomMovementMode PrevCustomMode);
 
 	/** Exit wall mantle logic */
 	virtual void ExitMantle();
+
+
+	/** Issues the async mantle probe for the next tick, this happens after the character has moved */
+	virtual void IssueMantleProbe(float DeltaTime);
+
+	/**
+	 * Checks the async mantle probe from the previous tick against the mantle check's wall trace
+	 *
+	 * @param TraceStart				The start of the wall trace
+	 * @param TraceEnd					The end of the wall trace
+	 * @returns							True if the probe is valid for this trace, and it found that there isn't a wall or a ledge to mantle
+	 */
+	virtual bool MantleProbeFoundNoLedge(const FVector& TraceStart, const FVector& TraceEnd);
+
+#if ADVANCED_MOVEMENT_WITH_MANTLING
+	/** The async mantle probe from the previous tick */
+	FAdvancedMovementMantleProbe MantleProbe;
+#endif
+
+	/** Returns the level's baked ledge database, or nullptr if there isn't one that was baked with this character's settings */
+	virtual const UAdvancedMovementLedgeDatabase* GetLedgeDatabase() const;
+
+	/** The ledge bake runs the mantle checks for every ledge it finds */
+	friend class UAdvancedMovementLedgeBakeCommandlet;
 	
 
 //------------------------------------------------------------------------------//
@@ -1017,6 +1329,20 @@ protected:
 
 	/** Reset wall run information based on specific states and movement modes */
 	virtual void ResetWallRunInformation(EMovementMode PrevMode, uint8 PrevCustomMode);
+
+	/** Caches the wall the character is running on, and the direction along it */
+	virtual void UpdateWallRunContact(UPrimitiveComponent* Wall, const FVector& Normal);
+
+	/** Returns true if the wall run contact is still valid for the character's current location */
+	virtual bool IsWallRunContactValid() const;
+
+	/** Returns true if a wall run hit is against a different wall (or the wall's normal changed too much) than the wall run contact */
+	virtual bool WallRunContactChanged(const FHitResult& Hit) const;
+
+#if ADVANCED_MOVEMENT_WITH_WALL_RUNNING
+	/** The wall the character is running on */
+	FAdvancedMovementWallRunContact WallRunContact;
+#endif
 	
 	
 //------------------------------------------------------------------------------//
@@ -1046,8 +1372,9 @@ public:
 		
 		virtual void ClientFillNetworkMoveData(const FSavedMove_Character& ClientMove, ENetworkMoveType MoveType) override;
 		virtual bool Serialize(UCharacterMovementComponent& CharacterMovement, FArchive& Ar, UPackageMap* PackageMap, ENetworkMoveType MoveType) override;
-	
-		
+
+		/** Serializes the custom move values */
+		void SerializeCustomMoveData(FArchive& Ar, UPackageMap* PackageMap, bool& bOutSuccess);
 	};
 	
 	
@@ -1204,6 +1531,32 @@ public:
 	
 	/** Add State tags for whether the character is crouching */
 	virtual void HandleCrouchLogic();
+
+	
+protected:
+	/**
+	 * Reuses the last failed uncrouch while the character stays in place on the same base, instead of testing the standing capsule every tick while the character is under a ceiling.
+	 * The capsule is tested again once the character or its base moves, or after UnCrouchClearanceRefreshInterval in case something above the character has moved
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Character Movement (General Settings)|Crouching")
+	bool bUseUnCrouchClearanceCache;
+
+	/** How far the character has to move before the standing capsule is tested again */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Character Movement (General Settings)|Crouching", meta=(UIMin = "0", UIMax = "10", EditCondition = "bUseUnCrouchClearanceCache", EditConditionHides))
+	float UnCrouchClearanceTolerance;
+
+	/** How long a failed uncrouch is reused before the standing capsule is tested again, even if nothing has moved */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Character Movement (General Settings)|Crouching", meta=(UIMin = "0", UIMax = "1", EditCondition = "bUseUnCrouchClearanceCache", EditConditionHides))
+	float UnCrouchClearanceRefreshInterval;
+
+	/** Returns true if the last uncrouch failed, and the character hasn't moved since then */
+	virtual bool UnCrouchClearanceBlocked() const;
+
+	/** Saves the result of an uncrouch */
+	virtual void CacheUnCrouchClearance(bool bBlocked);
+
+	/** The last failed uncrouch. This isn't part of the saved moves, so it's cleared when the client is corrected and replays its moves */
+	FAdvancedMovementUnCrouchClearance UnCrouchClearance;
 	
 
 //------------------------------------------------------------------------------//
@@ -1237,6 +1590,13 @@ public:
 	/** Returns the ledge climb normal */
 	UFUNCTION(BlueprintCallable) virtual FVector GetLedgeClimbNormal() const;
 
+	/**
+	 * Returns the character and mantle settings that ledges are baked with
+	 *
+	 * @param bIncludeMantleObjects		Whether to copy the mantle objects into the settings, which allocates
+	 */
+	virtual FAdvancedMovementLedgeBakeSettings GetLedgeBakeSettings(bool bIncludeMantleObjects = true) const;
+
 	/** Returns the wall jump location */
 	UFUNCTION(BlueprintCallable) virtual FVector GetWallJumpLocation() const;
 	
@@ -1252,6 +1612,40 @@ public:
 	/** Set's the player's walk speed. This isn't net relevant, and should only be used with ai */
 	UFUNCTION(BlueprintCallable) virtual void SetMaxWalkSpeed(float Speed);
 
+	/** Sets the air strafe acceleration, and updates the air strafe speed caps */
+	UFUNCTION(BlueprintCallable) virtual void SetStrafingMaxAcceleration(float Acceleration);
+
+	/** Sets the air strafe speed gain multiplier, and updates the air strafe speed cap */
+	UFUNCTION(BlueprintCallable) virtual void SetAirStrafeSpeedGainMultiplier(float Multiplier);
+
+	/** Sets the strafe sway speed gain multiplier, and updates the strafe sway speed cap */
+	UFUNCTION(BlueprintCallable) virtual void SetStrafeSwaySpeedGainMultiplier(float Multiplier);
+
+	/** Sets the wall climb acceptable angle, and updates the wall climb thresholds */
+	UFUNCTION(BlueprintCallable) virtual void SetWallClimbAcceptableAngle(float Angle);
+
+	/** Sets the wall run acceptable angle radius, and updates the wall run threshold */
+	UFUNCTION(BlueprintCallable) virtual void SetWallRunAcceptableAngleRadius(float AngleRadius);
+
+	/** Sets the wall run contact angle threshold, and updates the wall run contact threshold */
+	UFUNCTION(BlueprintCallable) virtual void SetWallRunContactAngleThreshold(float Angle);
+
+	/** Sets the slide enter threshold, and updates the slide enter speed threshold */
+	UFUNCTION(BlueprintCallable) virtual void SetSlideEnterThreshold(float Threshold);
+
+	/** Sets the wall jump height from ground threshold, and updates the wall jump distance threshold */
+	UFUNCTION(BlueprintCallable) virtual void SetWallJumpHeightFromGroundThreshold(float Threshold);
+
+	/** Sets the ledge climb variations */
+	UFUNCTION(BlueprintCallable) virtual void SetLedgeClimbVariations(const TMap<EClimbType, FLedgeClimbInformation>& Variations);
+
+	/**
+	 * Rebuilds the values derived from the movement settings. This happens when the component is initialized, whenever the settings are changed in the editor, and with their setters
+	 * (blueprints also use the setters when they set the settings). It only has to be called after changing any of the air strafe, wall climb, wall run, slide enter, wall jump height,
+	 * or ledge climb settings (or the wall run contact angle threshold) directly in C++
+	 */
+	UFUNCTION(BlueprintCallable) virtual void RebuildDerivedParams();
+
 	
 //------------------------------------------------------------------------------//
 // Utility																		//
@@ -1279,10 +1673,208 @@ public:
 	virtual void ResetGroundStateInformation(EMovementMode PrevMode, uint8 PrevCustomMode);
 	
 	/** Util function for printing debug messages */
-	virtual void DebugGroundMovement(FString Message, FColor Color, bool DrawSphere = false);
+	virtual void DebugGroundMovement(const TCHAR* Message, FColor Color, bool DrawSphere = false);
 
 	/** Prints the input direction as a string for help with sensemaking of gaining momentum during strafing */
 	FString GetMovementDirection(const FVector2D& InputVector) const;
 
 	
+//------------------------------------------------------------------------------//
+// Profiling																	//
+//------------------------------------------------------------------------------//
+public:
+	/** Returns the scene queries the component issued during the previous tick */
+	const FAdvancedMovementSceneQueryStats& GetPreviousTickSceneQueryStats() const { return PreviousTickSceneQueryStats; }
+	
+	/** Returns the scene queries the component issued since the stats were last reset */
+	const FAdvancedMovementSceneQueryStats& GetTotalSceneQueryStats() const { return TotalSceneQueryStats; }
+
+	/** Clears the accumulated scene query stats */
+	virtual void ResetSceneQueryStats();
+
+	/** Logs the accumulated scene query stats, broken down by movement mode and movement feature */
+	virtual void DumpSceneQueryStats() const;
+
+	/**
+	 * Starts recording the inputs the component consumes every tick, for replays and regression tests (AdvancedMovementReplay commandlet).
+	 * This should be used on locally controlled or standalone characters, since the inputs are captured when the component ticks.
+	 */
+	UFUNCTION(BlueprintCallable, Category="Character Movement: Debugging") virtual void StartInputRecording();
+
+	/** Stops recording inputs and saves the recording. If the file path is empty it's saved to Saved/Profiling/AdvancedMovement/Recordings */
+	UFUNCTION(BlueprintCallable, Category="Character Movement: Debugging") virtual bool StopInputRecording(const FString& FilePath);
+
+	/** Whether the component is currently recording its inputs */
+	UFUNCTION(BlueprintPure, Category="Character Movement: Debugging") bool IsRecordingInput() const { return InputRecording.IsValid(); }
+
+	/**
+	 * Starts tracing the component's state after every physics substep into a ring buffer that holds the most recent substeps (see FAdvancedMovementTrace).
+	 * The trace is saved with DumpMovementTrace, or automatically when the character is corrected (AdvancedMovement.TraceDumpOnCorrection)
+	 */
+	UFUNCTION(BlueprintCallable, Category="Character Movement: Debugging") virtual void StartMovementTrace(int32 Capacity = 4096);
+
+	/** Stops tracing the component's movement and discards the trace */
+	UFUNCTION(BlueprintCallable, Category="Character Movement: Debugging") virtual void StopMovementTrace();
+
+	/** Saves the movement trace. If the file path is empty it's saved to Saved/Profiling/AdvancedMovement/Traces */
+	UFUNCTION(BlueprintCallable, Category="Character Movement: Debugging") virtual bool DumpMovementTrace(const FString& FilePath, const FString& Reason);
+
+	/** Whether the component is currently tracing its movement */
+	UFUNCTION(BlueprintPure, Category="Character Movement: Debugging") bool IsTracingMovement() const { return MovementTrace.IsValid(); }
+	
+	
+protected:
+	/** Counts a scene query that was issued by this component. These are captured per tick, and sent to the csv profiler */
+	void AddSceneQuery(EAdvancedMovementQuerySource Source, EAdvancedMovementQuery Query, uint32 Count = 1) const
+	{
+		SceneQueryStats.Add(GetProfiledPhysics(), Source, Query, Count);
+	}
+
+	/** Captures the scene queries of the previous tick and sends them to the csv profiler */
+	virtual void FlushSceneQueryStats();
+	
+	/** Returns the movement mode the component is currently in for profiling */
+	EAdvancedMovementPhysics GetProfiledPhysics() const;
+	
+	/** The scene queries that have been issued since the start of the current tick (the floor checks are const) */
+	mutable FAdvancedMovementSceneQueryStats SceneQueryStats;
+
+	/** The feature the floor checks are counted for */
+	EAdvancedMovementQuerySource FloorQuerySource = EAdvancedMovementQuerySource::Floor;
+	
+	/** The scene queries that were issued during the previous tick */
+	FAdvancedMovementSceneQueryStats PreviousTickSceneQueryStats;
+	
+	/** The scene queries that have been issued since the stats were last reset */
+	FAdvancedMovementSceneQueryStats TotalSceneQueryStats;
+	
+	/** The amount of ticks the total scene query stats have been captured for */
+	uint32 SceneQueryStatsTicks = 0;
+
+	/** Captures the inputs for the current tick */
+	virtual void RecordInputFrame(float DeltaTime);
+	
+	/** The current input recording */
+	TUniquePtr<FAdvancedMovementInputRecording> InputRecording;
+
+	/** Traces the physics substep that just finished, this only copies the component's state into the ring buffer */
+	FORCEINLINE void TraceSubstep(const float DeltaTime, const int32 Iterations, const FVector& HitNormal)
+	{
+		if (MovementTrace) RecordTraceSubstep(DeltaTime, Iterations, HitNormal);
+	}
+
+	/** Captures the component's state for the movement trace */
+	virtual void RecordTraceSubstep(float DeltaTime, int32 Iterations, const FVector& HitNormal);
+
+	/** Saves the movement trace after a correction, if the character hasn't been corrected recently */
+	virtual void DumpMovementTraceOnCorrection(const FString& Reason);
+
+	/** The current movement trace */
+	TUniquePtr<FAdvancedMovementTrace> MovementTrace;
+
+	/** The velocity branch of the current substep */
+	EAdvancedMovementTraceBranch TraceBranch = EAdvancedMovementTraceBranch::Default;
+
+	/** When the movement trace was last saved after a correction */
+	float LastTraceCorrectionDumpTime = -1;
+
+	
+//------------------------------------------------------------------------------//
+// Network Profiling															//
+//------------------------------------------------------------------------------//
+public:
+	/** Returns the network prediction telemetry since the last summary */
+	const FAdvancedMovementNetworkStats& GetNetworkStats() const { return NetworkStats; }
+
+	/** Logs a summary of the network prediction telemetry (corrections per movement mode, replayed moves, and upstream and downstream move bandwidth) */
+	virtual void LogNetworkStats(float Duration) const;
+	
+	
+protected:
+	/** Server side handling of a client's move, captures the corrections the server sends for each movement mode */
+	virtual void ServerMoveHandleClientError(float ClientTimeStamp, float DeltaTime, const FVector& Accel, const FVector& RelativeClientLocation,
+		UPrimitiveComponent* ClientMovementBase, FName ClientBaseBoneName, uint8 ClientMovementMode) override;
+
+	/** Replays the client's saved moves after a correction, captures how many moves were replayed and how long it took */
+	virtual bool ClientUpdatePositionAfterServerUpdate() override;
+
+	/** Sends the client's moves to the server, captures the amount of moves that are sent and the custom move data's bandwidth */
+	virtual void CallServerMovePacked(const FSavedMove_Character* NewMove, const FSavedMove_Character* PendingMove, const FSavedMove_Character* OldMove) override;
+
+	/** Sends the packed moves to the server, captures the upstream bandwidth */
+	virtual void ServerMovePacked_ClientSend(const FCharacterServerMovePackedBits& PackedBits) override;
+
+	/** Sends the move response to the client, captures the downstream bandwidth and how much of it is corrections */
+	virtual void MoveResponsePacked_ServerSend(const FCharacterMoveResponsePackedBits& PackedBits) override;
+
+	/** Logs the network telemetry summary once the AdvancedMovement.NetStatsLogInterval has passed */
+	virtual void UpdateNetworkStatsSummary();
+	
+	/** The network prediction telemetry since the last summary */
+	FAdvancedMovementNetworkStats NetworkStats;
+
+	/** When the network telemetry was last summarized */
+	float NetworkStatsStartTime = 0;
+
+	/** True while CallServerMovePacked serializes the moves into the engine's server move bit writer, which is when the custom move data's bits are counted */
+	bool bSerializingServerMove = false;
+
+	
+//------------------------------------------------------------------------------//
+// Scene Queries																//
+//------------------------------------------------------------------------------//
+public:
+	/**
+	 * Rebuilds the collision params the movement traces use, which ignore the character and its child actors. This happens when the component is initialized
+	 * and when its updated component changes, and needs to be called manually after a child actor is added or replaced at runtime
+	 */
+	UFUNCTION(BlueprintCallable, Category="Character Movement (General Settings)") virtual void RefreshMovementQueryParams();
+
+	/** Rebuilds the movement query params for the new character */
+	virtual void SetUpdatedComponent(USceneComponent* NewUpdatedComponent) override;
+	
+	
+protected:
+	/**
+	 * Returns a copy of the collision params for the movement traces, tagged for the scene query stats. Use with SCENE_QUERY_STAT(Name)
+	 *
+	 * @param TraceTag			The trace's name, for debugging and the collision analyzer
+	 * @param StatId			The trace's cycle stat in the collision stat group
+	 */
+	FCollisionQueryParams GetMovementQueryParams(FName TraceTag, TStatId StatId) const;
+
+	/** The collision params for the movement traces, with the character and its child actors ignored */
+	FCollisionQueryParams MovementQueryParams;
+
+
+protected:
+	/** How far the character is allowed to be from where it was predicted to be for the mantle and wall jump probes to be used */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Character Movement (General Settings)|Scene Queries", meta=(UIMin = "0", UIMax = "10"))
+	float LookAheadProbeTolerance;
+
+	/** Returns the world's probe batch */
+	UAdvancedMovementProbeSubsystem* GetProbeSubsystem() const;
+
+	/** Adds the probes the character is predicted to need during its next tick to the probe batch, this happens after a locally controlled character has moved */
+	virtual void IssueLookAheadProbes(float DeltaTime);
+
+	/** Adds the wall jump probe for the next tick */
+	virtual void IssueWallJumpProbe(float DeltaTime);
+
+	/**
+	 * Checks the wall jump probe from the previous tick against the wall jump traces
+	 *
+	 * @param TraceStart				The start of the wall jump traces
+	 * @param InputTraceEnd				The end of the trace in the input direction
+	 * @param FrontTraceEnd				The end of the trace in front of the character
+	 * @returns							True if the probe is valid for these traces, and neither found a wall
+	 */
+	virtual bool WallJumpProbeFoundNoWall(const FVector& TraceStart, const FVector& InputTraceEnd, const FVector& FrontTraceEnd) const;
+
+#if ADVANCED_MOVEMENT_WITH_WALL_JUMPING
+	/** The wall jump probe from the previous tick */
+	FAdvancedMovementWallJumpProbe WallJumpProbe;
+#endif
+
+	
 };
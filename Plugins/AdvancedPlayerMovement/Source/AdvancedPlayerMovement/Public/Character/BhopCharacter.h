@@ -8,6 +8,19 @@
 
 
 class UAdvancedMovementComponent;
+class ABhopCharacter;
+
+
+/** Applies a character's scripted input before its movement component ticks. This is only registered on characters that use scripted input */
+struct FBhopScriptedInputTickFunction : public FTickFunction
+{
+	/** The character that's driven by the scripted input */
+	ABhopCharacter* Target = nullptr;
+
+	virtual void ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent) override;
+	virtual FString DiagnosticMessage() override;
+};
+
 
 UCLASS(Blueprintable, Category=Character)
 class ADVANCEDPLAYERMOVEMENT_API ABhopCharacter : public ACharacter
@@ -20,6 +33,24 @@ public:
 
 protected:
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	/**
+	 * Drives the character with scripted strafe input (AdvancedMovementInput::EvaluateStrafeScript) instead of the player's input. This is for headless clients
+	 * and network bandwidth tests, and it's enabled on every locally controlled character when the game is launched with -AdvancedMovementScriptedInput.
+	 * This is read when play begins, and the input is applied from a tick function that the movement component's tick depends on, so it's consumed on the same frame
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Movement|Profiling") bool bUseScriptedInput;
+
+	/** How long the scripted input has been running */
+	float ScriptedInputTime;
+
+	/** Applies the scripted input before the movement component ticks */
+	FBhopScriptedInputTickFunction ScriptedInputTick;
+	friend FBhopScriptedInputTickFunction;
+
+	/** Adds the next frame of scripted input */
+	virtual void TickScriptedInput(float DeltaSeconds);
 	
 	/** Templated convenience version for retrieving the movement component. */
 	template<class T> T* GetMovementComp(void) const { return Cast<T>(GetMovementComponent()); }
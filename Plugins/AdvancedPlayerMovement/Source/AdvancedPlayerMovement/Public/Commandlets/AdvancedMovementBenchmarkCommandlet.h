@@ -0,0 +1,33 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "AdvancedMovementBenchmarkCommandlet.generated.h"
+
+
+/**
+ * Headless benchmark for the advanced movement component. Loads a map, spawns a crowd of bhop characters that are driven by scripted input,
+ * and writes the per frame cost of each physics function to a csv (with percentiles) so builds can be compared. The csv also has the scene queries
+ * each movement feature issued (see EAdvancedMovementQuerySource), per character per frame.
+ *
+ * Usage: UnrealEditor-Cmd <Project> -run=AdvancedMovementBenchmark -nullrhi [-Map=/Game/ThirdPerson/Maps/Demo] [-Count=64] [-Frames=3600]
+ *		[-Warmup=120] [-DeltaTime=0.016667] [-Character=/Game/Path/BP_Character.BP_Character_C] [-Output=Path/To/Results.csv] [-VelocityBatch]
+ *
+ * -VelocityBatch also runs the velocity phase of the crowd's airborne characters (the air strafe, strafe sway, and strafe lurch branches of CalcVelocity) every frame,
+ * once with the scalar math and once with the structure of arrays kernel (AdvancedMovementMathBatch) on the same inputs. Both are added to the csv
+ * (VelocityScalar and VelocityBatch, the calls are the batched characters), and the largest difference between their results is logged.
+ *
+ * The engine free movement math (AdvancedMovementMath) is benchmarked without a map by the AdvancedPlayerMovementTests low level tests, see AdvancedPlayerMovementTests.Target.cs
+ */
+UCLASS()
+class UAdvancedMovementBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UAdvancedMovementBenchmarkCommandlet();
+	virtual int32 Main(const FString& Params) override;
+
+};
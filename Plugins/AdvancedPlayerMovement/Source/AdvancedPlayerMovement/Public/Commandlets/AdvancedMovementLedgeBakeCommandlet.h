@@ -0,0 +1,56 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "AdvancedMovementLedgeBakeCommandlet.generated.h"
+
+class UAdvancedMovementComponent;
+class UWorld;
+struct FAdvancedMovementBakedLedge;
+
+
+/**
+ * Bakes every mantleable ledge of a level into a ledge database (see UAdvancedMovementLedgeDatabase). The level's static mantle objects are sampled on a grid,
+ * and a character is placed in front of every surface it finds (from each direction) to run CheckIfSafeToMantleLedge, so the baked ledges follow the same rules
+ * as the mantle traces. The room to climb and stand on a ledge isn't baked, it's still checked when the character mantles since something could be in the way.
+ * The database is saved next to the map, and it has to be rebaked whenever the level or the character's mantle settings change.
+ *
+ * Usage: UnrealEditor-Cmd <Project> -run=AdvancedMovementLedgeBake -nullrhi -Map=/Game/Map [-Character=/Game/Path/BP_Character.BP_Character_C]
+ *		[-Spacing=25] [-Directions=8] [-CellSize=100] [-Output=/Game/Path/Map_Ledges]
+ *
+ * The database isn't referenced by the map, so the map's directory has to be cooked (DirectoriesToAlwaysCook) for it to be packaged.
+ */
+UCLASS()
+class UAdvancedMovementLedgeBakeCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UAdvancedMovementLedgeBakeCommandlet();
+	virtual int32 Main(const FString& Params) override;
+
+protected:
+	/**
+	 * Finds the surfaces of the level's static mantle objects that could be ledges
+	 *
+	 * @param World				The level
+	 * @param MovementComponent	The character's movement component, for its mantle objects
+	 * @param Spacing			The distance between the samples
+	 * @returns					Every surface that was found
+	 */
+	virtual TArray<FVector> FindLedgeSurfaces(UWorld* World, UAdvancedMovementComponent* MovementComponent, float Spacing) const;
+
+	/**
+	 * Places the character in front of a surface and runs the mantle checks from a few heights
+	 *
+	 * @param MovementComponent	The character's movement component
+	 * @param Surface			The surface that might be a ledge
+	 * @param Direction			The direction the character is facing
+	 * @param OutLedge			The ledge that was found
+	 * @returns					True if there's a ledge the character can mantle
+	 */
+	virtual bool BakeLedge(UAdvancedMovementComponent* MovementComponent, const FVector& Surface, const FVector& Direction, FAdvancedMovementBakedLedge& OutLedge) const;
+
+};
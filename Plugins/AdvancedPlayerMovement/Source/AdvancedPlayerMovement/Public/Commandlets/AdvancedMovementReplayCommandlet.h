@@ -0,0 +1,33 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "AdvancedMovementReplayCommandlet.generated.h"
+
+
+/**
+ * Replays an input recording (see UAdvancedMovementComponent::StartInputRecording) on its map, and logs the tick cost and how far the replay drifted from the
+ * recording's baseline. The regression gate for movement tuning and performance (the trajectory tolerance and tick cost) is the AdvancedMovement.Replay
+ * automation tests (the baseline check and the frame rate sweep), which replay the recording that's checked into the plugin's Resources/Recordings folder.
+ *
+ * Usage: UnrealEditor-Cmd <Project> -run=AdvancedMovementReplay -nullrhi -Recording=Path/To/Session.amrec [-Map=/Game/Map] [-WriteBaseline] [-Output=Path/To/Rebaselined.amrec]
+ *
+ * -WriteBaseline stores the replayed trajectory, end state, and tick cost in the recording so future replays are compared against it.
+ * Recordings of networked sessions should be rebaselined once, since the recorded trajectory includes server corrections.
+ *
+ * -AllocationCheck hooks the allocator during the replay and fails if the movement tick (PerformMovement) allocates on the heap after the warm up frames
+ * (60 by default, or -AllocationWarmupFrames=120). The callstacks of the first allocations are logged.
+ *		UnrealEditor-Cmd <Project> -run=AdvancedMovementReplay -nullrhi -Recording=Path/To/Session.amrec -AllocationCheck [-AllocationWarmupFrames=60]
+ */
+UCLASS()
+class UAdvancedMovementReplayCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UAdvancedMovementReplayCommandlet();
+	virtual int32 Main(const FString& Params) override;
+
+};
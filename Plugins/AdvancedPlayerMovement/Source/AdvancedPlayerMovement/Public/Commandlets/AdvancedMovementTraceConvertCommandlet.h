@@ -0,0 +1,26 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "AdvancedMovementTraceConvertCommandlet.generated.h"
+
+
+/**
+ * Converts a movement trace (see UAdvancedMovementComponent::StartMovementTrace) to csv or json.
+ *
+ * Usage: UnrealEditor-Cmd <Project> -run=AdvancedMovementTraceConvert -Trace=Path/To/Trace.amtrace [-Format=csv|json] [-Output=Path/To/Trace.csv]
+ *
+ * The output defaults to the trace's path with the format's extension.
+ */
+UCLASS()
+class UAdvancedMovementTraceConvertCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UAdvancedMovementTraceConvertCommandlet();
+	virtual int32 Main(const FString& Params) override;
+
+};
@@ -0,0 +1,57 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+
+/**
+ * The movement features that are compiled into the movement component. Every feature is compiled in by default, and a project compiles a feature out by defining
+ * its macro as 0 in its Target.cs, so the plugin's source doesn't have to be edited:
+ *		GlobalDefinitions.Add("ADVANCED_MOVEMENT_WITH_WALL_CLIMBING=0");
+ * Global definitions need the target to have its own build environment, editor targets share the engine's by default so they also need
+ * BuildEnvironment = TargetBuildEnvironment.Unique (which requires a source build of the engine). Every target of the project should define the same features.
+ * A compiled out feature ignores its runtime toggle (ex: bUseWallRunning), its movement mode is never entered, and its physics, checks, and transient state are
+ * removed from the component.
+ * The feature's settings are still reflected (UHT doesn't allow properties behind custom macros), so assets and blueprints that reference them still load.
+ */
+#ifndef ADVANCED_MOVEMENT_WITH_BHOPPING
+#define ADVANCED_MOVEMENT_WITH_BHOPPING 1
+#endif
+
+#ifndef ADVANCED_MOVEMENT_WITH_SLIDING
+#define ADVANCED_MOVEMENT_WITH_SLIDING 1
+#endif
+
+#ifndef ADVANCED_MOVEMENT_WITH_WALL_JUMPING
+#define ADVANCED_MOVEMENT_WITH_WALL_JUMPING 1
+#endif
+
+#ifndef ADVANCED_MOVEMENT_WITH_WALL_CLIMBING
+#define ADVANCED_MOVEMENT_WITH_WALL_CLIMBING 1
+#endif
+
+#ifndef ADVANCED_MOVEMENT_WITH_WALL_RUNNING
+#define ADVANCED_MOVEMENT_WITH_WALL_RUNNING 1
+#endif
+
+#ifndef ADVANCED_MOVEMENT_WITH_MANTLING
+#define ADVANCED_MOVEMENT_WITH_MANTLING 1
+#endif
+
+#ifndef ADVANCED_MOVEMENT_WITH_LEDGE_CLIMBING
+#define ADVANCED_MOVEMENT_WITH_LEDGE_CLIMBING 1
+#endif
+
+
+/** The compiled in movement features as constants, so the component's hot paths fold the checks of compiled out features away */
+struct FAdvancedMovementFeatures
+{
+	static constexpr bool bBhopping = ADVANCED_MOVEMENT_WITH_BHOPPING != 0;
+	static constexpr bool bSliding = ADVANCED_MOVEMENT_WITH_SLIDING != 0;
+	static constexpr bool bWallJumping = ADVANCED_MOVEMENT_WITH_WALL_JUMPING != 0;
+	static constexpr bool bWallClimbing = ADVANCED_MOVEMENT_WITH_WALL_CLIMBING != 0;
+	static constexpr bool bWallRunning = ADVANCED_MOVEMENT_WITH_WALL_RUNNING != 0;
+	static constexpr bool bMantling = ADVANCED_MOVEMENT_WITH_MANTLING != 0;
+	static constexpr bool bLedgeClimbing = ADVANCED_MOVEMENT_WITH_LEDGE_CLIMBING != 0;
+};
@@ -0,0 +1,275 @@
+#pragma once
+
+
+#include "CoreMinimal.h"
+
+
+/**
+ * The movement calculations that don't need a world, a component, or any UObjects. Everything in here only depends on Core,
+ * so it can be compiled into low level tests and benchmarks without loading the engine. The movement component forwards its
+ * air strafing, wall jump, and mantle/climb interp calculations to these functions.
+ */
+namespace AdvancedMovementMath
+{
+	/** The tuning for a single air strafe step */
+	struct FAirStrafeParams
+	{
+		/** The most speed that can be gained along the acceleration direction (GetMaxAcceleration() / 100 * the speed gain multiplier) */
+		float AirSpeedCap = 0;
+
+		/** How quickly the velocity is redirected towards the acceleration (the rotation rate) */
+		float AccelerationMultiplier = 0;
+
+		/** The character's air control */
+		float AirControl = 1;
+
+		FAirStrafeParams() = default;
+		FAirStrafeParams(const float InAirSpeedCap, const float InAccelerationMultiplier, const float InAirControl)
+			: AirSpeedCap(InAirSpeedCap), AccelerationMultiplier(InAccelerationMultiplier), AirControl(InAirControl) {}
+	};
+
+	/** Strafing in the opposite direction of the velocity past this angle (dot product) doesn't add anything during strafe sway */
+	constexpr float StrafeSwayMinAngle = -0.34f;
+
+	/** Walls that are hit at a shallower angle than this (dot product between the wall and the character's trajectory) are treated as sliding alongside the wall */
+	constexpr float WallJumpSlideAngle = -0.45f;
+
+
+//------------------------------------------------------------------------------//
+// Air Strafing																	//
+//------------------------------------------------------------------------------//
+	/**
+	 * Returns the velocity that air strafing adds during a single tick.
+	 * The added speed is clamped so the velocity projected onto the acceleration direction never goes past the air speed cap, which also bounds the speed that can be gained each tick to the cap.
+	 *
+	 * @param Velocity			The character's velocity before this tick
+	 * @param AccelDir			The normalized acceleration direction (from the player's input)
+	 * @param Acceleration		The lateral acceleration for this tick (after air control is factored in)
+	 * @param Params			The speed cap and rotation rate of the strafe
+	 * @param DeltaTime			The time step
+	 * @param OutProjVelocity	The velocity projected onto the acceleration direction (negative values add to speed)
+	 * @returns					The velocity to add, or zero if the character is already at the speed cap in that direction
+	 */
+	FORCEINLINE FVector GetAirStrafeVelocity(const FVector& Velocity, const FVector& AccelDir, const FVector& Acceleration, const FAirStrafeParams& Params, const float DeltaTime, float& OutProjVelocity)
+	{
+		OutProjVelocity = Velocity.X * AccelDir.X + Velocity.Y * AccelDir.Y;
+
+		const float AddSpeed = Acceleration.GetClampedToMaxSize2D(Params.AirSpeedCap).Size2D() - OutProjVelocity;
+		if (AddSpeed <= 0.0f) return FVector::ZeroVector;
+
+		const FVector AddedVelocity = Acceleration * Params.AccelerationMultiplier * Params.AirControl * DeltaTime;
+		return AddedVelocity.GetClampedToMaxSize2D(AddSpeed);
+	}
+
+	/** Returns the velocity that air strafing adds during a single tick */
+	FORCEINLINE FVector GetAirStrafeVelocity(const FVector& Velocity, const FVector& AccelDir, const FVector& Acceleration, const FAirStrafeParams& Params, const float DeltaTime)
+	{
+		float ProjVelocity;
+		return GetAirStrafeVelocity(Velocity, AccelDir, Acceleration, Params, DeltaTime, ProjVelocity);
+	}
+
+	/** Strafe sway only adds velocity if the player isn't strafing against their momentum */
+	FORCEINLINE bool CanStrafeSway(const FVector& Velocity, const FVector& AccelDir)
+	{
+		return Velocity.GetSafeNormal2D().Dot(AccelDir) > StrafeSwayMinAngle;
+	}
+
+	/**
+	 * Returns how much strafe lurch influences the velocity (0-1). The lurch is at full strength for the full strength duration, and then fades out over the rest of the duration.
+	 *
+	 * @param Time					The current time
+	 * @param StartTime				When the strafe lurch started
+	 * @param Duration				How long the strafe lurch lasts
+	 * @param FullStrengthDuration	How long the strafe lurch is at full strength
+	 * @param Strength				The strafe lurch strength multiplier
+	 */
+	FORCEINLINE float GetStrafeLurchStrength(const float Time, const float StartTime, const float Duration, const float FullStrengthDuration, const float Strength)
+	{
+		float LurchStrength;
+		if (StartTime + FullStrengthDuration > Time) LurchStrength = 1;
+		else LurchStrength = FMath::GetMappedRangeValueClamped(FVector2D(0, Duration - FullStrengthDuration), FVector2D(0, 1), StartTime + Duration - Time);
+		return FMath::Clamp(LurchStrength * Strength, 0.f, 1.f);
+	}
+
+	/**
+	 * Returns the velocity the strafe lurch is redirecting the character towards. This keeps the character's speed and turns it in the direction of the acceleration, with friction based on how much the velocity changed.
+	 *
+	 * @param Velocity			The character's velocity before this tick
+	 * @param AccelDir			The normalized acceleration direction
+	 * @param Friction			The strafe lurch friction
+	 * @param DeltaTime			The time step
+	 */
+	FORCEINLINE FVector GetStrafeLurchVelocity(const FVector& Velocity, const FVector& AccelDir, const float Friction, const float DeltaTime)
+	{
+		FVector LurchVelocity = AccelDir.IsNearlyZero() ? Velocity : AccelDir * Velocity.Size2D();
+		LurchVelocity += (Velocity - LurchVelocity) * (Friction * 10) * DeltaTime;
+		return LurchVelocity;
+	}
+
+	/** Blends between the air strafe and strafe lurch velocities based on the lurch strength (0-1) */
+	FORCEINLINE FVector BlendStrafeLurch(const FVector& AirStrafeVelocity, const FVector& LurchVelocity, const float LurchStrength)
+	{
+		return AirStrafeVelocity * (1 - LurchStrength) + LurchVelocity * LurchStrength;
+	}
+
+
+//------------------------------------------------------------------------------//
+// Wall Jumping																	//
+//------------------------------------------------------------------------------//
+	/**
+	 * Returns the wall jump direction for jumping off of a wall while in the air. The trajectory from the previous ground location to the wall is reflected off of the wall,
+	 * and trajectories that are sliding alongside the wall (or that start behind it) are adjusted so the character always jumps away from the wall.
+	 *
+	 * @param WallLocation		Where the character hit the wall (flattened)
+	 * @param PrevLocation		Where the character was last on the ground (flattened, and spaced away from the wall)
+	 * @param WallNormal		The wall's normal
+	 * @param WallImpactNormal	The wall's impact normal
+	 * @param Velocity			The character's current velocity
+	 * @returns					The wall jump direction. The Z value is the boost scale (1, or 0.5 if the character is falling)
+	 */
+	FORCEINLINE FVector GetWallJumpDirection(const FVector& WallLocation, const FVector& PrevLocation, const FVector& WallNormal, const FVector& WallImpactNormal, const FVector& Velocity)
+	{
+		const FVector CharacterTrajectory = (WallLocation - PrevLocation).GetSafeNormal2D();
+		const float WallAngle = WallImpactNormal.Dot(CharacterTrajectory); // -0.5 or greater is 45^ or less
+		FVector WallJump = (CharacterTrajectory - 2 * (CharacterTrajectory | WallImpactNormal) * WallImpactNormal).GetSafeNormal();
+
+		// The previous ground location is behind the wall, align it to the wall so it doesn't create the wrong wall jumps
+		if (WallAngle > 0)
+		{
+			const FVector LocationAlignedToWall = (WallNormal.GetSafeNormal2D() * WallLocation) + ((FVector(1) - WallNormal.GetSafeNormal2D()) * PrevLocation);
+			const float DistanceFromWall = LocationAlignedToWall.Size();
+			const FVector WallJumpTrajectory = (WallLocation - (LocationAlignedToWall + (WallImpactNormal * DistanceFromWall))).GetSafeNormal();
+			WallJump = (WallJumpTrajectory - 2 * (WallJumpTrajectory | WallImpactNormal) * WallImpactNormal).GetSafeNormal();
+		}
+		// Sliding alongside the wall (during Air Strafing)
+		else if (WallAngle > WallJumpSlideAngle)
+		{
+			WallJump = (Velocity.GetSafeNormal2D() - WallImpactNormal) / 2 + WallImpactNormal;
+		}
+
+		// Wall jump Z velocity is factored in during the boost, and not while redirecting the velocity. Smooth out gravity for non positive wall jump values
+		return FVector(WallJump.X, WallJump.Y, Velocity.GetSafeNormal().Z < 0 ? 0.5 : 1);
+	}
+
+	/** Returns the wall jump direction while wall running, which is halfway between the wall's normal and the direction the character is facing along the wall */
+	FORCEINLINE FVector GetWallRunJumpDirection(const FVector& Forward, const FVector& WallRight, const FVector& WallRunNormal)
+	{
+		const FVector WallJumpDirection = Forward.Dot(WallRight) < 0 ? WallRight * -1 : WallRight;
+		return FVector(
+			FMath::Clamp((WallJumpDirection.X + WallRunNormal.X) / 2, -1, 1),
+			FMath::Clamp((WallJumpDirection.Y + WallRunNormal.Y) / 2, -1, 1),
+			1
+		);
+	}
+
+	/**
+	 * Returns the velocity after a wall jump. The character's current speed is redirected in the wall jump direction (with a minimum speed), and the boost is added on top of it.
+	 *
+	 * @param WallJump					The wall jump direction
+	 * @param Velocity					The character's current velocity
+	 * @param Speed						The minimum speed of the wall jump
+	 * @param Boost						The horizontal (X) and vertical (Y) boost
+	 * @param OutRedirectedVelocity		The character's velocity redirected in the wall jump direction, without the boost
+	 */
+	FORCEINLINE FVector GetWallJumpVelocity(const FVector& WallJump, const FVector& Velocity, const float Speed, const FVector2D& Boost, FVector& OutRedirectedVelocity)
+	{
+		OutRedirectedVelocity = FVector(WallJump.X, WallJump.Y, 0) * FMath::Max(Velocity.Size2D(), Speed);
+		return OutRedirectedVelocity + (WallJump * FVector(Boost.X, Boost.X, Boost.Y));
+	}
+
+
+//------------------------------------------------------------------------------//
+// Mantling / Climbing															//
+//------------------------------------------------------------------------------//
+	/** Returns how much of the interp is left (1 at the start location, 0 at the target location) */
+	FORCEINLINE float GetInterpRemaining(const FVector& StartLocation, const FVector& TargetLocation, const FVector& CurrentLocation)
+	{
+		return (TargetLocation - CurrentLocation).Size() / (TargetLocation - StartLocation).Size();
+	}
+
+	/** Returns how much of the interp is left, with the inverse of the distance between the start and target locations already computed (see FInterpDistance) */
+	FORCEINLINE float GetInterpRemaining(const FVector& TargetLocation, const FVector& CurrentLocation, const float InvDistance)
+	{
+		return (TargetLocation - CurrentLocation).Size() * InvDistance;
+	}
+
+	/** The inverse of the distance between an interp's start and target locations, which is only recomputed when either of them change */
+	struct FInterpDistance
+	{
+		FVector StartLocation = FVector::ZeroVector;
+		FVector TargetLocation = FVector::ZeroVector;
+		float InvDistance = 0;
+
+		float Get(const FVector& InStartLocation, const FVector& InTargetLocation)
+		{
+			if (InStartLocation != StartLocation || InTargetLocation != TargetLocation)
+			{
+				StartLocation = InStartLocation;
+				TargetLocation = InTargetLocation;
+				const float Distance = (TargetLocation - StartLocation).Size();
+				InvDistance = Distance > 0 ? 1 / Distance : 0;
+			}
+			return InvDistance;
+		}
+	};
+
+	/**
+	 * A curve that's been baked into uniformly spaced samples, which is evaluated with a clamped lerp between the two closest samples instead of searching the curve's keys.
+	 * The speed adjustment curves are baked from 0 to 10 (the interp percent * 10), see UAdvancedMovementComponent::BakeSpeedCurves
+	 */
+	struct FCurveTable
+	{
+		/** The amount of intervals between the samples */
+		static constexpr int32 Intervals = 64;
+
+		/** The samples, including both ends of the curve */
+		float Values[Intervals + 1] = {};
+
+		/** The time of the first sample, and the amount of samples per unit of time */
+		float MinTime = 0;
+		float SamplesPerTime = 1;
+
+		/**
+		 * Samples a curve over a range
+		 *
+		 * @param Evaluate		Returns the curve's value at a time
+		 * @param InMinTime		The start of the range
+		 * @param InMaxTime		The end of the range
+		 */
+		template<typename FunctionType>
+		void Bake(FunctionType&& Evaluate, const float InMinTime, const float InMaxTime)
+		{
+			MinTime = InMinTime;
+			SamplesPerTime = Intervals / FMath::Max(InMaxTime - InMinTime, UE_SMALL_NUMBER);
+			for (int32 Index = 0; Index <= Intervals; Index++)
+			{
+				Values[Index] = Evaluate(InMinTime + Index / SamplesPerTime);
+			}
+		}
+
+		/** Returns the curve's value, times outside of the baked range are clamped to its ends */
+		FORCEINLINE float Evaluate(const float Time) const
+		{
+			const float Sample = FMath::Clamp((Time - MinTime) * SamplesPerTime, 0.f, static_cast<float>(Intervals));
+			const int32 Index = FMath::Min(static_cast<int32>(Sample), Intervals - 1);
+			return FMath::Lerp(Values[Index], Values[Index + 1], Sample - Index);
+		}
+	};
+
+	/**
+	 * Returns the offset for a single step towards the target location. The step never overshoots the target.
+	 *
+	 * @param TargetLocation	The location the character is interpolating to
+	 * @param CurrentLocation	The character's current location
+	 * @param Speed				The interp speed
+	 * @param SpeedAdjustment	The speed multiplier for the current step (from the speed adjustment curves)
+	 * @param DeltaTime			The time step
+	 */
+	FORCEINLINE FVector GetInterpStep(const FVector& TargetLocation, const FVector& CurrentLocation, const float Speed, const float SpeedAdjustment, const float DeltaTime)
+	{
+		const FVector MovementVector = TargetLocation - CurrentLocation;
+		const FVector Adjusted = MovementVector.GetSafeNormal() * Speed * SpeedAdjustment * DeltaTime;
+		if (Adjusted.Size() > MovementVector.Size()) return MovementVector;
+		return Adjusted;
+	}
+}
@@ -0,0 +1,201 @@
+#pragma once
+
+
+#include "CoreMinimal.h"
+#include "Math/VectorRegister.h"
+#include "Core/AdvancedMovementMath.h"
+
+
+/**
+ * Batched versions of the air strafe calculations in AdvancedMovementMath, for updating the velocity of many airborne characters at once.
+ * The characters are stored as a structure of arrays so each vector register holds the same value for four characters, and every branch of the
+ * scalar math is replaced with a mask. The results match the scalar functions (within float precision, the scalar functions use doubles).
+ */
+namespace AdvancedMovementMath
+{
+	/** The air strafe inputs for a batch of characters. Each array is padded to a multiple of four, and the padding is zeroed so it doesn't affect anything */
+	struct FStrafeBatch
+	{
+		/** The characters' velocities. The batch functions update these in place */
+		TArray<float> VelocityX;
+		TArray<float> VelocityY;
+		TArray<float> VelocityZ;
+
+		/** The normalized acceleration directions (from the player's input), these are always horizontal in the air */
+		TArray<float> AccelDirX;
+		TArray<float> AccelDirY;
+
+		/** The lateral accelerations for this tick (after air control is factored in) */
+		TArray<float> AccelerationX;
+		TArray<float> AccelerationY;
+		TArray<float> AccelerationZ;
+
+		/** The time steps */
+		TArray<float> DeltaTime;
+
+		/** How much strafe lurch influences each character (0-1), see GetStrafeLurchStrength. This is only used by StrafeLurchBatch */
+		TArray<float> LurchStrength;
+
+		/** Returns the amount of characters in the batch */
+		int32 Num() const { return Count; }
+
+		/** Resizes the batch, and zeroes every character */
+		void SetNum(const int32 InCount)
+		{
+			Count = InCount;
+			const int32 Padded = Align(InCount, 4);
+			for (TArray<float>* Array : { &VelocityX, &VelocityY, &VelocityZ, &AccelDirX, &AccelDirY, &AccelerationX, &AccelerationY, &AccelerationZ, &DeltaTime, &LurchStrength })
+			{
+				Array->Reset();
+				Array->SetNumZeroed(Padded);
+			}
+		}
+
+		/** Adds a character's values to the batch */
+		void Set(const int32 Index, const FVector& Velocity, const FVector& AccelDir, const FVector& Acceleration, const float InDeltaTime, const float InLurchStrength = 0)
+		{
+			VelocityX[Index] = Velocity.X;
+			VelocityY[Index] = Velocity.Y;
+			VelocityZ[Index] = Velocity.Z;
+			AccelDirX[Index] = AccelDir.X;
+			AccelDirY[Index] = AccelDir.Y;
+			AccelerationX[Index] = Acceleration.X;
+			AccelerationY[Index] = Acceleration.Y;
+			AccelerationZ[Index] = Acceleration.Z;
+			DeltaTime[Index] = InDeltaTime;
+			LurchStrength[Index] = InLurchStrength;
+		}
+
+		/** Returns a character's velocity */
+		FVector GetVelocity(const int32 Index) const
+		{
+			return FVector(VelocityX[Index], VelocityY[Index], VelocityZ[Index]);
+		}
+
+	private:
+		int32 Count = 0;
+	};
+
+
+//------------------------------------------------------------------------------//
+// Air Strafing																	//
+//------------------------------------------------------------------------------//
+	/**
+	 * Returns the velocity that air strafing adds for four characters, see GetAirStrafeVelocity
+	 *
+	 * @param Batch				The characters
+	 * @param Index				The first of the four characters
+	 * @param Params			The speed cap and rotation rate of the strafe
+	 * @param OutX				The added velocity
+	 * @param OutY				The added velocity
+	 * @param OutZ				The added velocity
+	 * @param OutProjVelocity	The velocity projected onto the acceleration direction
+	 */
+	FORCEINLINE void GetAirStrafeVelocity4(const FStrafeBatch& Batch, const int32 Index, const FAirStrafeParams& Params,
+		VectorRegister4Float& OutX, VectorRegister4Float& OutY, VectorRegister4Float& OutZ, VectorRegister4Float& OutProjVelocity)
+	{
+		const VectorRegister4Float Zero = VectorZeroFloat();
+		const VectorRegister4Float VelocityX = VectorLoad(&Batch.VelocityX[Index]);
+		const VectorRegister4Float VelocityY = VectorLoad(&Batch.VelocityY[Index]);
+		const VectorRegister4Float AccelerationX = VectorLoad(&Batch.AccelerationX[Index]);
+		const VectorRegister4Float AccelerationY = VectorLoad(&Batch.AccelerationY[Index]);
+		const VectorRegister4Float AccelerationZ = VectorLoad(&Batch.AccelerationZ[Index]);
+		OutProjVelocity = VectorMultiplyAdd(VelocityX, VectorLoad(&Batch.AccelDirX[Index]), VectorMultiply(VelocityY, VectorLoad(&Batch.AccelDirY[Index])));
+
+		// The speed that can still be gained along the acceleration direction
+		const VectorRegister4Float AccelerationSize = VectorSqrt(VectorMultiplyAdd(AccelerationX, AccelerationX, VectorMultiply(AccelerationY, AccelerationY)));
+		const VectorRegister4Float AddSpeed = VectorSubtract(VectorMin(AccelerationSize, VectorSetFloat1(Params.AirSpeedCap)), OutProjVelocity);
+
+		// Clamp the added velocity (horizontally) to the speed that can be gained
+		const VectorRegister4Float Scale = VectorMultiply(VectorSetFloat1(Params.AccelerationMultiplier * Params.AirControl), VectorLoad(&Batch.DeltaTime[Index]));
+		const VectorRegister4Float AddedX = VectorMultiply(AccelerationX, Scale);
+		const VectorRegister4Float AddedY = VectorMultiply(AccelerationY, Scale);
+		const VectorRegister4Float AddedSize = VectorSqrt(VectorMax(VectorMultiplyAdd(AddedX, AddedX, VectorMultiply(AddedY, AddedY)), VectorSetFloat1(UE_SMALL_NUMBER)));
+		const VectorRegister4Float Clamp = VectorMin(VectorOneFloat(), VectorDivide(AddSpeed, AddedSize));
+
+		// Nothing is added if the character is already at the speed cap in that direction
+		const VectorRegister4Float CanAdd = VectorCompareGT(AddSpeed, Zero);
+		OutX = VectorSelect(CanAdd, VectorMultiply(AddedX, Clamp), Zero);
+		OutY = VectorSelect(CanAdd, VectorMultiply(AddedY, Clamp), Zero);
+		OutZ = VectorSelect(CanAdd, VectorMultiply(AccelerationZ, Scale), Zero);
+	}
+
+	/** Adds air strafing to every character's velocity (the regular bhop strafing) */
+	FORCEINLINE void AirStrafeBatch(FStrafeBatch& Batch, const FAirStrafeParams& Params)
+	{
+		for (int32 Index = 0; Index < Batch.Num(); Index += 4)
+		{
+			VectorRegister4Float AddedX, AddedY, AddedZ, ProjVelocity;
+			GetAirStrafeVelocity4(Batch, Index, Params, AddedX, AddedY, AddedZ, ProjVelocity);
+			VectorStore(VectorAdd(VectorLoad(&Batch.VelocityX[Index]), AddedX), &Batch.VelocityX[Index]);
+			VectorStore(VectorAdd(VectorLoad(&Batch.VelocityY[Index]), AddedY), &Batch.VelocityY[Index]);
+			VectorStore(VectorAdd(VectorLoad(&Batch.VelocityZ[Index]), AddedZ), &Batch.VelocityZ[Index]);
+		}
+	}
+
+	/** Adds strafe sway to every character's velocity, characters that are strafing against their momentum are left alone (see CanStrafeSway) */
+	FORCEINLINE void StrafeSwayBatch(FStrafeBatch& Batch, const FAirStrafeParams& Params)
+	{
+		for (int32 Index = 0; Index < Batch.Num(); Index += 4)
+		{
+			VectorRegister4Float AddedX, AddedY, AddedZ, ProjVelocity;
+			GetAirStrafeVelocity4(Batch, Index, Params, AddedX, AddedY, AddedZ, ProjVelocity);
+
+			// The angle between the velocity and the acceleration, without normalizing the velocity. Characters that aren't moving can always sway
+			const VectorRegister4Float VelocityX = VectorLoad(&Batch.VelocityX[Index]);
+			const VectorRegister4Float VelocityY = VectorLoad(&Batch.VelocityY[Index]);
+			const VectorRegister4Float SpeedSquared = VectorMultiplyAdd(VelocityX, VelocityX, VectorMultiply(VelocityY, VelocityY));
+			const VectorRegister4Float CanSway = VectorBitwiseOr(
+				VectorCompareGT(ProjVelocity, VectorMultiply(VectorSetFloat1(StrafeSwayMinAngle), VectorSqrt(SpeedSquared))),
+				VectorCompareLE(SpeedSquared, VectorSetFloat1(UE_SMALL_NUMBER))
+			);
+
+			const VectorRegister4Float Zero = VectorZeroFloat();
+			VectorStore(VectorAdd(VelocityX, VectorSelect(CanSway, AddedX, Zero)), &Batch.VelocityX[Index]);
+			VectorStore(VectorAdd(VelocityY, VectorSelect(CanSway, AddedY, Zero)), &Batch.VelocityY[Index]);
+			VectorStore(VectorAdd(VectorLoad(&Batch.VelocityZ[Index]), VectorSelect(CanSway, AddedZ, Zero)), &Batch.VelocityZ[Index]);
+		}
+	}
+
+	/**
+	 * Blends every character's air strafe velocity with its strafe lurch velocity, see GetStrafeLurchVelocity and BlendStrafeLurch
+	 *
+	 * @param Batch				The characters, with their lurch strengths
+	 * @param Params			The speed cap and rotation rate of the air strafe
+	 * @param Friction			The strafe lurch friction
+	 */
+	FORCEINLINE void StrafeLurchBatch(FStrafeBatch& Batch, const FAirStrafeParams& Params, const float Friction)
+	{
+		for (int32 Index = 0; Index < Batch.Num(); Index += 4)
+		{
+			VectorRegister4Float AddedX, AddedY, AddedZ, ProjVelocity;
+			GetAirStrafeVelocity4(Batch, Index, Params, AddedX, AddedY, AddedZ, ProjVelocity);
+			const VectorRegister4Float VelocityX = VectorLoad(&Batch.VelocityX[Index]);
+			const VectorRegister4Float VelocityY = VectorLoad(&Batch.VelocityY[Index]);
+			const VectorRegister4Float VelocityZ = VectorLoad(&Batch.VelocityZ[Index]);
+			const VectorRegister4Float AccelDirX = VectorLoad(&Batch.AccelDirX[Index]);
+			const VectorRegister4Float AccelDirY = VectorLoad(&Batch.AccelDirY[Index]);
+
+			// Keep the character's speed and turn it towards the acceleration, characters without any input keep their velocity
+			const VectorRegister4Float Speed = VectorSqrt(VectorMultiplyAdd(VelocityX, VelocityX, VectorMultiply(VelocityY, VelocityY)));
+			const VectorRegister4Float Tolerance = VectorSetFloat1(UE_KINDA_SMALL_NUMBER);
+			const VectorRegister4Float NoInput = VectorBitwiseAnd(VectorCompareLE(VectorAbs(AccelDirX), Tolerance), VectorCompareLE(VectorAbs(AccelDirY), Tolerance));
+			VectorRegister4Float LurchX = VectorSelect(NoInput, VelocityX, VectorMultiply(AccelDirX, Speed));
+			VectorRegister4Float LurchY = VectorSelect(NoInput, VelocityY, VectorMultiply(AccelDirY, Speed));
+			VectorRegister4Float LurchZ = VectorSelect(NoInput, VelocityZ, VectorZeroFloat());
+
+			// Friction based on how much the velocity changed
+			const VectorRegister4Float LurchFriction = VectorMultiply(VectorSetFloat1(Friction * 10), VectorLoad(&Batch.DeltaTime[Index]));
+			LurchX = VectorMultiplyAdd(VectorSubtract(VelocityX, LurchX), LurchFriction, LurchX);
+			LurchY = VectorMultiplyAdd(VectorSubtract(VelocityY, LurchY), LurchFriction, LurchY);
+			LurchZ = VectorMultiplyAdd(VectorSubtract(VelocityZ, LurchZ), LurchFriction, LurchZ);
+
+			// Blend from the air strafe velocity to the lurch velocity
+			const VectorRegister4Float Strength = VectorLoad(&Batch.LurchStrength[Index]);
+			const VectorRegister4Float AirStrafeStrength = VectorSubtract(VectorOneFloat(), Strength);
+			VectorStore(VectorMultiplyAdd(VectorAdd(VelocityX, AddedX), AirStrafeStrength, VectorMultiply(LurchX, Strength)), &Batch.VelocityX[Index]);
+			VectorStore(VectorMultiplyAdd(VectorAdd(VelocityY, AddedY), AirStrafeStrength, VectorMultiply(LurchY, Strength)), &Batch.VelocityY[Index]);
+			VectorStore(VectorMultiplyAdd(VectorAdd(VelocityZ, AddedZ), AirStrafeStrength, VectorMultiply(LurchZ, Strength)), &Batch.VelocityZ[Index]);
+		}
+	}
+}
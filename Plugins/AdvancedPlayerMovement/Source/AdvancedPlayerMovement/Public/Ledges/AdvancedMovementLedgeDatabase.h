@@ -0,0 +1,133 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "Engine/EngineTypes.h"
+#include "AdvancedMovementLedgeDatabase.generated.h"
+
+
+/** A ledge that was found while baking a level, with the values that the wall and ledge traces of CheckIfSafeToMantleLedge would find for it */
+USTRUCT()
+struct FAdvancedMovementBakedLedge
+{
+	GENERATED_BODY()
+
+	/** A point on the wall below the ledge (the wall trace's hit location) */
+	UPROPERTY() FVector WallLocation = FVector::ZeroVector;
+
+	/** The wall's normal */
+	UPROPERTY() FVector WallNormal = FVector::ZeroVector;
+
+	/** The surface of the ledge (the ledge trace's hit location) */
+	UPROPERTY() FVector LedgeLocation = FVector::ZeroVector;
+};
+
+
+/** The character and mantle settings a ledge database was baked with. The database is only used by characters with the same settings */
+USTRUCT()
+struct FAdvancedMovementLedgeBakeSettings
+{
+	GENERATED_BODY()
+
+	UPROPERTY() float CapsuleRadius = 0;
+	UPROPERTY() float CapsuleHalfHeight = 0;
+	UPROPERTY() float CrouchedHalfHeight = 0;
+	UPROPERTY() float MantleTraceHeightOffset = 0;
+	UPROPERTY() float MantleSurfaceTraceFromLedgeOffset = 0;
+	UPROPERTY() float MantleSecondTraceDistance = 0;
+	UPROPERTY() TArray<TEnumAsByte<EObjectTypeQuery>> MantleObjects;
+
+	/** Returns true if ledges baked with either settings are the same */
+	bool Equals(const FAdvancedMovementLedgeBakeSettings& Other) const;
+
+	/** Returns true if the character's dimensions and the mantle trace settings are the same */
+	bool EqualsIgnoringMantleObjects(const FAdvancedMovementLedgeBakeSettings& Other) const;
+};
+
+
+/** A cell of the ledge database's spatial hash, which references a range of the (sorted) ledges */
+USTRUCT()
+struct FAdvancedMovementLedgeCell
+{
+	GENERATED_BODY()
+
+	UPROPERTY() FIntVector Cell = FIntVector::ZeroValue;
+	UPROPERTY() int32 First = 0;
+	UPROPERTY() int32 Num = 0;
+};
+
+
+/**
+ * Every mantleable ledge of a level, baked offline by the AdvancedMovementLedgeBake commandlet against the level's static geometry.
+ * The database is saved next to the map (/Game/Maps/Demo_Ledges for /Game/Maps/Demo) and loaded by the UAdvancedMovementLedgeSubsystem,
+ * and the movement component looks up ledges from it instead of running the mantle traces.
+ */
+UCLASS()
+class UAdvancedMovementLedgeDatabase : public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	/** The suffix of the ledge database's asset name */
+	static const TCHAR* GetAssetSuffix() { return TEXT("_Ledges"); }
+
+	/** Returns the object path of a map's ledge database */
+	static FString GetDatabasePath(const FString& MapPackageName);
+
+	/**
+	 * Stores the baked ledges and builds the spatial hash
+	 *
+	 * @param InLedges			The ledges that were found
+	 * @param InSettings		The settings the ledges were baked with
+	 * @param InCellSize		The size of the spatial hash's cells
+	 * @param InSpacing			The distance between the samples that found the ledges
+	 */
+	void Build(TArray<FAdvancedMovementBakedLedge>&& InLedges, const FAdvancedMovementLedgeBakeSettings& InSettings, float InCellSize, float InSpacing);
+
+	/**
+	 * Finds the ledge that the mantle traces would find from a wall trace
+	 *
+	 * @param TraceStart		The start of the wall trace
+	 * @param TraceEnd			The end of the wall trace
+	 * @param OutWallDistance	How far along the wall trace the ledge's wall is
+	 * @returns					The closest ledge in front of the trace, or nullptr if there isn't one
+	 */
+	const FAdvancedMovementBakedLedge* FindLedge(const FVector& TraceStart, const FVector& TraceEnd, float& OutWallDistance) const;
+
+	/** Returns the settings the ledges were baked with */
+	const FAdvancedMovementLedgeBakeSettings& GetSettings() const { return Settings; }
+
+	/** Returns every baked ledge */
+	const TArray<FAdvancedMovementBakedLedge>& GetLedges() const { return Ledges; }
+
+	virtual void PostLoad() override;
+
+
+protected:
+	/** Builds the cell lookup from the serialized cells */
+	void BuildCellLookup();
+
+	/** Returns the spatial hash cell of a location */
+	FIntVector GetCell(const FVector& Location) const;
+
+	/** The baked ledges, sorted by their cell */
+	UPROPERTY() TArray<FAdvancedMovementBakedLedge> Ledges;
+
+	/** The spatial hash's cells */
+	UPROPERTY() TArray<FAdvancedMovementLedgeCell> Cells;
+
+	/** The settings the ledges were baked with */
+	UPROPERTY() FAdvancedMovementLedgeBakeSettings Settings;
+
+	/** The size of the spatial hash's cells */
+	UPROPERTY() float CellSize = 100;
+
+	/** The distance between the samples that found the ledges, which is how far a wall trace is allowed to be from a baked ledge */
+	UPROPERTY() float Spacing = 25;
+
+	/** The index of each cell in Cells */
+	TMap<FIntVector, int32> CellLookup;
+
+};
@@ -0,0 +1,37 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "AdvancedMovementLedgeSubsystem.generated.h"
+
+class UAdvancedMovementLedgeDatabase;
+
+
+/**
+ * Loads the current level's baked ledge database (see UAdvancedMovementLedgeDatabase) when play begins.
+ * Levels without a database use the regular mantle traces.
+ */
+UCLASS()
+class UAdvancedMovementLedgeSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+
+	/** Returns the level's ledge database, or nullptr if it hasn't been baked */
+	UAdvancedMovementLedgeDatabase* GetDatabase() const { return Database; }
+
+	/** Overrides the level's ledge database. Baking clears it so the ledges are found with the mantle traces */
+	void SetDatabase(UAdvancedMovementLedgeDatabase* InDatabase) { Database = InDatabase; }
+
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	/** The level's ledge database */
+	UPROPERTY(Transient) UAdvancedMovementLedgeDatabase* Database;
+
+};
@@ -0,0 +1,83 @@
+#pragma once
+
+
+#include "CoreMinimal.h"
+#include "Templates/SubclassOf.h"
+
+class ABhopCharacter;
+class UWorld;
+struct FAdvancedMovementInputRecording;
+
+
+/** The outcome of replaying a recording */
+struct FAdvancedMovementReplayResult
+{
+	/** The character's location after every FAdvancedMovementInputRecording::TrajectoryInterval frames */
+	TArray<FVector> Trajectory;
+
+	/** The character's state once the replay finished */
+	FVector EndLocation = FVector::ZeroVector;
+	FVector EndVelocity = FVector::ZeroVector;
+
+	/** The movement cost of every frame in microseconds (sorted once the replay finishes) */
+	TArray<double> TickUs;
+
+	/** The average movement cost of a frame in microseconds */
+	double MeanTickUs = 0;
+
+	/** How many wall jumps happened during the replay */
+	int32 WallJumps = 0;
+
+	/** How many times the physics functions were called (this includes every physics iteration) */
+	uint64 PhysicsCalls = 0;
+
+	/** The heap allocations inside the movement tick after the warm up frames, and their size (only counted if the allocation counter is installed) */
+	uint64 Allocations = 0;
+	uint64 AllocatedBytes = 0;
+};
+
+
+/** Helpers for running characters in a standalone game world without a viewport (for commandlets and -nullrhi runs) */
+namespace AdvancedMovementBenchmark
+{
+	/** Loads a map into a new game world context and begins play. Returns nullptr if the map couldn't be loaded */
+	ADVANCEDPLAYERMOVEMENT_API UWorld* CreateWorld(const FString& MapName);
+
+	/** Tears down a world that was created with CreateWorld */
+	ADVANCEDPLAYERMOVEMENT_API void DestroyWorld(UWorld* World);
+
+	/**
+	 * Spawns characters in a grid around the map's player start. The characters don't have a controller, so their movement is set to run without one.
+	 *
+	 * @param World				The world to spawn the characters in
+	 * @param Count				How many characters to spawn
+	 * @param CharacterClass	The character class (defaults to ABhopCharacter)
+	 * @param Spacing			The distance between characters in the grid
+	 */
+	ADVANCEDPLAYERMOVEMENT_API TArray<ABhopCharacter*> SpawnCharacters(UWorld* World, int32 Count, TSubclassOf<ABhopCharacter> CharacterClass = nullptr, float Spacing = 200);
+
+	/** Spawns a single character without a controller at a specific location */
+	ADVANCEDPLAYERMOVEMENT_API ABhopCharacter* SpawnCharacter(UWorld* World, const FVector& Location, const FRotator& Rotation, TSubclassOf<ABhopCharacter> CharacterClass = nullptr);
+
+	/** Advances the world by a single frame */
+	ADVANCEDPLAYERMOVEMENT_API void TickWorld(UWorld* World, float DeltaTime);
+
+	/**
+	 * Spawns a character at the recording's start state and replays every recorded frame
+	 *
+	 * @param Recording					The recording to replay
+	 * @param World						The world to replay the recording in
+	 * @param CharacterClass			The character that's replaying the inputs
+	 * @param OutResult					The trajectory, end state, and cost of the replay
+	 * @param AllocationWarmupFrames	The frames that are replayed before the movement tick's allocations are counted, or INDEX_NONE if they aren't counted
+	 * @returns							False if the character couldn't be spawned
+	 */
+	ADVANCEDPLAYERMOVEMENT_API bool ReplayRecording(const FAdvancedMovementInputRecording& Recording, UWorld* World, TSubclassOf<ABhopCharacter> CharacterClass,
+		FAdvancedMovementReplayResult& OutResult, int32 AllocationWarmupFrames = INDEX_NONE);
+
+	/** Returns the largest distance between two trajectories */
+	ADVANCEDPLAYERMOVEMENT_API double GetTrajectoryDeviation(const TArray<FVector>& Baseline, const TArray<FVector>& Trajectory);
+
+	/** Returns the value at a percentile (0-1) of a sorted array */
+	ADVANCEDPLAYERMOVEMENT_API double GetPercentile(const TArray<double>& SortedSamples, double Percentile);
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+
+#include "CoreMinimal.h"
+
+class ACharacter;
+class UAdvancedMovementComponent;
+
+
+/** The buttons the advanced movement component reads during a tick */
+enum class EAdvancedMovementInputButtons : uint8
+{
+	None			= 0,
+	Jump			= 1 << 0,
+	Crouch			= 1 << 1,
+	WallJump		= 1 << 2,
+	Sprint			= 1 << 3,
+	Aim				= 1 << 4,
+	Mantle			= 1 << 5,
+};
+ENUM_CLASS_FLAGS(EAdvancedMovementInputButtons);
+
+
+/** The inputs the advanced movement component consumes during a single tick */
+struct ADVANCEDPLAYERMOVEMENT_API FAdvancedMovementInputFrame
+{
+	/** The delta time of the tick */
+	float DeltaTime = 0;
+
+	/** The player's input (X is forward, Y is right) */
+	FVector2D Input = FVector2D::ZeroVector;
+
+	/** The character's yaw (the player's camera) */
+	float Yaw = 0;
+
+	/** The buttons that are held during this tick */
+	EAdvancedMovementInputButtons Buttons = EAdvancedMovementInputButtons::None;
+
+	bool IsPressed(const EAdvancedMovementInputButtons Button) const { return EnumHasAnyFlags(Buttons, Button); }
+};
+
+
+namespace AdvancedMovementInput
+{
+	/**
+	 * Scripted bhop input that's used for driving characters without a player. It strafes back and forth while turning into the strafe,
+	 * periodically lands and slides, and taps wall jump so that most of the movement modes get used.
+	 *
+	 * @param Seed				Offsets the script so multiple characters don't move in lockstep
+	 * @param Time				The time since the script started
+	 * @param DeltaTime			The tick's delta time
+	 */
+	ADVANCEDPLAYERMOVEMENT_API FAdvancedMovementInputFrame EvaluateStrafeScript(int32 Seed, float Time, float DeltaTime);
+
+	/** Applies an input frame to the character and its movement component, this should be done before the character's movement ticks */
+	ADVANCEDPLAYERMOVEMENT_API void ApplyInputFrame(ACharacter* Character, UAdvancedMovementComponent* MovementComponent, const FAdvancedMovementInputFrame& Frame);
+}
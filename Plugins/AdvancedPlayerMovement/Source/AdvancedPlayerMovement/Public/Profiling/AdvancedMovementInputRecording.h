@@ -0,0 +1,76 @@
+#pragma once
+
+
+#include "CoreMinimal.h"
+#include "Profiling/AdvancedMovementInput.h"
+
+
+/**
+ * A recorded movement session: the state the character started in, the inputs the movement component consumed every tick, and the resulting trajectory.
+ * The trajectory is the baseline that replays are compared against, and it's captured either while recording or by rebaselining a replay.
+ *
+ * Saved as a compact binary file, each frame is 11 bytes (the inputs are quantized to a byte per axis).
+ */
+struct ADVANCEDPLAYERMOVEMENT_API FAdvancedMovementInputRecording
+{
+	/** The file identifier and version */
+	static constexpr uint32 FileMagic = 0x524D4441; // "ADMR"
+	static constexpr uint32 FileVersion = 1;
+
+	/** The default file extension for recordings */
+	static const TCHAR* GetFileExtension() { return TEXT(".amrec"); }
+
+	/** The frame interval of the trajectory samples */
+	static constexpr int32 TrajectoryInterval = 10;
+
+	/** The map the session was recorded on */
+	FString MapName;
+
+	/** The character class that was recorded */
+	FString CharacterClassPath;
+
+	/** The character's state at the start of the recording */
+	FVector StartLocation = FVector::ZeroVector;
+	FRotator StartRotation = FRotator::ZeroRotator;
+	FVector StartVelocity = FVector::ZeroVector;
+	uint8 StartMovementMode = 0;
+	uint8 StartCustomMovementMode = 0;
+
+	/** The character's state at the end of the recording */
+	FVector EndLocation = FVector::ZeroVector;
+	FVector EndVelocity = FVector::ZeroVector;
+
+	/** The average movement cost of a tick in microseconds when the baseline was captured (zero if it wasn't measured) */
+	float BaselineTickUs = 0;
+
+	/** The inputs of every tick */
+	TArray<FAdvancedMovementInputFrame> Frames;
+
+	/** The character's location after every TrajectoryInterval frames */
+	TArray<FVector> Trajectory;
+
+	/** Adds the character's location to the trajectory if this frame is sampled */
+	void AddTrajectorySample(const int32 Frame, const FVector& Location)
+	{
+		if ((Frame + 1) % TrajectoryInterval == 0) Trajectory.Add(Location);
+	}
+
+	/** Returns the total duration of the recording */
+	float GetDuration() const;
+
+	/**
+	 * Returns the recorded inputs resampled to a fixed frame rate, for replaying the same session at different frame rates.
+	 * Movement input is held from the recorded frame, the yaw is interpolated between recorded frames so turning stays smooth,
+	 * and buttons are held for every frame that overlaps a recorded press so taps aren't dropped at lower frame rates.
+	 */
+	TArray<FAdvancedMovementInputFrame> Resample(float FrameRate) const;
+
+	/** Serializes the recording to or from an archive. Returns false if the data isn't a valid recording */
+	bool Serialize(FArchive& Ar);
+
+	/** Saves the recording to a file */
+	bool SaveToFile(const FString& FilePath);
+
+	/** Loads a recording from a file */
+	bool LoadFromFile(const FString& FilePath);
+};
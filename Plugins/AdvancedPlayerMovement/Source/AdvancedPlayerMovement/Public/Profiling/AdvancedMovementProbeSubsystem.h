@@ -0,0 +1,96 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "CollisionQueryParams.h"
+#include "CollisionShape.h"
+#include "Engine/HitResult.h"
+#include "AdvancedMovementProbeSubsystem.generated.h"
+
+
+/** A probe that was requested from the UAdvancedMovementProbeSubsystem */
+struct FAdvancedMovementProbeHandle
+{
+	/** The probe's index in its batch */
+	int32 Index = INDEX_NONE;
+
+	/** The batch the probe was requested for */
+	uint32 Batch = 0;
+
+	bool IsValid() const { return Index != INDEX_NONE; }
+	void Invalidate() { Index = INDEX_NONE; }
+};
+
+
+/** A scene query that's run in the probe batch, and its result */
+struct FAdvancedMovementProbe
+{
+	/** The query */
+	FVector Start = FVector::ZeroVector;
+	FVector End = FVector::ZeroVector;
+	FQuat Rotation = FQuat::Identity;
+	FCollisionShape Shape;
+	ECollisionChannel Channel = ECC_Visibility;
+	FCollisionObjectQueryParams ObjectParams;
+	FCollisionQueryParams QueryParams;
+	FCollisionResponseParams ResponseParams;
+
+	/** Line traces and sweeps by object type use the object params instead of the channel, and overlaps only test the start location */
+	bool bByObjectType = false;
+	bool bOverlap = false;
+
+	/** Whether the probe hit something, and the hit for traces and sweeps */
+	bool bBlockingHit = false;
+	FHitResult Hit;
+};
+
+
+/**
+ * Collects the look ahead probes (the wall jump and mantle queries each character is predicted to need during its next movement tick)
+ * from every movement component in the world, and runs all of them at the end of the frame in a single parallel batch under a scene read lock.
+ * The results are available to the movement components until the next batch runs.
+ */
+UCLASS()
+class UAdvancedMovementProbeSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	/** Adds a line trace against a trace channel to the next batch */
+	FAdvancedMovementProbeHandle AddLineTraceByChannel(const FVector& Start, const FVector& End, ECollisionChannel Channel, const FCollisionQueryParams& QueryParams);
+
+	/** Adds a line trace against object types to the next batch */
+	FAdvancedMovementProbeHandle AddLineTraceByObjectType(const FVector& Start, const FVector& End, const FCollisionObjectQueryParams& ObjectParams, const FCollisionQueryParams& QueryParams);
+
+	/** Adds a blocking overlap test to the next batch */
+	FAdvancedMovementProbeHandle AddOverlapByChannel(const FVector& Location, const FQuat& Rotation, ECollisionChannel Channel, const FCollisionShape& Shape, const FCollisionQueryParams& QueryParams, const FCollisionResponseParams& ResponseParams);
+
+	/** Returns the probe's result, or nullptr if the probe's batch hasn't run yet (or a newer batch has replaced it) */
+	const FAdvancedMovementProbe* GetResult(const FAdvancedMovementProbeHandle& Handle) const;
+
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	/** Adds a probe to the next batch */
+	FAdvancedMovementProbeHandle AddProbe(FAdvancedMovementProbe&& Probe);
+
+	/** Runs a single probe (this happens on worker threads) */
+	void RunProbe(FAdvancedMovementProbe& Probe) const;
+
+	/** The probes for the next batch */
+	TArray<FAdvancedMovementProbe> PendingProbes;
+
+	/** The probes of the batch that's already been run */
+	TArray<FAdvancedMovementProbe> CompletedProbes;
+
+	/** The next batch, and the batch that's already been run */
+	uint32 PendingBatch = 1;
+	uint32 CompletedBatch = 0;
+
+};
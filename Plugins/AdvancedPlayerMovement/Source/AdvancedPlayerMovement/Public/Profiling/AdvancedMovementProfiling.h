@@ -0,0 +1,291 @@
+#pragma once
+
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+#include "Trace/Trace.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+
+
+/** The stats for the advanced movement component (stat AdvancedMovement) */
+DECLARE_STATS_GROUP(TEXT("AdvancedMovement"), STATGROUP_AdvancedMovement, STATCAT_Advanced);
+
+/** The Unreal Insights trace channel for the advanced movement component (-trace=cpu,AdvancedMovement) */
+UE_TRACE_CHANNEL_EXTERN(AdvancedMovementChannel, ADVANCEDPLAYERMOVEMENT_API);
+
+/**
+ * Adds a scoped cycle counter (STAT_AdvancedMovement_<Name>) and a matching cpu trace event on the advanced movement trace channel.
+ * The cycle stat needs to be declared with DECLARE_CYCLE_STAT in the file that uses it.
+ */
+#define ADVANCED_MOVEMENT_SCOPE_CYCLE_COUNTER(Name) \
+	SCOPE_CYCLE_COUNTER(STAT_AdvancedMovement_##Name); \
+	TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL_STR("AdvancedMovement::" #Name, AdvancedMovementChannel)
+
+
+/** The physics functions of the advanced movement component that are profiled separately */
+enum class EAdvancedMovementPhysics : uint8
+{
+	Walking,
+	Slide,
+	Falling,
+	WallRunning,
+	WallClimbing,
+	Mantling,
+	LedgeClimbing,
+	Other,
+	MAX
+};
+
+
+/**
+ * Exclusive per physics function timings of every advanced movement component in the process.
+ * These are only captured while enabled (the benchmark commandlet enables them), and movement only runs on the game thread so this isn't synchronized.
+ */
+struct ADVANCEDPLAYERMOVEMENT_API FAdvancedMovementPhysicsTimings
+{
+	/** Whether the physics functions should be timed */
+	static bool bEnabled;
+
+	/** The accumulated cycles for each physics function since the last reset */
+	static uint64 Cycles[static_cast<uint8>(EAdvancedMovementPhysics::MAX)];
+
+	/** How many times each physics function was invoked since the last reset */
+	static uint32 Calls[static_cast<uint8>(EAdvancedMovementPhysics::MAX)];
+
+	/** The physics function that's currently being timed (MAX when nothing is), nested functions pause their parent to keep the timings exclusive */
+	static EAdvancedMovementPhysics Current;
+
+	/** When the current physics function started (or resumed) */
+	static uint64 StartCycles;
+
+	/** Clears the accumulated timings */
+	static void Reset();
+
+	/** Returns the display name of a physics function */
+	static const TCHAR* GetName(EAdvancedMovementPhysics Physics);
+};
+
+
+/** Times a physics function exclusively (nested physics functions aren't included in the parent's time) */
+struct FScopedAdvancedMovementPhysicsTimer
+{
+	explicit FScopedAdvancedMovementPhysicsTimer(const EAdvancedMovementPhysics Physics) :
+		bActive(FAdvancedMovementPhysicsTimings::bEnabled),
+		Previous(FAdvancedMovementPhysicsTimings::Current)
+	{
+		if (!bActive) return;
+
+		const uint64 Now = FPlatformTime::Cycles64();
+		if (Previous != EAdvancedMovementPhysics::MAX)
+		{
+			FAdvancedMovementPhysicsTimings::Cycles[static_cast<uint8>(Previous)] += Now - FAdvancedMovementPhysicsTimings::StartCycles;
+		}
+		FAdvancedMovementPhysicsTimings::Calls[static_cast<uint8>(Physics)]++;
+		FAdvancedMovementPhysicsTimings::Current = Physics;
+		FAdvancedMovementPhysicsTimings::StartCycles = Now;
+	}
+
+	~FScopedAdvancedMovementPhysicsTimer()
+	{
+		if (!bActive) return;
+
+		const uint64 Now = FPlatformTime::Cycles64();
+		FAdvancedMovementPhysicsTimings::Cycles[static_cast<uint8>(FAdvancedMovementPhysicsTimings::Current)] += Now - FAdvancedMovementPhysicsTimings::StartCycles;
+		FAdvancedMovementPhysicsTimings::Current = Previous;
+		FAdvancedMovementPhysicsTimings::StartCycles = Now;
+	}
+
+private:
+	const bool bActive;
+	const EAdvancedMovementPhysics Previous;
+};
+
+
+#define ADVANCED_MOVEMENT_PHYSICS_TIMER(Physics) FScopedAdvancedMovementPhysicsTimer AdvancedMovementPhysicsTimer(EAdvancedMovementPhysics::Physics)
+
+
+
+
+/**
+ * Counts the heap allocations the game thread makes inside the movement tick (see FScopedAdvancedMovementAllocationCheck), since the movement tick
+ * should be allocation free once it's warmed up. This wraps GMalloc while it's installed, which the AdvancedMovement.Allocations automation test and the replay commandlet's -AllocationCheck do.
+ */
+struct ADVANCEDPLAYERMOVEMENT_API FAdvancedMovementAllocations
+{
+	/** How many allocation callstacks are captured, and how many frames each of them has */
+	static constexpr int32 MaxCallstacks = 8;
+	static constexpr int32 CallstackDepth = 32;
+
+	/** Whether allocations inside the movement tick should be counted */
+	static bool bEnabled;
+
+	/** How many movement tick scopes the game thread is in */
+	static int32 ScopeDepth;
+
+	/** The allocations (and reallocations) inside the movement tick since the last reset, and their size */
+	static uint64 Allocations;
+	static uint64 Bytes;
+
+	/** The program counters of the first allocations since the last reset */
+	static uint64 Callstacks[MaxCallstacks][CallstackDepth];
+	static int32 CallstackDepths[MaxCallstacks];
+	static int32 NumCallstacks;
+
+	/** Wraps GMalloc with the allocation counter. The counter is never removed from memory, since other threads could still be inside of it once it's uninstalled */
+	static void Install();
+
+	/** Restores the original GMalloc */
+	static void Uninstall();
+
+	/** Clears the counted allocations */
+	static void Reset();
+
+	/** Returns one of the captured callstacks, one frame per line */
+	static FString GetCallstack(int32 Index);
+};
+
+
+/** Marks the movement tick for the allocation counter */
+struct FScopedAdvancedMovementAllocationCheck
+{
+	FScopedAdvancedMovementAllocationCheck() :
+		bActive(FAdvancedMovementAllocations::bEnabled && IsInGameThread())
+	{
+		if (bActive) FAdvancedMovementAllocations::ScopeDepth++;
+	}
+
+	~FScopedAdvancedMovementAllocationCheck()
+	{
+		if (bActive) FAdvancedMovementAllocations::ScopeDepth--;
+	}
+
+private:
+	const bool bActive;
+};
+
+
+
+
+/** The types of scene queries the advanced movement component issues */
+enum class EAdvancedMovementQuery : uint8
+{
+	LineTrace,
+	SphereTrace,
+	Sweep,
+	Overlap,
+	MAX
+};
+
+
+/**
+ * The movement features that issue scene queries. Queries are counted where they're issued, except for the character movement component's
+ * floor checks, where every ComputeFloorDist is counted as one sweep (it can also retry the sweep with a smaller capsule and add a line trace).
+ * Penetration resolution's overlap tests aren't counted.
+ */
+enum class EAdvancedMovementQuerySource : uint8
+{
+	WallJump,
+	Mantle,
+
+	/** The floor checks while wall climbing */
+	WallClimbFloor,
+
+	/** Every other floor check (walking, landing, step ups, and perching) */
+	Floor,
+
+	Crouch,
+	UnCrouch,
+
+	/** The sweeps that move the character (SafeMoveUpdatedComponent, MoveAlongFloor, StepUp, SlideAlongSurface) */
+	Move,
+	MAX
+};
+
+
+/** Scene query counts of a movement component, broken down by the movement mode and the feature that issued them */
+struct ADVANCEDPLAYERMOVEMENT_API FAdvancedMovementSceneQueryStats
+{
+	/** The queries issued during each movement mode */
+	uint32 ByMode[static_cast<uint8>(EAdvancedMovementPhysics::MAX)][static_cast<uint8>(EAdvancedMovementQuery::MAX)] = {};
+
+	/** The queries issued by each movement feature */
+	uint32 BySource[static_cast<uint8>(EAdvancedMovementQuerySource::MAX)][static_cast<uint8>(EAdvancedMovementQuery::MAX)] = {};
+
+	/** Adds a scene query */
+	void Add(const EAdvancedMovementPhysics Mode, const EAdvancedMovementQuerySource Source, const EAdvancedMovementQuery Query, const uint32 Count = 1)
+	{
+		ByMode[static_cast<uint8>(Mode)][static_cast<uint8>(Query)] += Count;
+		BySource[static_cast<uint8>(Source)][static_cast<uint8>(Query)] += Count;
+	}
+
+	/** Adds the queries of another set of stats */
+	void Append(const FAdvancedMovementSceneQueryStats& Other);
+
+	/** Clears the stats */
+	void Reset();
+
+	/** Returns the total amount of queries */
+	uint32 GetTotal() const;
+
+	/** Returns the amount of queries of a specific type */
+	uint32 GetQueryTotal(EAdvancedMovementQuery Query) const;
+
+	/** Returns the amount of queries that were issued during a movement mode */
+	uint32 GetModeTotal(EAdvancedMovementPhysics Mode) const;
+
+	/** Returns the amount of queries that were issued by a movement feature */
+	uint32 GetSourceTotal(EAdvancedMovementQuerySource Source) const;
+
+	/** Returns the display name of a query type */
+	static const TCHAR* GetQueryName(EAdvancedMovementQuery Query);
+
+	/** Returns the display name of a movement feature */
+	static const TCHAR* GetSourceName(EAdvancedMovementQuerySource Source);
+};
+
+
+
+
+/** Network prediction telemetry of a movement component, corrections are broken down by the movement mode they happened in */
+struct ADVANCEDPLAYERMOVEMENT_API FAdvancedMovementNetworkStats
+{
+	/** Corrections the server sent to the client (captured on the server) */
+	uint32 ServerCorrections[static_cast<uint8>(EAdvancedMovementPhysics::MAX)] = {};
+
+	/** Corrections the client received from the server (captured on the client) */
+	uint32 ClientCorrections[static_cast<uint8>(EAdvancedMovementPhysics::MAX)] = {};
+
+	/** The saved moves the client replayed after corrections */
+	uint32 ReplayedMoves = 0;
+
+	/** The time spent replaying saved moves */
+	uint64 ReplayCycles = 0;
+
+	/** The moves the client serialized for the server */
+	uint32 SentMoves = 0;
+
+	/** The packed bits of every server move rpc the client sent (upstream) */
+	uint64 ServerMoveBits = 0;
+
+	/** How many of the upstream bits are the custom move data */
+	uint64 CustomMoveDataBits = 0;
+
+	/** The move responses the server sent to the client, and their packed bits (downstream) */
+	uint32 MoveResponses = 0;
+	uint64 MoveResponseBits = 0;
+
+	/** The packed bits of the move responses that were corrections instead of acknowledgements */
+	uint64 CorrectionBits = 0;
+
+	/** Clears the stats */
+	void Reset();
+
+	/** Returns the total amount of server corrections */
+	uint32 GetServerCorrections() const;
+
+	/** Returns the total amount of client corrections */
+	uint32 GetClientCorrections() const;
+
+	/** Returns a summary of the corrections for each movement mode, ie "PhysWalking: 2, PhysWallRunning: 14" */
+	static FString GetCorrectionBreakdown(const uint32 (&Corrections)[static_cast<uint8>(EAdvancedMovementPhysics::MAX)]);
+};
@@ -0,0 +1,137 @@
+#pragma once
+
+
+#include "CoreMinimal.h"
+
+
+/** The velocity branch the movement component took during a substep */
+enum class EAdvancedMovementTraceBranch : uint8
+{
+	/** The character movement component's velocity calculations */
+	Default,
+
+	/** Sideways strafing while sliding */
+	SlideStrafe,
+
+	/** Air strafing (bhopping) */
+	AirStrafe,
+
+	/** Air strafe sway (after wall jumps and ledge jumps) */
+	StrafeSway,
+
+	/** Air strafe lurch (after mantle jumps and ledge jumps) */
+	StrafeLurch,
+
+	MAX
+};
+
+
+/**
+ * The movement component's state after a physics substep. This is plain data so that tracing a substep is a single copy into the ring buffer,
+ * and the trace file stores the records as they're laid out in memory.
+ */
+struct FAdvancedMovementTraceRecord
+{
+	/** The component's time, and the substep's delta time */
+	float Time;
+	float DeltaTime;
+
+	/** The character's location, velocity, and acceleration after the substep */
+	FVector3f Location;
+	FVector3f Velocity;
+	FVector3f Acceleration;
+
+	/** The normal of the surface the character hit during the substep (zero if it didn't hit anything) */
+	FVector3f HitNormal;
+
+	/** The player's input (X is forward, Y is right) */
+	FVector2f PlayerInput;
+
+	/** How long the strafe sway, strafe lurch, wall climb, and wall run have been active (negative when they aren't) */
+	float StrafeSwayTime;
+	float StrafeLurchTime;
+	float WallClimbTime;
+	float WallRunTime;
+
+	/** The movement mode and custom movement mode */
+	uint8 MovementMode;
+	uint8 CustomMovementMode;
+
+	/** The velocity branch of the substep (EAdvancedMovementTraceBranch) */
+	uint8 Branch;
+
+	/** The physics iteration of the substep */
+	uint8 Iteration;
+
+	/** Whether the substep was part of the client replaying its saved moves after a correction, instead of a new move */
+	uint8 bReplayed;
+};
+
+
+/**
+ * A fixed size ring buffer of the movement component's substeps. Once it's full the oldest records are overwritten, so it always holds the
+ * most recent movement, and it's dumped to a file on demand or when the character is corrected (see UAdvancedMovementComponent::StartMovementTrace).
+ * The AdvancedMovementTraceConvert commandlet converts the files to csv or json.
+ */
+struct ADVANCEDPLAYERMOVEMENT_API FAdvancedMovementTrace
+{
+	/** The file identifier and version */
+	static constexpr uint32 FileMagic = 0x544D4441; // "ADMT"
+	static constexpr uint32 FileVersion = 2;
+
+	/** The default file extension for traces */
+	static const TCHAR* GetFileExtension() { return TEXT(".amtrace"); }
+
+	/** The character that was traced, and why the trace was saved */
+	FString CharacterName;
+	FString Reason;
+
+	explicit FAdvancedMovementTrace(const int32 Capacity = 0) { Reset(Capacity); }
+
+	/** Clears the trace and resizes the ring buffer */
+	void Reset(const int32 Capacity)
+	{
+		Records.SetNumUninitialized(FMath::Max(Capacity, 1));
+		Head = 0;
+		Count = 0;
+	}
+
+	/** Returns the record for the next substep, overwriting the oldest record once the buffer is full */
+	FAdvancedMovementTraceRecord& Add()
+	{
+		FAdvancedMovementTraceRecord& Record = Records[Head];
+		Head = Head + 1 < Records.Num() ? Head + 1 : 0;
+		Count = FMath::Min(Count + 1, Records.Num());
+		return Record;
+	}
+
+	/** Returns the amount of records in the trace */
+	int32 Num() const { return Count; }
+
+	/** Returns the records from oldest to newest */
+	TArray<FAdvancedMovementTraceRecord> GetRecords() const;
+
+	/** Saves the trace to a file (the records are stored from oldest to newest) */
+	bool SaveToFile(const FString& FilePath) const;
+
+	/** Loads a trace from a file. Returns false if the file isn't a valid trace */
+	bool LoadFromFile(const FString& FilePath);
+
+	/** Returns the trace as csv, one row per record */
+	FString ToCsv() const;
+
+	/** Returns the trace as json, with the character and reason and an array of records */
+	FString ToJson() const;
+
+	/** Returns the display name of a velocity branch */
+	static const TCHAR* GetBranchName(EAdvancedMovementTraceBranch Branch);
+
+
+protected:
+	/** The ring buffer */
+	TArray<FAdvancedMovementTraceRecord> Records;
+
+	/** The index of the next record, and the amount of records that have been written */
+	int32 Head = 0;
+	int32 Count = 0;
+};
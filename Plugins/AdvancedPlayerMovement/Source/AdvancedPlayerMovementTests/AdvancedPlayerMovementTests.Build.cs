@@ -0,0 +1,22 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+using System.IO;
+using UnrealBuildTool;
+
+public class AdvancedPlayerMovementTests : TestModuleRules
+{
+	public AdvancedPlayerMovementTests(ReadOnlyTargetRules Target) : base(Target)
+	{
+		PCHUsage = ModuleRules.PCHUsageMode.UseExplicitOrSharedPCHs;
+
+		PrivateDependencyModuleNames.AddRange(
+			new string[]
+			{
+				"Core"
+			}
+			);
+
+		// The movement math is header only and only depends on Core, so the tests include it directly instead of linking the runtime module (and the engine)
+		PrivateIncludePaths.Add(Path.Combine(ModuleDirectory, "..", "AdvancedPlayerMovement", "Public"));
+	}
+}
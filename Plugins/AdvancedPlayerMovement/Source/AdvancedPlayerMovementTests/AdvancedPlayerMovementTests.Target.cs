@@ -0,0 +1,19 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+using UnrealBuildTool;
+
+/**
+ * Low level tests (Catch2) for the engine free movement math, these build into a standalone executable that doesn't load the engine or the editor:
+ *		RunUBT.sh AdvancedPlayerMovementTests Linux Development -Project=<Project>
+ *		Binaries/Linux/AdvancedPlayerMovementTests [--durations yes] ["[Benchmark]"]
+ */
+[SupportedPlatforms(UnrealPlatformClass.Desktop)]
+public class AdvancedPlayerMovementTestsTarget : TestTargetRules
+{
+	public AdvancedPlayerMovementTestsTarget(TargetInfo Target) : base(Target)
+	{
+		bCompileAgainstEngine = false;
+		bCompileAgainstCoreUObject = false;
+		bCompileAgainstApplicationCore = false;
+	}
+}
@@ -0,0 +1,101 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "AdvancedMovementMathSamples.h"
+#include "Core/AdvancedMovementMathBatch.h"
+
+
+/**
+ * Microbenchmarks for the engine free movement math. These are hidden, so they only run when they're asked for:
+ *		AdvancedPlayerMovementTests "[Benchmark]"
+ */
+namespace AdvancedMovementMathBenchmarks
+{
+	using namespace AdvancedMovementMathTests;
+
+	constexpr int32 Iterations = 1000000;
+
+	/** Times a calculation over the random samples and reports the time per call. The results are added to the sink so the calculation isn't optimized out */
+	template<typename FunctionType>
+	void Benchmark(const char* Function, const TArray<FSample>& Samples, FVector& Sink, FunctionType&& Calculation)
+	{
+		const uint64 StartCycles = FPlatformTime::Cycles64();
+		for (int32 Iteration = 0; Iteration < Iterations; Iteration++)
+		{
+			Sink += Calculation(Samples[Iteration & (SampleCount - 1)]);
+		}
+		const double TotalMs = FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - StartCycles);
+		WARN(Function << ": " << TotalMs * 1000000.0 / Iterations << "ns per call");
+	}
+
+	/** Times a batch kernel over the random samples and reports the time per character */
+	template<typename FunctionType>
+	void BenchmarkBatch(const char* Function, const TArray<FSample>& Samples, FVector& Sink, FunctionType&& Kernel)
+	{
+		AdvancedMovementMath::FStrafeBatch Batch;
+		Batch.SetNum(Samples.Num());
+
+		const int32 Runs = Iterations / SampleCount;
+		uint64 Cycles = 0;
+		for (int32 Run = 0; Run < Runs; Run++)
+		{
+			for (int32 Index = 0; Index < Samples.Num(); Index++)
+			{
+				const FSample& Sample = Samples[Index];
+				Batch.Set(Index, Sample.Velocity, Sample.AccelDir, Sample.Acceleration, Sample.DeltaTime,
+					AdvancedMovementMath::GetStrafeLurchStrength(Sample.Time, 0, LurchDuration, LurchFullStrengthDuration, 1));
+			}
+
+			const uint64 StartCycles = FPlatformTime::Cycles64();
+			Kernel(Batch);
+			Cycles += FPlatformTime::Cycles64() - StartCycles;
+			Sink += Batch.GetVelocity(Run & (SampleCount - 1));
+		}
+		WARN(Function << ": " << FPlatformTime::ToMilliseconds64(Cycles) * 1000000.0 / (static_cast<double>(Runs) * SampleCount) << "ns per character");
+	}
+}
+
+
+TEST_CASE("AdvancedMovement::Math::Benchmark", "[.][AdvancedMovement][Math][Benchmark]")
+{
+	using namespace AdvancedMovementMathBenchmarks;
+
+	FPlatformTime::InitTiming();
+	const TArray<FSample> Samples = MakeSamples();
+	FVector Sink = FVector::ZeroVector;
+
+	Benchmark("AirStrafe", Samples, Sink, [](const FSample& Sample)
+	{
+		return Sample.Velocity + AdvancedMovementMath::GetAirStrafeVelocity(Sample.Velocity, Sample.AccelDir, Sample.Acceleration, AirStrafe, Sample.DeltaTime);
+	});
+	Benchmark("StrafeSway", Samples, Sink, [](const FSample& Sample)
+	{
+		const FVector AddedVelocity = AdvancedMovementMath::GetAirStrafeVelocity(Sample.Velocity, Sample.AccelDir, Sample.Acceleration, StrafeSway, Sample.DeltaTime);
+		return AdvancedMovementMath::CanStrafeSway(Sample.Velocity, Sample.AccelDir) ? Sample.Velocity + AddedVelocity : Sample.Velocity;
+	});
+	Benchmark("StrafeLurch", Samples, Sink, [](const FSample& Sample)
+	{
+		const FVector AirStrafeVelocity = Sample.Velocity + AdvancedMovementMath::GetAirStrafeVelocity(Sample.Velocity, Sample.AccelDir, Sample.Acceleration, AirStrafe, Sample.DeltaTime);
+		const FVector LurchVelocity = AdvancedMovementMath::GetStrafeLurchVelocity(Sample.Velocity, Sample.AccelDir, LurchFriction, Sample.DeltaTime);
+		const float LurchStrength = AdvancedMovementMath::GetStrafeLurchStrength(Sample.Time, 0, LurchDuration, LurchFullStrengthDuration, 1);
+		return AdvancedMovementMath::BlendStrafeLurch(AirStrafeVelocity, LurchVelocity, LurchStrength);
+	});
+	Benchmark("WallJump", Samples, Sink, [](const FSample& Sample)
+	{
+		const FVector WallJump = AdvancedMovementMath::GetWallJumpDirection(FVector::ZeroVector, Sample.WallTrajectory * -1, Sample.WallNormal, Sample.WallNormal, Sample.Velocity);
+		FVector RedirectedVelocity;
+		return AdvancedMovementMath::GetWallJumpVelocity(WallJump, Sample.Velocity, 640, FVector2D(200, 400), RedirectedVelocity);
+	});
+	Benchmark("MantleAndClimbInterp", Samples, Sink, [](const FSample& Sample)
+	{
+		return AdvancedMovementMath::GetInterpStep(Sample.TargetLocation, Sample.Location, 200, 1, Sample.DeltaTime);
+	});
+
+	// The batch kernels, these are per character so they can be compared against the scalar calls
+	BenchmarkBatch("AirStrafeBatch", Samples, Sink, [](AdvancedMovementMath::FStrafeBatch& Batch) { AdvancedMovementMath::AirStrafeBatch(Batch, AirStrafe); });
+	BenchmarkBatch("StrafeSwayBatch", Samples, Sink, [](AdvancedMovementMath::FStrafeBatch& Batch) { AdvancedMovementMath::StrafeSwayBatch(Batch, StrafeSway); });
+	BenchmarkBatch("StrafeLurchBatch", Samples, Sink, [](AdvancedMovementMath::FStrafeBatch& Batch) { AdvancedMovementMath::StrafeLurchBatch(Batch, AirStrafe, LurchFriction); });
+
+	// Keeps the results alive
+	CHECK(!Sink.ContainsNaN());
+}
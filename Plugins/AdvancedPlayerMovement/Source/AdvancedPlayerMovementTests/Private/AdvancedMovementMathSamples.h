@@ -0,0 +1,81 @@
+#pragma once
+
+
+#include "CoreMinimal.h"
+#include "Core/AdvancedMovementMath.h"
+#include "TestHarness.h"
+
+
+/** The shared inputs and tuning for the movement math's tests and benchmarks */
+namespace AdvancedMovementMathTests
+{
+	constexpr float Tolerance = 0.01f;
+
+	/** The amount of random samples, this is a power of two so the benchmarks can wrap around them with a mask */
+	constexpr int32 SampleCount = 4096;
+
+	/** The component's default tuning (StrafingMaxAcceleration, AirStrafe/StrafeSway speed gain and rotation rates, StrafeLurch values) */
+	inline const AdvancedMovementMath::FAirStrafeParams AirStrafe((6400.f / 100) * 1.64f, 3, 1);
+	inline const AdvancedMovementMath::FAirStrafeParams StrafeSway((6400.f / 100) * 1, 3, 1);
+	constexpr float LurchDuration = 0.45;
+	constexpr float LurchFullStrengthDuration = 0.123;
+	constexpr float LurchFriction = 0.54;
+
+	/** Randomized inputs for the property tests and benchmarks */
+	struct FSample
+	{
+		FVector Velocity;
+		FVector AccelDir;
+		FVector Acceleration;
+		FVector WallNormal;
+		FVector WallTrajectory;
+		FVector Location;
+		FVector TargetLocation;
+		float DeltaTime;
+		float Time;
+
+		explicit FSample(FRandomStream& Random)
+		{
+			const float InputAngle = Random.FRandRange(0, 2 * PI);
+			const float WallAngle = Random.FRandRange(0, 2 * PI);
+			const float TrajectoryAngle = WallAngle + PI + Random.FRandRange(-0.49f * PI, 0.49f * PI); // Always heading into the wall
+			Velocity = FVector(Random.FRandRange(-2000, 2000), Random.FRandRange(-2000, 2000), Random.FRandRange(-1000, 1000));
+			AccelDir = FVector(FMath::Cos(InputAngle), FMath::Sin(InputAngle), 0);
+			Acceleration = AccelDir * Random.FRandRange(0, 6400);
+			WallNormal = FVector(FMath::Cos(WallAngle), FMath::Sin(WallAngle), 0);
+			WallTrajectory = FVector(FMath::Cos(TrajectoryAngle), FMath::Sin(TrajectoryAngle), 0) * Random.FRandRange(50, 1000);
+			Location = Random.VRand() * Random.FRandRange(1, 500);
+			TargetLocation = Location + Random.VRand() * Random.FRandRange(1, 500);
+			DeltaTime = Random.FRandRange(1.f / 240.f, 1.f / 30.f);
+			Time = Random.FRandRange(0, LurchDuration * 1.5f);
+		}
+	};
+
+	/** Returns the seeded random samples */
+	inline TArray<FSample> MakeSamples(const int32 Seed = 0)
+	{
+		FRandomStream Random(Seed);
+		TArray<FSample> Samples;
+		Samples.Reserve(SampleCount);
+		for (int32 Index = 0; Index < SampleCount; Index++)
+		{
+			Samples.Emplace(Random);
+		}
+		return Samples;
+	}
+
+	/** Runs a property check against the seeded random samples, and stops at the first failure so a broken property doesn't flood the output */
+	template<typename FunctionType>
+	void CheckProperty(const char* Property, FunctionType&& Check)
+	{
+		for (const FSample& Sample : MakeSamples())
+		{
+			if (!Check(Sample))
+			{
+				FAIL_CHECK(Property << " failed. Velocity: (" << TCHAR_TO_UTF8(*Sample.Velocity.ToString()) << "), AccelDir: (" << TCHAR_TO_UTF8(*Sample.AccelDir.ToString())
+					<< "), Acceleration: (" << TCHAR_TO_UTF8(*Sample.Acceleration.ToString()) << "), DeltaTime: " << Sample.DeltaTime);
+				return;
+			}
+		}
+	}
+}
@@ -0,0 +1,246 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "AdvancedMovementMathSamples.h"
+#include "Core/AdvancedMovementMathBatch.h"
+
+
+/**
+ * Unit and property tests for the engine free movement math (AdvancedMovementMath and AdvancedMovementMathBatch). These are low level tests, so they run
+ * without the engine on any desktop platform (including a Linux build machine without the editor), see AdvancedPlayerMovementTests.Target.cs
+ */
+using namespace AdvancedMovementMathTests;
+
+
+TEST_CASE("AdvancedMovement::Math::AirStrafe", "[AdvancedMovement][Math]")
+{
+	SECTION("Strafing sideways adds the rotation rate's share of the acceleration")
+	{
+		float ProjVelocity;
+		CHECK(AdvancedMovementMath::GetAirStrafeVelocity(FVector(600, 0, 0), FVector(0, 1, 0), FVector(0, 2048, 0), AirStrafe, 1.f / 60.f, ProjVelocity).Equals(FVector(0, 102.4, 0), Tolerance));
+		CHECK(FMath::IsNearlyEqual(ProjVelocity, 0.f, Tolerance));
+	}
+
+	SECTION("Longer ticks are clamped to the air speed cap")
+	{
+		CHECK(AdvancedMovementMath::GetAirStrafeVelocity(FVector(600, 0, 0), FVector(0, 1, 0), FVector(0, 2048, 0), AirStrafe, 1.f / 30.f).Equals(FVector(0, 104.96, 0), Tolerance));
+	}
+
+	SECTION("Strafing past the air speed cap doesn't add anything")
+	{
+		CHECK(AdvancedMovementMath::GetAirStrafeVelocity(FVector(0, 200, 0), FVector(0, 1, 0), FVector(0, 2048, 0), AirStrafe, 1.f / 60.f).Equals(FVector::ZeroVector, Tolerance));
+	}
+
+	SECTION("Strafe sway allows sideways strafes, and not strafing against the momentum")
+	{
+		CHECK(AdvancedMovementMath::CanStrafeSway(FVector(600, 0, 0), FVector(0, 1, 0)));
+		CHECK_FALSE(AdvancedMovementMath::CanStrafeSway(FVector(600, 0, 0), FVector(-1, 0, 0)));
+	}
+
+	SECTION("The properties hold for the random samples")
+	{
+		CheckProperty("The speed gained from a strafe tick is bounded by the air speed cap", [](const FSample& Sample)
+		{
+			for (const AdvancedMovementMath::FAirStrafeParams& Strafe : { AirStrafe, StrafeSway })
+			{
+				const FVector Strafed = Sample.Velocity + AdvancedMovementMath::GetAirStrafeVelocity(Sample.Velocity, Sample.AccelDir, Sample.Acceleration, Strafe, Sample.DeltaTime);
+				if (Strafed.Size2D() - Sample.Velocity.Size2D() > Strafe.AirSpeedCap + Tolerance) return false;
+			}
+			return true;
+		});
+
+		CheckProperty("Strafing doesn't push the velocity past the air speed cap", [](const FSample& Sample)
+		{
+			float ProjVelocity;
+			const FVector Strafed = Sample.Velocity + AdvancedMovementMath::GetAirStrafeVelocity(Sample.Velocity, Sample.AccelDir, Sample.Acceleration, AirStrafe, Sample.DeltaTime, ProjVelocity);
+			return Strafed.X * Sample.AccelDir.X + Strafed.Y * Sample.AccelDir.Y <= FMath::Max(ProjVelocity, AirStrafe.AirSpeedCap) + Tolerance;
+		});
+
+		CheckProperty("Strafing doesn't add vertical velocity", [](const FSample& Sample)
+		{
+			return AdvancedMovementMath::GetAirStrafeVelocity(Sample.Velocity, Sample.AccelDir, Sample.Acceleration, AirStrafe, Sample.DeltaTime).Z == 0;
+		});
+	}
+}
+
+
+TEST_CASE("AdvancedMovement::Math::StrafeLurch", "[AdvancedMovement][Math]")
+{
+	SECTION("A one second lurch is at full strength for the first quarter second, and then fades out over the remaining 0.75 seconds")
+	{
+		CHECK(FMath::IsNearlyEqual(AdvancedMovementMath::GetStrafeLurchStrength(0.1, 0, 1, 0.25, 1), 1.f, Tolerance));
+		CHECK(FMath::IsNearlyEqual(AdvancedMovementMath::GetStrafeLurchStrength(0.625, 0, 1, 0.25, 1), 0.5f, Tolerance));
+		CHECK(FMath::IsNearlyEqual(AdvancedMovementMath::GetStrafeLurchStrength(1, 0, 1, 0.25, 1), 0.f, Tolerance));
+	}
+
+	SECTION("The lurch strength multiplier is clamped to 1")
+	{
+		CHECK(FMath::IsNearlyEqual(AdvancedMovementMath::GetStrafeLurchStrength(0.625, 0, 1, 0.25, 2), 1.f, Tolerance));
+	}
+
+	SECTION("The lurch keeps the speed and turns it towards the input, with friction based on how much the velocity changed")
+	{
+		CHECK(AdvancedMovementMath::GetStrafeLurchVelocity(FVector(600, 0, 0), FVector(0, 1, 0), 1, 0.05).Equals(FVector(300, 300, 0), Tolerance));
+		CHECK(AdvancedMovementMath::GetStrafeLurchVelocity(FVector(600, 0, 0), FVector::ZeroVector, 1, 0.05).Equals(FVector(600, 0, 0), Tolerance));
+		CHECK(AdvancedMovementMath::BlendStrafeLurch(FVector(100, 0, 0), FVector(0, 100, 0), 0.25).Equals(FVector(75, 25, 0), Tolerance));
+	}
+
+	SECTION("The properties hold for the random samples")
+	{
+		CheckProperty("The strafe lurch strength is between 0 and 1 and never increases", [](const FSample& Sample)
+		{
+			const float LurchStrength = AdvancedMovementMath::GetStrafeLurchStrength(Sample.Time, 0, LurchDuration, LurchFullStrengthDuration, 1);
+			const float NextLurchStrength = AdvancedMovementMath::GetStrafeLurchStrength(Sample.Time + Sample.DeltaTime, 0, LurchDuration, LurchFullStrengthDuration, 1);
+			return LurchStrength >= 0 && LurchStrength <= 1 && NextLurchStrength <= LurchStrength;
+		});
+
+		CheckProperty("Strafe lurch has no influence once it's finished", [](const FSample& Sample)
+		{
+			const FVector LurchVelocity = AdvancedMovementMath::GetStrafeLurchVelocity(Sample.Velocity, Sample.AccelDir, LurchFriction, Sample.DeltaTime);
+			return AdvancedMovementMath::BlendStrafeLurch(Sample.Velocity, LurchVelocity, 0).Equals(Sample.Velocity);
+		});
+	}
+}
+
+
+TEST_CASE("AdvancedMovement::Math::StrafeBatch", "[AdvancedMovement][Math]")
+{
+	// The batch kernels use floats, and the scalar math uses doubles
+	constexpr float BatchTolerance = 0.001f;
+	const TArray<FSample> Samples = MakeSamples();
+
+	AdvancedMovementMath::FStrafeBatch Batch;
+	auto FillBatch = [&]()
+	{
+		Batch.SetNum(Samples.Num());
+		for (int32 Index = 0; Index < Samples.Num(); Index++)
+		{
+			const FSample& Sample = Samples[Index];
+			Batch.Set(Index, Sample.Velocity, Sample.AccelDir, Sample.Acceleration, Sample.DeltaTime,
+				AdvancedMovementMath::GetStrafeLurchStrength(Sample.Time, 0, LurchDuration, LurchFullStrengthDuration, 1));
+		}
+	};
+
+	// Returns the largest difference between the batch and the scalar velocities, relative to the scalar velocity's size
+	auto GetMaxDivergence = [&](TFunctionRef<FVector(const FSample&)> Scalar)
+	{
+		float MaxDivergence = 0;
+		for (int32 Index = 0; Index < Samples.Num(); Index++)
+		{
+			const FVector Expected = Scalar(Samples[Index]);
+			MaxDivergence = FMath::Max(MaxDivergence, static_cast<float>((Batch.GetVelocity(Index) - Expected).Size() / FMath::Max(1.0, Expected.Size())));
+		}
+		return MaxDivergence;
+	};
+
+	SECTION("The air strafe batch matches the scalar air strafe")
+	{
+		FillBatch();
+		AdvancedMovementMath::AirStrafeBatch(Batch, AirStrafe);
+		CHECK(GetMaxDivergence([](const FSample& Sample)
+		{
+			return Sample.Velocity + AdvancedMovementMath::GetAirStrafeVelocity(Sample.Velocity, Sample.AccelDir, Sample.Acceleration, AirStrafe, Sample.DeltaTime);
+		}) <= BatchTolerance);
+	}
+
+	SECTION("The strafe sway batch matches the scalar strafe sway")
+	{
+		FillBatch();
+		AdvancedMovementMath::StrafeSwayBatch(Batch, StrafeSway);
+		CHECK(GetMaxDivergence([](const FSample& Sample)
+		{
+			const FVector AddedVelocity = AdvancedMovementMath::GetAirStrafeVelocity(Sample.Velocity, Sample.AccelDir, Sample.Acceleration, StrafeSway, Sample.DeltaTime);
+			return AdvancedMovementMath::CanStrafeSway(Sample.Velocity, Sample.AccelDir) ? Sample.Velocity + AddedVelocity : Sample.Velocity;
+		}) <= BatchTolerance);
+	}
+
+	SECTION("The strafe lurch batch matches the scalar strafe lurch")
+	{
+		FillBatch();
+		AdvancedMovementMath::StrafeLurchBatch(Batch, AirStrafe, LurchFriction);
+		CHECK(GetMaxDivergence([](const FSample& Sample)
+		{
+			const FVector AirStrafeVelocity = Sample.Velocity + AdvancedMovementMath::GetAirStrafeVelocity(Sample.Velocity, Sample.AccelDir, Sample.Acceleration, AirStrafe, Sample.DeltaTime);
+			const FVector LurchVelocity = AdvancedMovementMath::GetStrafeLurchVelocity(Sample.Velocity, Sample.AccelDir, LurchFriction, Sample.DeltaTime);
+			const float LurchStrength = AdvancedMovementMath::GetStrafeLurchStrength(Sample.Time, 0, LurchDuration, LurchFullStrengthDuration, 1);
+			return AdvancedMovementMath::BlendStrafeLurch(AirStrafeVelocity, LurchVelocity, LurchStrength);
+		}) <= BatchTolerance);
+	}
+}
+
+
+TEST_CASE("AdvancedMovement::Math::WallJump", "[AdvancedMovement][Math]")
+{
+	// A wall facing -X that the character hit at 45 degrees is reflected
+	const FVector WallNormal(-1, 0, 0);
+	SECTION("The trajectory is reflected off of the wall, and falling wall jumps have half the vertical boost")
+	{
+		CHECK(AdvancedMovementMath::GetWallJumpDirection(FVector::ZeroVector, FVector(-100, -100, 0), WallNormal, WallNormal, FVector(100, 100, 0)).Equals(FVector(-0.7071, 0.7071, 1), Tolerance));
+		CHECK(AdvancedMovementMath::GetWallJumpDirection(FVector::ZeroVector, FVector(-100, -100, 0), WallNormal, WallNormal, FVector(100, 100, -50)).Equals(FVector(-0.7071, 0.7071, 0.5), Tolerance));
+	}
+
+	SECTION("Wall jumps while sliding alongside the wall push away from it")
+	{
+		CHECK(AdvancedMovementMath::GetWallJumpDirection(FVector::ZeroVector, FVector(-10, -100, 0), WallNormal, WallNormal, FVector(0, 100, 0)).Equals(FVector(-0.5, 0.5, 1), Tolerance));
+	}
+
+	SECTION("Wall run jumps are halfway between the wall's normal and the direction the character is facing along the wall")
+	{
+		CHECK(AdvancedMovementMath::GetWallRunJumpDirection(FVector(1, 0, 0), FVector(1, 0, 0), FVector(0, 1, 0)).Equals(FVector(0.5, 0.5, 1), Tolerance));
+		CHECK(AdvancedMovementMath::GetWallRunJumpDirection(FVector(-1, 0, 0), FVector(1, 0, 0), FVector(0, 1, 0)).Equals(FVector(-0.5, 0.5, 1), Tolerance));
+	}
+
+	SECTION("The character's speed (or the minimum wall jump speed) is redirected, and the boost is added on top")
+	{
+		FVector RedirectedVelocity;
+		const FVector WallJumpVelocity = AdvancedMovementMath::GetWallJumpVelocity(FVector(-0.7071, 0.7071, 1), FVector(300, 0, 0), 500, FVector2D(100, 400), RedirectedVelocity);
+		CHECK(RedirectedVelocity.Equals(FVector(-353.55, 353.55, 0), Tolerance));
+		CHECK(WallJumpVelocity.Equals(FVector(-424.26, 424.26, 400), Tolerance));
+	}
+
+	SECTION("The properties hold for the random samples")
+	{
+		CheckProperty("Wall jumps never send the character into the wall", [](const FSample& Sample)
+		{
+			const FVector WallJump = AdvancedMovementMath::GetWallJumpDirection(FVector::ZeroVector, Sample.WallTrajectory * -1, Sample.WallNormal, Sample.WallNormal, Sample.Velocity);
+			return FVector(WallJump.X, WallJump.Y, 0).Dot(Sample.WallNormal) >= -Tolerance;
+		});
+	}
+}
+
+
+TEST_CASE("AdvancedMovement::Math::Interp", "[AdvancedMovement][Math]")
+{
+	SECTION("An interp step moves towards the target, and stops at it")
+	{
+		CHECK(AdvancedMovementMath::GetInterpStep(FVector(100, 0, 0), FVector::ZeroVector, 200, 1, 0.1).Equals(FVector(20, 0, 0), Tolerance));
+		CHECK(AdvancedMovementMath::GetInterpStep(FVector(100, 0, 0), FVector::ZeroVector, 200, 1, 1).Equals(FVector(100, 0, 0), Tolerance));
+	}
+
+	SECTION("The remaining interp is the distance left over the total distance")
+	{
+		CHECK(FMath::IsNearlyEqual(AdvancedMovementMath::GetInterpRemaining(FVector::ZeroVector, FVector(100, 0, 0), FVector(25, 0, 0)), 0.75f, Tolerance));
+
+		AdvancedMovementMath::FInterpDistance InterpDistance;
+		CHECK(FMath::IsNearlyEqual(InterpDistance.Get(FVector::ZeroVector, FVector(100, 0, 0)), 0.01f, 0.0001f));
+		CHECK(FMath::IsNearlyEqual(AdvancedMovementMath::GetInterpRemaining(FVector(100, 0, 0), FVector(25, 0, 0), InterpDistance.InvDistance), 0.75f, Tolerance));
+	}
+
+	SECTION("A baked curve matches the curve between its samples, and is clamped outside of its range")
+	{
+		AdvancedMovementMath::FCurveTable CurveTable;
+		CurveTable.Bake([](const float Time) { return Time * 2; }, 0, 10);
+		CHECK(FMath::IsNearlyEqual(CurveTable.Evaluate(2.5), 5.f, Tolerance));
+		CHECK(FMath::IsNearlyEqual(CurveTable.Evaluate(-1), 0.f, Tolerance));
+		CHECK(FMath::IsNearlyEqual(CurveTable.Evaluate(11), 20.f, Tolerance));
+	}
+
+	SECTION("The properties hold for the random samples")
+	{
+		CheckProperty("Mantle and climb interps never overshoot the target", [](const FSample& Sample)
+		{
+			const FVector Step = AdvancedMovementMath::GetInterpStep(Sample.TargetLocation, Sample.Location, 200, 1, Sample.DeltaTime);
+			return Step.Size() <= (Sample.TargetLocation - Sample.Location).Size() + Tolerance;
+		});
+	}
+}